@@ -50,5 +50,29 @@ bool Dir_read(dir_t dir, char **filename, uint32_t *attributes)
     *attributes = d->finfo.fattrib;
   }
 
+  return true;
+}
+
+bool Dir_readInfo(dir_t dir, char **filename, uint32_t *attributes,
+                  uint64_t *size, uint32_t *modified)
+{
+  internal_dir_t *d = (internal_dir_t *)dir;
+
+  if (!Dir_read(dir, filename, attributes))
+  {
+    return false;
+  }
+
+  // FatFs already has this from the directory entry.
+  if (size)
+  {
+    *size = d->finfo.fsize;
+  }
+
+  if (modified)
+  {
+    *modified = ((uint32_t)d->finfo.fdate << 16) | d->finfo.ftime;
+  }
+
   return true;
 }
\ No newline at end of file
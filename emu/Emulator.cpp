@@ -4,6 +4,8 @@
 #include <emu/KeyValueStore.h>
 #include <od/glue/AppInterpreter.h>
 #include <od/extras/Random.h>
+#include <od/extras/Tracer.h>
+#include <od/extras/MemoryTracker.h>
 //#define BUILDOPT_VERBOSE
 //#define BUILDOPT_DEBUG_LEVEL 5
 #include <hal/log.h>
@@ -26,14 +28,21 @@
 #include <hal/pump.h>
 #include <od/config.h>
 #include <limits.h>
+#include <stdlib.h>
 #include <iostream>
 #include <fstream>
 
 using namespace od;
 
+extern "C" void Audio_enableFreeRun(void);
+
 namespace emu
 {
 
+  // Run the soak test for this many seconds and then quit (0 = disabled).
+  static int soakSeconds = 0;
+  static volatile bool interpreterFinished = false;
+
   Emulator::Emulator()
   {
   }
@@ -304,6 +313,11 @@ namespace emu
       }
       Events_push(EVENT_DISPLAY_READY);
 
+      if (interpreterFinished)
+      {
+        quit = true;
+      }
+
       double elapsed = ticks2secsD(wallclock() - start);
       double target = 1.0 / 70;
       double diff = MAX(0, elapsed - target);
@@ -661,8 +675,13 @@ namespace emu
     interp.execute("app.EMULATION = true");
     interp.execute("app.roots = {x='%s',rear='%s',front='%s'}",
                    globalConfig.xRoot, globalConfig.rearRoot, globalConfig.frontRoot);
+    if (soakSeconds > 0)
+    {
+      interp.execute("app.SOAK_SECONDS = %d", soakSeconds);
+    }
     interp.execute("dofile('%s/boot/logging.lua')", globalConfig.xRoot);
     interp.execute("dofile('%s/boot/start.lua')", globalConfig.xRoot);
+    interpreterFinished = true;
     return 0;
   }
 
@@ -680,6 +699,11 @@ namespace emu
       printf("  -h, --help         Show this help.\n");
       printf("  -c, --config FILE  Use the given configuration file.\n");
       printf("                     (Default: ~/.od/emu.config)\n");
+      printf("  -t, --trace FILE   Record a trace and save it to FILE on exit.\n");
+      printf("                     (Open with chrome://tracing or ui.perfetto.dev)\n");
+      printf("  -m, --memory FILE  Save memory usage by category to FILE on exit.\n");
+      printf("  --soak SECS        Run the audio engine soak test at maximum rate\n");
+      printf("                     for SECS seconds, then quit.\n");
       return 0;
     }
 
@@ -703,6 +727,32 @@ namespace emu
       configFilename = cmdLine.getOption("--config");
     }
 
+    std::string traceFilename;
+    if (cmdLine.optionExists("-t"))
+    {
+      traceFilename = cmdLine.getOption("-t");
+    }
+    if (cmdLine.optionExists("--trace"))
+    {
+      traceFilename = cmdLine.getOption("--trace");
+    }
+
+    std::string memoryFilename;
+    if (cmdLine.optionExists("-m"))
+    {
+      memoryFilename = cmdLine.getOption("-m");
+    }
+    if (cmdLine.optionExists("--memory"))
+    {
+      memoryFilename = cmdLine.getOption("--memory");
+    }
+
+    if (cmdLine.optionExists("--soak"))
+    {
+      soakSeconds = atoi(cmdLine.getOption("--soak").c_str());
+      Audio_enableFreeRun();
+    }
+
     if (!pathExists(configFilename.c_str()))
     {
       logWarn("%s does not exist, creating a default one.", configFilename.c_str());
@@ -737,6 +787,11 @@ namespace emu
     Display_init();
     od::Random::init();
 
+    if (!traceFilename.empty())
+    {
+      od::Tracer::start();
+    }
+
     memset(ping.main, 0, sizeof(ping.main));
     memset(pong.main, 0, sizeof(pong.main));
     memset(ping.sub, 0, sizeof(ping.sub));
@@ -783,6 +838,22 @@ namespace emu
     logInfo("Waiting for interpreter to finish...");
     SDL_WaitThread(interpreterThread, 0);
 
+    if (soakSeconds > 0)
+    {
+      Audio_stop();
+    }
+
+    if (!traceFilename.empty())
+    {
+      od::Tracer::save(traceFilename);
+    }
+
+    if (!memoryFilename.empty())
+    {
+      od::MemoryTracker::sample();
+      od::MemoryTracker::save(memoryFilename);
+    }
+
     saveState();
 
   error:
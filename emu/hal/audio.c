@@ -10,6 +10,12 @@ static struct AudioLocals
   int buffer[CACHE_ALIGNED_SIZE(MAX_AUDIO_BUFFER_BYTES) / sizeof(int)] __attribute__((aligned(CACHELINE_SIZE_MAX)));
   SDL_AudioSpec playSpec;
   SDL_AudioDeviceID playDev;
+
+  // Render as fast as possible into a scratch buffer instead of a device.
+  bool freeRun;
+  volatile bool freeRunning;
+  SDL_Thread *freeRunThread;
+  int scratch[2 * MAX_AUDIO_FRAME_LENGTH];
 } local;
 
 void playCallback(void *userdata,
@@ -30,10 +36,26 @@ void playCallback(void *userdata,
   }
 }
 
+static int freeRunThreadStart(void *ptr)
+{
+  while (local.freeRunning)
+  {
+    playCallback(0, (Uint8 *)local.scratch, sizeof(local.scratch));
+  }
+  return 0;
+}
+
+void Audio_enableFreeRun(void)
+{
+  local.freeRun = true;
+}
+
 void Audio_init()
 {
+  bool freeRun = local.freeRun;
   SDL_InitSubSystem(SDL_INIT_AUDIO);
   SDL_zero(local);
+  local.freeRun = freeRun;
 
   for (int i = 0; i < SDL_GetNumAudioDrivers(); ++i)
   {
@@ -69,6 +91,17 @@ void Audio_restart(void)
 
 void Audio_start(void)
 {
+  if (local.freeRun)
+  {
+    if (!local.freeRunning)
+    {
+      local.freeRunning = true;
+      local.freeRunThread = SDL_CreateThread(freeRunThreadStart, "audio", 0);
+      logInfo("Audio: free-running without a device.");
+    }
+    return;
+  }
+
   SDL_AudioSpec want;
   SDL_zero(want);
   want.freq = globalConfig.sampleRate;
@@ -91,6 +124,16 @@ void Audio_start(void)
 
 void Audio_stop(void)
 {
+  if (local.freeRun)
+  {
+    if (local.freeRunning)
+    {
+      local.freeRunning = false;
+      SDL_WaitThread(local.freeRunThread, 0);
+      local.freeRunThread = 0;
+    }
+    return;
+  }
   SDL_CloseAudioDevice(local.playDev);
 }
 
@@ -130,5 +173,9 @@ int Audio_getLoad()
 
 bool Audio_running()
 {
+  if (local.freeRun)
+  {
+    return local.freeRunning;
+  }
   return SDL_GetAudioDeviceStatus(local.playDev) == SDL_AUDIO_PLAYING;
 }
\ No newline at end of file
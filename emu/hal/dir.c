@@ -5,6 +5,8 @@
 #include <hal/fileops.h>
 #include <dirent.h>
 #include <string.h>
+#include <fcntl.h>
+#include <sys/stat.h>
 
 dir_t Dir_open(const char *path)
 {
@@ -59,4 +61,39 @@ bool Dir_read(dir_t dir, char **filename, uint32_t *attributes)
   }
 
   return entry != NULL;
+}
+
+bool Dir_readInfo(dir_t dir, char **filename, uint32_t *attributes,
+                  uint64_t *size, uint32_t *modified)
+{
+  DIR *d = (DIR *)dir;
+  char *name;
+
+  if (!Dir_read(dir, &name, attributes))
+  {
+    return false;
+  }
+
+  if (filename)
+  {
+    *filename = name;
+  }
+
+  struct stat info;
+  if (fstatat(dirfd(d), name, &info, 0) != 0)
+  {
+    memset(&info, 0, sizeof(info));
+  }
+
+  if (size)
+  {
+    *size = info.st_size;
+  }
+
+  if (modified)
+  {
+    *modified = (uint32_t)info.st_mtime;
+  }
+
+  return true;
 }
\ No newline at end of file
@@ -13,6 +13,10 @@ extern "C"
   dir_t Dir_open(const char *path);
   void Dir_close(dir_t dir);
   bool Dir_read(dir_t dir, char **filename, uint32_t *attributes);
+  // Like Dir_read but also returns the size and modification time of the
+  // entry.  The time is only good for comparing with a previous value.
+  bool Dir_readInfo(dir_t dir, char **filename, uint32_t *attributes,
+                    uint64_t *size, uint32_t *modified);
 
 #ifdef __cplusplus
 }
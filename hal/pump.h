@@ -1,5 +1,7 @@
 #pragma once
 
+#include <stdint.h>
+
 #ifdef __cplusplus
 extern "C"
 {
@@ -7,6 +9,8 @@ extern "C"
 
   void Pump_init();
   void Pump_resetThrottle();
+  // Number of frames skipped so far because the throttle was hit.
+  uint32_t Pump_getThrottledCount();
 
   // Called on each frame in the audio thread.
   extern void Pump_callback(float *inputs, float *outputs);
@@ -30,6 +30,7 @@ typedef struct _Local
 
   int renderCallCount;
   int renderCallThrottle;
+  volatile uint32_t throttledCount;
 } Local;
 
 static Local self;
@@ -196,6 +197,7 @@ void Audio_callback(int *samples)
   else
   {
     // Other tasks have been starved, so throttle signal processing.
+    self.throttledCount++;
   }
 
   // final hard-limiter, gain stage, and integer conversion
@@ -217,6 +219,11 @@ void Pump_resetThrottle()
   self.renderCallCount = 0;
 }
 
+uint32_t Pump_getThrottledCount()
+{
+  return self.throttledCount;
+}
+
 void Pump_init()
 {
   self.renderCallThrottle = globalConfig.frameRate * 0.1f;
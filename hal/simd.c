@@ -324,6 +324,185 @@ float32x4_t simd_invert(float32x4_t x)
   return inv;
 }
 
+#define c_exp2_hi 126.0f
+#define c_exp2_lo -126.0f
+#define c_LOG2E 1.44269504088896341f
+#define c_PI_2 1.57079632679489662f
+#define c_PI_4 0.78539816339744831f
+
+// x = n + f with n an integer and f in [-0.5,0.5)
+static inline float32x4_t split_exp2(float32x4_t x, int32x4_t *n)
+{
+  float32x4_t one = vdupq_n_f32(1.0f);
+  x = vminq_f32(x, vdupq_n_f32(c_exp2_hi));
+  x = vmaxq_f32(x, vdupq_n_f32(c_exp2_lo));
+
+  /* round to nearest by flooring x + 0.5 */
+  float32x4_t fx = vaddq_f32(x, vdupq_n_f32(0.5f));
+  float32x4_t tmp = vcvtq_f32_s32(vcvtq_s32_f32(fx));
+  uint32x4_t mask = vcgtq_f32(tmp, fx);
+  mask = vandq_u32(mask, vreinterpretq_u32_f32(one));
+  fx = vsubq_f32(tmp, vreinterpretq_f32_u32(mask));
+
+  *n = vcvtq_s32_f32(fx);
+  return vsubq_f32(x, fx);
+}
+
+static inline float32x4_t scale_exp2(float32x4_t y, int32x4_t n)
+{
+  /* build 2^n */
+  n = vaddq_s32(n, vdupq_n_s32(0x7f));
+  n = vshlq_n_s32(n, 23);
+  return vmulq_f32(y, vreinterpretq_f32_s32(n));
+}
+
+/* 2^x computed for 4 floats at once (cephes exp2f polynomial) */
+float32x4_t simd_exp2(float32x4_t x)
+{
+  int32x4_t n;
+  float32x4_t f = split_exp2(x, &n);
+
+  float32x4_t y = vdupq_n_f32(1.535336188319500E-4f);
+  y = vmlaq_f32(vdupq_n_f32(1.339887440266574E-3f), y, f);
+  y = vmlaq_f32(vdupq_n_f32(9.618437357674640E-3f), y, f);
+  y = vmlaq_f32(vdupq_n_f32(5.550332471162809E-2f), y, f);
+  y = vmlaq_f32(vdupq_n_f32(2.402264791363012E-1f), y, f);
+  y = vmlaq_f32(vdupq_n_f32(6.931472028550421E-1f), y, f);
+  y = vmlaq_f32(vdupq_n_f32(1.0f), y, f);
+
+  return scale_exp2(y, n);
+}
+
+/* 2^x with a cubic (minimax) polynomial */
+float32x4_t simd_exp2_fast(float32x4_t x)
+{
+  int32x4_t n;
+  float32x4_t f = split_exp2(x, &n);
+
+  float32x4_t y = vdupq_n_f32(5.517166493016927E-2f);
+  y = vmlaq_f32(vdupq_n_f32(2.426111218771569E-1f), y, f);
+  y = vmlaq_f32(vdupq_n_f32(6.932609862225647E-1f), y, f);
+  y = vmlaq_f32(vdupq_n_f32(9.999280735783088E-1f), y, f);
+
+  return scale_exp2(y, n);
+}
+
+float32x4_t simd_log2(float32x4_t x)
+{
+  return vmulq_n_f32(simd_log(x), c_LOG2E);
+}
+
+/* log2(x) for x > 0 with a quartic (minimax) polynomial */
+float32x4_t simd_log2_fast(float32x4_t x)
+{
+  x = vmaxq_f32(x, vdupq_n_f32(1.17549435e-38f)); /* cut off denormalized stuff */
+  int32x4_t bits = vreinterpretq_s32_f32(x);
+
+  /* x = m * 2^e with m in [1,2) */
+  int32x4_t e = vsubq_s32(vshrq_n_s32(bits, 23), vdupq_n_s32(0x7f));
+  bits = vandq_s32(bits, vdupq_n_s32(c_inv_mant_mask));
+  bits = vorrq_s32(bits, vreinterpretq_s32_f32(vdupq_n_f32(1.0f)));
+  float32x4_t m = vreinterpretq_f32_s32(bits);
+
+  /* move m into [sqrt(1/2), sqrt(2)) */
+  uint32x4_t big = vcgtq_f32(m, vdupq_n_f32(1.41421356f));
+  m = vbslq_f32(big, vmulq_n_f32(m, 0.5f), m);
+  e = vsubq_s32(e, vreinterpretq_s32_u32(big)); /* mask is -1 when true */
+
+  float32x4_t z = vsubq_f32(m, vdupq_n_f32(1.0f));
+  float32x4_t y = vdupq_n_f32(-3.296296033481442E-1f);
+  y = vmlaq_f32(vdupq_n_f32(5.175093774126263E-1f), y, z);
+  y = vmlaq_f32(vdupq_n_f32(-7.249041735028753E-1f), y, z);
+  y = vmlaq_f32(vdupq_n_f32(1.441760648353846f), y, z);
+
+  return vmlaq_f32(vcvtq_f32_s32(e), y, z);
+}
+
+/* tanh(x) = (e^2x - 1) / (e^2x + 1) */
+float32x4_t simd_tanh(float32x4_t x)
+{
+  float32x4_t one = vdupq_n_f32(1.0f);
+  x = vminq_f32(x, vdupq_n_f32(9.0f));
+  x = vmaxq_f32(x, vdupq_n_f32(-9.0f));
+  float32x4_t e = simd_exp2(vmulq_n_f32(x, 2.0f * c_LOG2E));
+  return vmulq_f32(vsubq_f32(e, one), simd_invert(vaddq_f32(e, one)));
+}
+
+/* tanh from the 3rd order Pade approximant (|error| < 2.4e-2, worst near
+   |x| = 1.6) */
+float32x4_t simd_tanh_fast(float32x4_t x)
+{
+  x = vminq_f32(x, vdupq_n_f32(3.0f));
+  x = vmaxq_f32(x, vdupq_n_f32(-3.0f));
+  float32x4_t x2 = vmulq_f32(x, x);
+  float32x4_t a = vmulq_f32(x, vaddq_f32(x2, vdupq_n_f32(27.0f)));
+  float32x4_t b = vmlaq_n_f32(vdupq_n_f32(27.0f), x2, 9.0f);
+
+  // 2 iterations are enough here
+  float32x4_t inv = vrecpeq_f32(b);
+  inv = vmulq_f32(inv, vrecpsq_f32(b, inv));
+  inv = vmulq_f32(inv, vrecpsq_f32(b, inv));
+  return vmulq_f32(a, inv);
+}
+
+/* Reduce atan(x) to atan(t) with t in [0,1]. */
+static inline float32x4_t reduce_atan(float32x4_t x, uint32x4_t *big)
+{
+  float32x4_t one = vdupq_n_f32(1.0f);
+  float32x4_t ax = vabsq_f32(x);
+  *big = vcgtq_f32(ax, one);
+  /* t = min(|x|, 1/|x|) */
+  return vminq_f32(ax, simd_invert(vmaxq_f32(ax, one)));
+}
+
+static inline float32x4_t expand_atan(float32x4_t x, float32x4_t y,
+                                      uint32x4_t big)
+{
+  y = vbslq_f32(big, vsubq_f32(vdupq_n_f32(c_PI_2), y), y);
+  uint32x4_t negative = vcltq_f32(x, vdupq_n_f32(0.0f));
+  return vbslq_f32(negative, vnegq_f32(y), y);
+}
+
+/* atan (Abramowitz and Stegun 4.4.47, |error| < 1e-5) */
+float32x4_t simd_atan(float32x4_t x)
+{
+  uint32x4_t big;
+  float32x4_t t = reduce_atan(x, &big);
+  float32x4_t t2 = vmulq_f32(t, t);
+
+  float32x4_t y = vdupq_n_f32(0.0208351f);
+  y = vmlaq_f32(vdupq_n_f32(-0.0851330f), y, t2);
+  y = vmlaq_f32(vdupq_n_f32(0.1801410f), y, t2);
+  y = vmlaq_f32(vdupq_n_f32(-0.3302995f), y, t2);
+  y = vmlaq_f32(vdupq_n_f32(0.9998660f), y, t2);
+  y = vmulq_f32(y, t);
+
+  return expand_atan(x, y, big);
+}
+
+/* atan (|error| < 1.5e-3) */
+float32x4_t simd_atan_fast(float32x4_t x)
+{
+  uint32x4_t big;
+  float32x4_t t = reduce_atan(x, &big);
+
+  // pi/4 t - t (t - 1) (0.2447 + 0.0663 t)
+  float32x4_t a = vmlaq_n_f32(vdupq_n_f32(0.2447f), t, 0.0663f);
+  float32x4_t b = vmulq_f32(t, vsubq_f32(t, vdupq_n_f32(1.0f)));
+  float32x4_t y = vmlsq_f32(vmulq_n_f32(t, c_PI_4), a, b);
+
+  return expand_atan(x, y, big);
+}
+
+float32x4_t simd_softclip(float32x4_t x)
+{
+  x = vminq_f32(x, vdupq_n_f32(1.5f));
+  x = vmaxq_f32(x, vdupq_n_f32(-1.5f));
+  // x - 4/27 x^3
+  float32x4_t x3 = vmulq_f32(x, vmulq_f32(x, x));
+  return vmlsq_f32(x, vdupq_n_f32(4.0f / 27.0f), x3);
+}
+
 void simd_linear_interpolate(float *__restrict__ out,
                              const float *__restrict__ recent0,
                              const float *__restrict__ recent1,
@@ -467,34 +646,82 @@ bool simd_any_positive(float *in, int n)
   return vgetq_lane_u32(any, 0) || vgetq_lane_u32(any, 1) || vgetq_lane_u32(any, 2) || vgetq_lane_u32(any, 3);
 }
 
-int simd_first_positive(float *in, int n)
+static inline int first_lane(uint32x4_t mask)
 {
-  float32x4_t zero = vdupq_n_f32(0.0f);
-
-  for (int i = 0; i < n; i += 4)
+  if (vgetq_lane_u32(mask, 0))
   {
-    uint32x4_t any = vcgtq_f32(vld1q_f32(in + i), zero);
-    if (vgetq_lane_u32(any, 0))
-    {
-      return i;
-    }
-    else if (vgetq_lane_u32(any, 1))
-    {
-      return i + 1;
-    }
-    else if (vgetq_lane_u32(any, 1))
-    {
-      return i + 2;
-    }
-    else if (vgetq_lane_u32(any, 1))
-    {
-      return i + 3;
-    }
+    return 0;
+  }
+  else if (vgetq_lane_u32(mask, 1))
+  {
+    return 1;
+  }
+  else if (vgetq_lane_u32(mask, 2))
+  {
+    return 2;
+  }
+  else if (vgetq_lane_u32(mask, 3))
+  {
+    return 3;
   }
+  return 4;
+}
+
+static inline bool any_lane(uint32x4_t mask)
+{
+  uint32x2_t x = vorr_u32(vget_low_u32(mask), vget_high_u32(mask));
+  return vget_lane_u32(vpmax_u32(x, x), 0) != 0;
+}
+
+int simd_first_positive(float *in, int n)
+{
+  return simd_first_greater(in, n, 0.0f);
+}
 
+// Four samples are tested at a time and only the block that contains the
+// edge is searched lane by lane.
+#define FIRST_MATCH(vcmp, op)                                \
+  float32x4_t t = vdupq_n_f32(threshold);                    \
+  int i = 0;                                                 \
+  for (; i + 4 <= n; i += 4)                                 \
+  {                                                          \
+    uint32x4_t mask = vcmp(vld1q_f32(in + i), t);            \
+    if (any_lane(mask))                                      \
+    {                                                        \
+      return i + first_lane(mask);                           \
+    }                                                        \
+  }                                                          \
+  for (; i < n; i++)                                         \
+  {                                                          \
+    if (in[i] op threshold)                                  \
+    {                                                        \
+      return i;                                              \
+    }                                                        \
+  }                                                          \
   return n;
+
+int simd_first_greater(float *in, int n, float threshold)
+{
+  FIRST_MATCH(vcgtq_f32, >)
 }
 
+int simd_first_greater_or_equal(float *in, int n, float threshold)
+{
+  FIRST_MATCH(vcgeq_f32, >=)
+}
+
+int simd_first_less(float *in, int n, float threshold)
+{
+  FIRST_MATCH(vcltq_f32, <)
+}
+
+int simd_first_less_or_equal(float *in, int n, float threshold)
+{
+  FIRST_MATCH(vcleq_f32, <=)
+}
+
+#undef FIRST_MATCH
+
 int simd_first_positive_4x(float *in, int n)
 {
   float32x4_t zero = vdupq_n_f32(0.0f);
@@ -520,3 +747,13 @@ void simd_set(float *out, int n, float value)
   }
 }
 
+
+void simd_transpose4x4(float32x4_t *rows)
+{
+  float32x4x2_t t01 = vtrnq_f32(rows[0], rows[1]);
+  float32x4x2_t t23 = vtrnq_f32(rows[2], rows[3]);
+  rows[0] = vcombine_f32(vget_low_f32(t01.val[0]), vget_low_f32(t23.val[0]));
+  rows[1] = vcombine_f32(vget_low_f32(t01.val[1]), vget_low_f32(t23.val[1]));
+  rows[2] = vcombine_f32(vget_high_f32(t01.val[0]), vget_high_f32(t23.val[0]));
+  rows[3] = vcombine_f32(vget_high_f32(t01.val[1]), vget_high_f32(t23.val[1]));
+}
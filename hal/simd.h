@@ -8,7 +8,7 @@ extern "C"
 #include <hal/neon.h>
 #include <stdbool.h>
 
-  // Transcendentals
+  // Transcendentals (precise, cephes-based)
   float32x4_t simd_log(float32x4_t x);
   float32x4_t simd_exp(float32x4_t x);
   float32x4_t simd_pow(float32x4_t x, float32x4_t m);
@@ -17,6 +17,24 @@ extern "C"
   float32x4_t simd_cos(float32x4_t x);
   float32x4_t simd_invert(float32x4_t x);
 
+  // Transcendentals (default, ~1e-7 error except atan which is ~1e-5)
+  // Use simd_exp2(v * FULLSCALE_IN_VOLTS) for V/Oct to frequency ratio.
+  float32x4_t simd_exp2(float32x4_t x);
+  float32x4_t simd_log2(float32x4_t x);
+  float32x4_t simd_tanh(float32x4_t x);
+  float32x4_t simd_atan(float32x4_t x);
+
+  // Transcendentals (fast, ~1e-4 error except atan, ~1.5e-3, and tanh, up to
+  // 2.4e-2 around |x| = 1.6)
+  // Good enough for modulation paths such as filter cutoffs.
+  float32x4_t simd_exp2_fast(float32x4_t x);
+  float32x4_t simd_log2_fast(float32x4_t x);
+  float32x4_t simd_tanh_fast(float32x4_t x);
+  float32x4_t simd_atan_fast(float32x4_t x);
+
+  // Smooth saturation into [-1,1], reaching the limits at |x| = 1.5
+  float32x4_t simd_softclip(float32x4_t x);
+
   // Interpolation
   void simd_linear_interpolate(float *__restrict__ out,
                                const float *__restrict__ recent0,
@@ -47,10 +65,19 @@ extern "C"
   bool simd_any_positive(float *in, int n);
   int simd_first_positive(float *in, int n);
   int simd_first_positive_4x(float *in, int n);
+  // Edge search: offset of the first sample that compares true against the
+  // threshold, or n when there is none.  Any n (and any alignment of in).
+  int simd_first_greater(float *in, int n, float threshold);
+  int simd_first_greater_or_equal(float *in, int n, float threshold);
+  int simd_first_less(float *in, int n, float threshold);
+  int simd_first_less_or_equal(float *in, int n, float threshold);
 
   // Constant set
   void simd_set(float *out, int n, float value);
 
+  // In-place 4x4 transpose (rows become columns)
+  void simd_transpose4x4(float32x4_t *rows);
+
 #ifdef __cplusplus
 }
 #endif
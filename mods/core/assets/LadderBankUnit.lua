@@ -0,0 +1,141 @@
+local app = app
+local libcore = require "core.libcore"
+local Class = require "Base.Class"
+local Unit = require "Unit"
+local GainBias = require "Unit.ViewControl.GainBias"
+local Pitch = require "Unit.ViewControl.Pitch"
+local Encoder = require "Encoder"
+
+-- Four ladder lowpass filters in parallel per channel, with their cutoffs
+-- spread evenly around the fundamental.  All voices of both channels run in
+-- one LadderFilterBank.
+local voicesPerChannel = 4
+
+local LadderBankUnit = Class {}
+LadderBankUnit:include(Unit)
+
+function LadderBankUnit:init(args)
+  args.title = "Ladder Bank"
+  args.mnemonic = "LB"
+  Unit.init(self, args)
+end
+
+function LadderBankUnit:onLoadGraph(channelCount)
+  local voiceCount = voicesPerChannel * channelCount
+  local bank = self:addObject("bank", libcore.LadderFilterBank(voiceCount))
+
+  local tune = self:addObject("tune", app.ConstantOffset())
+  local tuneRange = self:addObject("tuneRange", app.MinMax())
+
+  local f0 = self:addObject("f0", app.GainBias())
+  local f0Range = self:addObject("f0Range", app.MinMax())
+
+  local res = self:addObject("res", app.GainBias())
+  local resRange = self:addObject("resRange", app.MinMax())
+
+  local clipper = self:addObject("clipper", libcore.Clipper())
+  clipper:setMaximum(0.999)
+  clipper:setMinimum(0)
+
+  local spread = self:addObject("spread", app.GainBias())
+  local spreadRange = self:addObject("spreadRange", app.MinMax())
+
+  connect(tune, "Out", tuneRange, "In")
+  connect(f0, "Out", bank, "Fundamental")
+  connect(f0, "Out", f0Range, "In")
+  connect(res, "Out", clipper, "In")
+  connect(clipper, "Out", resRange, "In")
+  connect(spread, "Out", spreadRange, "In")
+
+  -- Spread is in octaves between neighbouring voices (0.1 V/oct per octave).
+  local pitches = {}
+  for v = 1, voicesPerChannel do
+    local offset = self:addObject("offset" .. v, app.ConstantGain())
+    offset:hardSet("Gain", 0.1 * (v - 0.5 * (voicesPerChannel + 1)))
+    local pitch = self:addObject("pitch" .. v, app.Sum())
+    connect(spread, "Out", offset, "In")
+    connect(offset, "Out", pitch, "Left")
+    connect(tune, "Out", pitch, "Right")
+    pitches[v] = pitch
+  end
+
+  for ch = 1, channelCount do
+    local mix = self:addObject("mix" .. ch, app.Mixer(voicesPerChannel))
+    for v = 1, voicesPerChannel do
+      local voice = (ch - 1) * voicesPerChannel + v
+      connect(self, "In" .. ch, bank, "In" .. voice)
+      connect(pitches[v], "Out", bank, "V/Oct" .. voice)
+      connect(clipper, "Out", bank, "Resonance" .. voice)
+      connect(bank, "Out" .. voice, mix, "In" .. v)
+      mix:hardSet("Gain" .. v, 1.0 / voicesPerChannel)
+    end
+    connect(mix, "Out", self, "Out" .. ch)
+  end
+
+  self:addMonoBranch("tune", tune, "In", tune, "Out")
+  self:addMonoBranch("Q", res, "In", res, "Out")
+  self:addMonoBranch("f0", f0, "In", f0, "Out")
+  self:addMonoBranch("spread", spread, "In", spread, "Out")
+end
+
+local views = {
+  expanded = {
+    "tune",
+    "freq",
+    "resonance",
+    "spread"
+  },
+  collapsed = {}
+}
+
+function LadderBankUnit:onLoadViews(objects, branches)
+  local controls = {}
+
+  controls.tune = Pitch {
+    button = "V/oct",
+    branch = branches.tune,
+    description = "V/oct",
+    offset = objects.tune,
+    range = objects.tuneRange
+  }
+
+  controls.freq = GainBias {
+    button = "f0",
+    branch = branches.f0,
+    description = "Fundamental",
+    gainbias = objects.f0,
+    range = objects.f0Range,
+    biasMap = Encoder.getMap("filterFreq"),
+    biasUnits = app.unitHertz,
+    initialBias = 440,
+    gainMap = Encoder.getMap("freqGain"),
+    scaling = app.octaveScaling
+  }
+
+  controls.resonance = GainBias {
+    button = "Q",
+    branch = branches.Q,
+    description = "Resonance",
+    gainbias = objects.res,
+    range = objects.resRange,
+    biasMap = Encoder.getMap("unit"),
+    biasUnits = app.unitNone,
+    initialBias = 0.25,
+    gainMap = Encoder.getMap("[-10,10]")
+  }
+
+  controls.spread = GainBias {
+    button = "spread",
+    branch = branches.spread,
+    description = "Spread (oct)",
+    gainbias = objects.spread,
+    range = objects.spreadRange,
+    biasMap = Encoder.getMap("unit"),
+    biasUnits = app.unitNone,
+    initialBias = 0.5
+  }
+
+  return controls, views
+end
+
+return LadderBankUnit
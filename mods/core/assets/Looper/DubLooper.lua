@@ -33,6 +33,9 @@ function DubLooper:onLoadGraph(channelCount)
   local engage = self:addObject("engage", app.Comparator())
   engage:setToggleMode()
 
+  local undo = self:addObject("undo", app.Comparator())
+  local redo = self:addObject("redo", app.Comparator())
+
   local dub = self:addObject("dub", app.GainBias())
   local dubRange = self:addObject("dubRange", app.MinMax())
   local dubClipper = self:addObject("dubClipper", libcore.Clipper())
@@ -45,6 +48,8 @@ function DubLooper:onLoadGraph(channelCount)
   connect(reset, "Out", head, "Reset")
   connect(punch, "Out", head, "Punch")
   connect(engage, "Out", head, "Engage")
+  connect(undo, "Out", head, "Undo")
+  connect(redo, "Out", head, "Redo")
 
   connect(dub, "Out", dubClipper, "In")
   connect(dubClipper, "Out", head, "Dub")
@@ -77,6 +82,8 @@ function DubLooper:onLoadGraph(channelCount)
   self:addMonoBranch("reset", reset, "In", reset, "Out")
   self:addMonoBranch("engage", engage, "In", engage, "Out")
   self:addMonoBranch("punch", punch, "In", punch, "Out")
+  self:addMonoBranch("undo", undo, "In", undo, "Out")
+  self:addMonoBranch("redo", redo, "In", redo, "Out")
   self:addMonoBranch("dub", dub, "In", dub, "Out")
   self:addMonoBranch("wet", wet, "In", wet, "Out")
   self:addMonoBranch("start", start, "In", start, "Out")
@@ -158,7 +165,11 @@ local menu = {
   "zeroBuffer",
   "controlHeader",
   "engageLatch",
-  "punchLatch"
+  "punchLatch",
+  "undoHeader",
+  "undoOff",
+  "undo10s",
+  "undo30s"
 }
 
 function DubLooper:onShowMenu(objects, branches)
@@ -218,6 +229,34 @@ function DubLooper:onShowMenu(objects, branches)
     }
   }
 
+  local undoTime = objects.head:getUndoTime()
+  controls.undoHeader = MenuHeader {
+    description = undoTime > 0 and
+        string.format("Undo Memory (now %ds):", undoTime) or
+        "Undo Memory (now off):"
+  }
+
+  controls.undoOff = Task {
+    description = "off",
+    task = function()
+      objects.head:setUndoTime(0)
+    end
+  }
+
+  controls.undo10s = Task {
+    description = "10s",
+    task = function()
+      objects.head:setUndoTime(10)
+    end
+  }
+
+  controls.undo30s = Task {
+    description = "30s",
+    task = function()
+      objects.head:setUndoTime(30)
+    end
+  }
+
   local sub = {}
   if self.sample then
     sub[1] = {
@@ -258,6 +297,8 @@ local views = {
     "reset",
     "engage",
     "punch",
+    "undo",
+    "redo",
     "start",
     "dub",
     "wet",
@@ -276,6 +317,14 @@ local views = {
     "wave",
     "punch"
   },
+  undo = {
+    "wave",
+    "undo"
+  },
+  redo = {
+    "wave",
+    "redo"
+  },
   start = {
     "wave",
     "start"
@@ -311,6 +360,20 @@ function DubLooper:onLoadViews(objects, branches)
     comparator = objects.punch
   }
 
+  controls.undo = Gate {
+    button = "undo",
+    description = "Undo Last Punch",
+    branch = branches.undo,
+    comparator = objects.undo
+  }
+
+  controls.redo = Gate {
+    button = "redo",
+    description = "Redo Punch",
+    branch = branches.redo,
+    comparator = objects.redo
+  }
+
   controls.reset = Gate {
     button = "reset",
     description = "Reset",
@@ -369,11 +432,15 @@ function DubLooper:serialize()
   if self.sample then
     t.sample = SamplePool.serializeSample(self.sample)
   end
+  t.undoTime = self.objects.head:getUndoTime()
   return t
 end
 
 function DubLooper:deserialize(t)
   Unit.deserialize(self, t)
+  if t.undoTime then
+    self.objects.head:setUndoTime(t.undoTime)
+  end
   if t.sample then
     local sample = SamplePool.deserializeSample(t.sample, self.chain)
     if sample then
@@ -14,6 +14,7 @@ local TimeChooser = require "core.Looper.TimeChooser"
 local Encoder = require "Encoder"
 local Utils = require "Utils"
 local Overlay = require "Overlay"
+local Timer = require "Timer"
 
 local PedalLooper = Class {}
 PedalLooper:include(Unit)
@@ -21,15 +22,18 @@ PedalLooper:include(Unit)
 function PedalLooper:init(args)
   args.title = "Pedal Looper"
   args.mnemonic = "PL"
+  -- Undo memory as a fraction of the maximum loop time.
+  self.undoFraction = 0.5
   Unit.init(self, args)
 end
 
 function PedalLooper:onLoadGraph(channelCount)
   local looper = self:addObject("looper", libcore.PedalLooper(channelCount))
-  looper:allocateTimeUpTo(30)
+  looper:allocateTimeUpTo(30, self.undoFraction)
   local record = self:addObject("record", app.Comparator())
   local stop = self:addObject("stop", app.Comparator())
   local undo = self:addObject("undo", app.Comparator())
+  local redo = self:addObject("redo", app.Comparator())
   local feedback = self:addObject("feedback", app.ParameterAdapter())
 
   connect(self, "In1", looper, "Left In")
@@ -42,32 +46,81 @@ function PedalLooper:onLoadGraph(channelCount)
   connect(record, "Out", looper, "Record")
   connect(stop, "Out", looper, "Stop")
   connect(undo, "Out", looper, "Undo")
+  connect(redo, "Out", looper, "Redo")
   tie(looper, "Feedback", feedback, "Out")
 
   self:addMonoBranch("record", record, "In", record, "Out")
   self:addMonoBranch("stop", stop, "In", stop, "Out")
   self:addMonoBranch("undo", undo, "In", undo, "Out")
+  self:addMonoBranch("redo", redo, "In", redo, "Out")
   self:addMonoBranch("feedback", feedback, "In", feedback, "Out")
 end
 
 function PedalLooper:setMaxLoopTime(secs)
-  self.objects.looper:allocateTimeUpTo(secs)
+  self.objects.looper:allocateTimeUpTo(secs, self.undoFraction)
 end
 
-function PedalLooper:copyToNewBuffer()
-  local sample, msg = SamplePool.create {
+-- Clears the loop, like changing the maximum loop time.
+function PedalLooper:setUndoFraction(fraction)
+  self.undoFraction = fraction
+  self:setMaxLoopTime(self.objects.looper:maximumLoopTime())
+end
+
+-- The copy runs in the background while the loop keeps playing.  Calls
+-- after(sample) when it succeeds and failed(sample) when it does not.
+-- Returns false (without calling either) when another copy is still running.
+function PedalLooper:capture(sample, after, failed)
+  local looper = self.objects.looper
+  local n = looper:captureToSample(sample.pSample)
+  if n < 0 then
+    Overlay.flashMainMessage("Still copying, try again.")
+    return false
+  elseif n == 0 then
+    Overlay.flashMainMessage("Failed to copy audio.")
+    if failed then
+      failed(sample)
+    end
+    return true
+  end
+  self.lastCopyPath = sample.path
+  Timer.every(0.1, function()
+    if looper:isCapturing() then
+      return true
+    end
+    if looper:captureSucceeded() then
+      Overlay.flashMainMessage("Copied to: %s", sample.name)
+      if after then
+        after(sample)
+      end
+    else
+      Overlay.flashMainMessage("Failed to copy audio.")
+      if failed then
+        failed(sample)
+      end
+    end
+    return false
+  end)
+  return true
+end
+
+-- Buffers created for a copy are thrown away again if it does not happen.
+local function unloadCreated(sample)
+  SamplePool.unload(sample)
+end
+
+function PedalLooper:createLoopBuffer()
+  return SamplePool.create {
     root = "loop",
     samples = self.objects.looper:getLoopLengthInSamples(),
     channels = self.channelCount
   }
+end
 
+function PedalLooper:copyToNewBuffer()
+  local sample, msg = self:createLoopBuffer()
   if sample then
-    if self.objects.looper:fillSample(sample.pSample) > 0 then
-      Overlay.flashMainMessage("Copied to: %s", sample.name)
-      self.lastCopyPath = sample.path
-    else
-      SamplePool.unload(sample)
-      Overlay.flashMainMessage("Failed to copy audio.")
+    if not self:capture(sample, nil, unloadCreated) then
+      unloadCreated(sample)
     end
   else
     Overlay.flashMainMessage("Copy failed: %s", msg)
@@ -80,43 +133,51 @@ function PedalLooper:copyToExistingBuffer()
   chooser:highlight(self.sample)
   local task = function(sample)
     if sample then
-      if self.objects.looper:fillSample(sample.pSample) > 0 then
-        Overlay.flashMainMessage("Copied to: %s", sample.name)
-        self.lastCopyPath = sample.path
-      else
-        SamplePool.unload(sample)
-        Overlay.flashMainMessage("Failed to copy audio.")
-      end
+      self:copyTo(sample)
     end
   end
   chooser:subscribe("done", task)
   chooser:show()
 end
 
+-- Never unloads the sample, which the user picked.
 function PedalLooper:copyTo(sample)
   if sample then
-    if self.objects.looper:fillSample(sample.pSample) > 0 then
-      Overlay.flashMainMessage("Copied to: %s", sample.name)
-      self.lastCopyPath = sample.path
-    else
-      SamplePool.unload(sample)
-      Overlay.flashMainMessage("Failed to copy audio.")
-    end
+    self:capture(sample)
   else
     Overlay.flashMainMessage("Buffer not found.")
   end
 end
 
+function PedalLooper:saveToCard()
+  local sample, msg = self:createLoopBuffer()
+  if sample then
+    local save = function()
+      SamplePool.save(sample)
+    end
+    if not self:capture(sample, save, unloadCreated) then
+      unloadCreated(sample)
+    end
+  else
+    Overlay.flashMainMessage("Save failed: %s", msg)
+  end
+end
+
 local menu = {
   "copyHeader",
   "copyToExisting",
   "copyToNew",
   "copyToLast",
+  "saveToCard",
   "setHeader",
   "set10s",
   "set30s",
   "set60s",
   "setCustom",
+  "undoHeader",
+  "undoNone",
+  "undoHalf",
+  "undoFull",
   "behaviorHeader",
   "afterRec",
   "passInput"
@@ -158,6 +219,13 @@ function PedalLooper:onShowMenu(objects, branches)
       end
     }
 
+    controls.saveToCard = Task {
+      description = "Card (WAV)",
+      task = function()
+        self:saveToCard()
+      end
+    }
+
   end
 
   controls.setHeader = MenuHeader {
@@ -199,6 +267,31 @@ function PedalLooper:onShowMenu(objects, branches)
     end
   }
 
+  controls.undoHeader = MenuHeader {
+    description = "Set Undo Memory:"
+  }
+
+  controls.undoNone = Task {
+    description = "none",
+    task = function()
+      self:setUndoFraction(0)
+    end
+  }
+
+  controls.undoHalf = Task {
+    description = "1/2 loop",
+    task = function()
+      self:setUndoFraction(0.5)
+    end
+  }
+
+  controls.undoFull = Task {
+    description = "1 loop",
+    task = function()
+      self:setUndoFraction(1)
+    end
+  }
+
   controls.behaviorHeader = MenuHeader {
     description = "Behavior"
   }
@@ -255,6 +348,7 @@ local views = {
     "record",
     "stop",
     "undo",
+    "redo",
     "feedback"
   },
   collapsed = {}
@@ -281,13 +375,22 @@ function PedalLooper:onLoadViews(objects, branches)
 
   controls.undo = StateMachineView {
     button = "undo",
-    description = "Undo/Redo",
+    description = "Undo Take",
     branch = branches.undo,
     comparator = objects.undo,
     stateMachine = objects.looper:getStateMachine("Undo"),
     showStateValue = true
   }
 
+  controls.redo = StateMachineView {
+    button = "redo",
+    description = "Redo Take",
+    branch = branches.redo,
+    comparator = objects.redo,
+    stateMachine = objects.looper:getStateMachine("Redo"),
+    showStateValue = true
+  }
+
   controls.feedback = GainBias {
     button = "fdbk",
     description = "Feedback",
@@ -306,11 +409,15 @@ end
 function PedalLooper:serialize()
   local t = Unit.serialize(self)
   t.maximumLoopTime = self.objects.looper:maximumLoopTime()
+  t.undoFraction = self.undoFraction
   return t
 end
 
 function PedalLooper:deserialize(t)
   Unit.deserialize(self, t)
+  if t.undoFraction then
+    self.undoFraction = t.undoFraction
+  end
   local time = t.maximumLoopTime
   if time and time > 0 then
     self:setMaxLoopTime(time)
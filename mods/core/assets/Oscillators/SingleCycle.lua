@@ -29,8 +29,13 @@ function SingleCycle:onLoadGraph(channelCount)
   end
 end
 
+-- Overridden by units that play the sample with another oscillator.
+function SingleCycle:createOscillator()
+  return libcore.SingleCycle()
+end
+
 function SingleCycle:loadMonoGraph()
-  local osc = self:addObject("osc", libcore.SingleCycle())
+  local osc = self:addObject("osc", self:createOscillator())
   local tune = self:addObject("tune", app.ConstantOffset())
   local tuneRange = self:addObject("tuneRange", app.MinMax())
   local f0 = self:addObject("f0", app.GainBias())
@@ -0,0 +1,35 @@
+local libcore = require "core.libcore"
+local Class = require "Base.Class"
+local Unit = require "Unit"
+local SingleCycle = require "core.Oscillators.SingleCycle"
+
+-- Single Cycle with band-limited playback: each slice of the sample is
+-- rendered into mipmapped tables so that high notes do not alias.
+local Wavetable = Class {}
+Wavetable:include(SingleCycle)
+
+function Wavetable:init(args)
+  args.title = "Wavetable"
+  args.mnemonic = "WT"
+  Unit.init(self, args)
+end
+
+function Wavetable:createOscillator()
+  return libcore.WavetableOscillator()
+end
+
+-- The tables are built from the slices, so rebuild them after editing.
+function Wavetable:showSampleEditor()
+  local created = self.sample and self.slicingView == nil
+  SingleCycle.showSampleEditor(self)
+  if created then
+    self.slicingView:subscribe("done", function()
+      if self.sample then
+        self.objects.osc:setSample(self.sample.pSample,
+                                   self.sample.slices.pSlices)
+      end
+    end)
+  end
+end
+
+return Wavetable
@@ -99,7 +99,8 @@ function ClockBase:setRational()
 end
 
 local menu = {
-  "rational"
+  "rational",
+  "transport"
 }
 
 function ClockBase:onShowMenu(objects, branches)
@@ -121,6 +122,18 @@ function ClockBase:onShowMenu(objects, branches)
       end
     end
   }
+
+  -- follow: pulse on the global transport's beats (mult/div still apply).
+  -- lead: also drive the transport tempo from this clock, sync restarts it.
+  controls.transport = OptionControl {
+    description = "Transport",
+    option = objects.clock:getOption("Transport"),
+    choices = {
+      "off",
+      "follow",
+      "lead"
+    }
+  }
   return controls, menu
 end
 
@@ -2,6 +2,7 @@ local app = app
 local libcore = require "core.libcore"
 local Class = require "Base.Class"
 local Unit = require "Unit"
+local OptionControl = require "Unit.MenuControl.OptionControl"
 local Gate = require "Unit.ViewControl.Gate"
 local InputGate = require "Unit.ViewControl.InputGate"
 
@@ -61,4 +62,23 @@ function QuantizeToClock:onLoadViews(objects, branches)
   return controls, views
 end
 
+local menu = {
+  "clockSource"
+}
+
+function QuantizeToClock:onShowMenu(objects, branches)
+  local controls = {}
+
+  controls.clockSource = OptionControl {
+    description = "Quantize To",
+    option = objects.quantizer:getOption("Clock Source"),
+    choices = {
+      "clock",
+      "beats"
+    }
+  }
+
+  return controls, menu
+end
+
 return QuantizeToClock
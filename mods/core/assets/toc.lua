@@ -177,6 +177,11 @@ local units = {
     moduleName = "FreeverbUnit",
     category = "Delays and Reverb",
     keywords = "effect"
+  }, {
+    title = "FDN Reverb",
+    moduleName = "FDNReverbUnit",
+    category = "Delays and Reverb",
+    keywords = "effect"
   }, {
     title = "Ladder LPF",
     moduleName = "LadderFilterUnit",
@@ -187,6 +192,11 @@ local units = {
     moduleName = "LadderHPFUnit",
     category = "Filtering",
     keywords = "filter, pitch"
+  }, {
+    title = "Ladder Bank",
+    moduleName = "LadderBankUnit",
+    category = "Filtering",
+    keywords = "filter, pitch"
   }, {
     title = "EQ3",
     moduleName = "EQ3Unit",
@@ -241,6 +251,11 @@ local units = {
     moduleName = "Oscillators.SingleCycle",
     category = "Oscillators",
     keywords = "source, pitch, modulate"
+  }, {
+    title = "Wavetable",
+    moduleName = "Oscillators.Wavetable",
+    category = "Oscillators",
+    keywords = "source, pitch, modulate"
   }, {
     title = "White Noise",
     moduleName = "Noise.White",
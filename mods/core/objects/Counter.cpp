@@ -1,11 +1,11 @@
 #include <core/objects/Counter.h>
 #include <od/objects/Inlet.h>
+#include <od/objects/TriggerScanner.h>
 #include <od/objects/Option.h>
 #include <od/objects/Parameter.h>
 #include <od/config.h>
 #include <hal/simd.h>
-
-#define LOCAL_USE_NEON 1
+#include <hal/ops.h>
 
 namespace od
 {
@@ -51,8 +51,8 @@ namespace od
     simd_set(mOutput.buffer(), FRAMELENGTH, value * gain + bias);
 
     // Update internal value.
-    bool in = simd_any_positive(mInput.buffer(), FRAMELENGTH);
-    bool reset = simd_any_positive(mReset.buffer(), FRAMELENGTH);
+    bool in = TriggerScanner(mInput).any();
+    bool reset = TriggerScanner(mReset).any();
     int start = mStart.roundTarget();
     int finish = mFinish.roundTarget();
     int step = mStepSize.roundTarget();
@@ -102,9 +102,7 @@ namespace od
 
   void Counter::atSampleRate()
   {
-    float *in = mInput.buffer();
     float *out = mOutput.buffer();
-    float *reset = mReset.buffer();
     int start = mStart.roundTarget();
     int finish = mFinish.roundTarget();
     int step = mStepSize.roundTarget();
@@ -132,46 +130,22 @@ namespace od
       onReset = finish;
     }
 
-#if LOCAL_USE_NEON
-    float32x4_t zero = vdupq_n_f32(0.0f);
-    float32x4_t G = vdupq_n_f32(gain);
+    // Only the samples where a trigger or reset is high change the value.
+    TriggerScanner trigger(mInput);
+    TriggerScanner resetter(mReset);
+    int t = trigger.next();
+    int r = resetter.next();
+    int i = 0;
 
-    for (int i = 0; i < FRAMELENGTH; i += 4)
+    while (t < FRAMELENGTH || r < FRAMELENGTH)
     {
-      uint32_t IN[4], RESET[4];
-      float V[4];
-      vst1q_u32(IN, vcgtq_f32(vld1q_f32(in + i), zero));
-      vst1q_u32(RESET, vcgtq_f32(vld1q_f32(reset + i), zero));
-
-      for (int j = 0; j < 4; j++)
+      int k = MIN(t, r);
+      for (float y = value * gain; i < k; i++)
       {
-        if (IN[j])
-        {
-          value += step;
-          if (value > finish)
-          {
-            value = onFinish;
-          }
-          else if (value < start)
-          {
-            value = onStart;
-          }
-        }
-
-        if (RESET[j])
-        {
-          value = onReset;
-        }
-
-        V[j] = value;
+        out[i] = y;
       }
 
-      vst1q_f32(out + i, G * vld1q_f32(V));
-    }
-#else
-    for (int i = 0; i < FRAMELENGTH; i++)
-    {
-      if (in[i] > 0.0f)
+      if (t == k)
       {
         value += step;
         if (value > finish)
@@ -182,16 +156,20 @@ namespace od
         {
           value = onStart;
         }
+        t = trigger.next();
       }
 
-      if (reset[i] > 0.0f)
+      if (r == k)
       {
         value = onReset;
+        r = resetter.next();
       }
+    }
 
-      out[i] = value * gain;
+    for (float y = value * gain; i < FRAMELENGTH; i++)
+    {
+      out[i] = y;
     }
-#endif
 
     mValue.hardSet(value);
   }
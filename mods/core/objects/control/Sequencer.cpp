@@ -1,10 +1,9 @@
 #include <core/objects/control/Sequencer.h>
+#include <od/objects/TriggerScanner.h>
 #include <hal/simd.h>
 #include <od/config.h>
 #include <hal/ops.h>
 
-#define LOCAL_USE_NEON 1
-
 namespace od
 {
 
@@ -36,8 +35,8 @@ namespace od
 
   void Sequencer::atFrameRate()
   {
-    bool trig = simd_any_positive(mTrigger.buffer(), FRAMELENGTH);
-    bool reset = simd_any_positive(mReset.buffer(), FRAMELENGTH);
+    bool trig = TriggerScanner(mTrigger).any();
+    bool reset = TriggerScanner(mReset).any();
     int stage = MAX(0, mStage.roundValue());
 
     if (reset)
@@ -62,60 +61,58 @@ namespace od
 
   void Sequencer::atSampleRate()
   {
-    float *trig = mTrigger.buffer();
-    float *reset = mReset.buffer();
     float *out = mOutput.buffer();
     int stage = MAX(0, mStage.roundValue());
     int N = count();
 
-#if LOCAL_USE_NEON
-    float32x4_t zero = vdupq_n_f32(0.0f);
-    for (int i = 0; i < FRAMELENGTH; i += 4)
+    if (N == 0)
     {
-      uint32_t TRIG[4], RESET[4];
-      vst1q_u32(TRIG, vcgtq_f32(vld1q_f32(trig + i), zero));
-      vst1q_u32(RESET, vcgtq_f32(vld1q_f32(reset + i), zero));
-      for (int j = 0; j < 4; j++)
-      {
-        if (RESET[j])
-        {
-          stage = 0;
-        }
-
-        if (TRIG[j])
-        {
-          stage++;
-        }
-
-        if (stage >= N)
-        {
-          stage = 0;
-        }
-
-        out[i + j] = mStages[stage];
-      }
+      simd_set(out, FRAMELENGTH, 0.0f);
+      return;
+    }
+
+    // Only the samples where a trigger or reset is high change the stage.
+    TriggerScanner trigger(mTrigger);
+    TriggerScanner resetter(mReset);
+    int t = trigger.next();
+    int r = resetter.next();
+    int i = 0;
+
+    if (stage >= N)
+    {
+      stage = 0;
     }
-#else
-    for (int i = 0; i < FRAMELENGTH; i++)
+
+    while (t < FRAMELENGTH || r < FRAMELENGTH)
     {
-      if (reset[i] > 0.0f)
+      int k = MIN(t, r);
+      for (float y = mStages[stage]; i < k; i++)
+      {
+        out[i] = y;
+      }
+
+      if (r == k)
       {
         stage = 0;
+        r = resetter.next();
       }
 
-      if (trig[i] > 0.0f)
+      if (t == k)
       {
         stage++;
+        t = trigger.next();
       }
 
       if (stage >= N)
       {
         stage = 0;
       }
+    }
 
-      out[i] = mStages[stage];
+    for (float y = mStages[stage]; i < FRAMELENGTH; i++)
+    {
+      out[i] = y;
     }
-#endif
 
     mStage.hardSet(stage);
   }
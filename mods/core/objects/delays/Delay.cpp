@@ -1,5 +1,4 @@
 #include <core/objects/delays/Delay.h>
-#include <od/extras/BigHeap.h>
 #include <od/AudioThread.h>
 #include <od/config.h>
 #include <hal/ops.h>
@@ -31,32 +30,22 @@ namespace od
 
   void Delay::zero()
   {
-    if (mLeftDelayLine.mpBuffer)
-    {
-      bzero(mLeftDelayLine.mpBuffer, mMaxDelayInSamples * sizeof(float));
-    }
-
-    if (mRightDelayLine.mpBuffer)
-    {
-      bzero(mRightDelayLine.mpBuffer, mMaxDelayInSamples * sizeof(float));
-    }
+    mLeftDelayLine.mLine.zero();
+    mRightDelayLine.mLine.zero();
   }
 
   bool Delay::allocate(int Ns)
   {
     deallocate();
-    int nbytes = Ns * sizeof(float);
 
-    mLeftDelayLine.mpBuffer = BigHeap::allocateZeroed(nbytes);
-    if (mLeftDelayLine.mpBuffer == 0)
+    if (!mLeftDelayLine.mLine.allocate(Ns))
     {
       return false;
     }
 
     if (mChannelCount > 1)
     {
-      mRightDelayLine.mpBuffer = BigHeap::allocateZeroed(nbytes);
-      if (mRightDelayLine.mpBuffer == 0)
+      if (!mRightDelayLine.mLine.allocate(Ns))
       {
         deallocate();
         return false;
@@ -68,17 +57,8 @@ namespace od
 
   void Delay::deallocate()
   {
-    if (mLeftDelayLine.mpBuffer)
-    {
-      BigHeap::free(mLeftDelayLine.mpBuffer);
-      mLeftDelayLine.mpBuffer = 0;
-    }
-
-    if (mRightDelayLine.mpBuffer)
-    {
-      BigHeap::free(mRightDelayLine.mpBuffer);
-      mRightDelayLine.mpBuffer = 0;
-    }
+    mLeftDelayLine.mLine.deallocate();
+    mRightDelayLine.mLine.deallocate();
   }
 
   float Delay::allocateTimeUpTo(float seconds)
@@ -93,12 +73,10 @@ namespace od
     }
 
     mMaxDelayInSamples = 0;
-    mLeftDelayLine.mWriteIndex = 0;
-    mLeftDelayLine.mReadIndex0 = 0;
-    mLeftDelayLine.mReadIndex1 = 0;
-    mRightDelayLine.mWriteIndex = 0;
-    mRightDelayLine.mReadIndex0 = 0;
-    mRightDelayLine.mReadIndex1 = 0;
+    mLeftDelayLine.mDelay0 = 0;
+    mLeftDelayLine.mDelay1 = 0;
+    mRightDelayLine.mDelay0 = 0;
+    mRightDelayLine.mDelay1 = 0;
 
     while (Nf > 1)
     {
@@ -164,27 +142,23 @@ namespace od
 
   void Delay::updateTime(InternalDelayLine &D, float delay)
   {
-    D.mReadIndex0 = D.mReadIndex1;
+    D.mDelay0 = D.mDelay1;
     // Set the new read position based on the updated delay
     int n = delay * globalConfig.sampleRate;
 
-    // Enforce multiples of 4 samples for Neon.
+    // Enforce multiples of 4 samples so that feedback is written in whole blocks.
     n = (n / 4) * 4;
     if (n < 0)
       n = 0;
     else if (n > mMaxDelayInSamples)
       n = mMaxDelayInSamples;
-    D.mReadIndex1 = D.mWriteIndex - n;
-    if (D.mReadIndex1 < 0)
-    {
-      D.mReadIndex1 += mMaxDelayInSamples;
-    }
+    D.mDelay1 = n;
   }
 
   void Delay::pushSamples(InternalDelayLine &D, float *in, float *out,
                           float *feedback, float *fade)
   {
-    float *buffer = (float *)(D.mpBuffer);
+    DelayLine &line = D.mLine;
     float32x4_t one = vdupq_n_f32(1);
     float32x4_t zero = vdupq_n_f32(0);
 
@@ -193,36 +167,18 @@ namespace od
       float32x4_t x = vld1q_f32(in + i);
 
       // pre-write for zero-delay case
-      vst1q_f32(buffer + D.mWriteIndex, x);
+      line.write4(x);
 
       // push 4 samples down the delay line
-      float32x4_t y0 = vld1q_f32(buffer + D.mReadIndex0);
-      float32x4_t y1 = vld1q_f32(buffer + D.mReadIndex1);
+      float32x4_t y0 = line.read4(D.mDelay0);
+      float32x4_t y1 = line.read4(D.mDelay1);
       float32x4_t w = vld1q_f32(fade + i);
       float32x4_t y = w * y0 + (one - w) * y1;
       float32x4_t g = vld1q_f32(feedback + i);
       // clamp feedback
       g = vminq_f32(one, vmaxq_f32(zero, g));
-      vst1q_f32(buffer + D.mWriteIndex, vmlaq_f32(x, y, g));
+      line.push4(vmlaq_f32(x, y, g));
       vst1q_f32(out + i, y);
-
-      D.mReadIndex0 += 4;
-      if (D.mReadIndex0 >= mMaxDelayInSamples)
-      {
-        D.mReadIndex0 = 0;
-      }
-
-      D.mReadIndex1 += 4;
-      if (D.mReadIndex1 >= mMaxDelayInSamples)
-      {
-        D.mReadIndex1 = 0;
-      }
-
-      D.mWriteIndex += 4;
-      if (D.mWriteIndex >= mMaxDelayInSamples)
-      {
-        D.mWriteIndex = 0;
-      }
     }
   }
 
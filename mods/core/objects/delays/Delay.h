@@ -2,6 +2,7 @@
 
 #include <od/objects/Object.h>
 #include <od/extras/LinearRamp.h>
+#include <od/extras/DelayLine.h>
 
 namespace od
 {
@@ -33,10 +34,10 @@ namespace od
   private:
     struct InternalDelayLine
     {
-      char *mpBuffer = 0;
-      int mReadIndex0 = 0;
-      int mReadIndex1 = 0;
-      int mWriteIndex = 0;
+      DelayLine mLine;
+      // previous and current delay (in samples)
+      int mDelay0 = 0;
+      int mDelay1 = 0;
     };
 
     InternalDelayLine mLeftDelayLine;
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <od/objects/Object.h>
+#include <od/extras/DelayLine.h>
 
 namespace od
 {
@@ -26,29 +27,8 @@ namespace od
     float maximumDelayTime();
 
   private:
-    float *mpBuffer = 0;
-    float *mpRead = 0;
-    float *mpWrite = 0;
-    float *mpEnd = 0;
-    float *mpBegin = 0;
-    float mPhase = 0;
-    float mPreviousDelay = 0; // in secs
-    int mMaxDelayInSamples = 0;
+    DelayLine mDelayLine;
     float mMaxDelayInSeconds = 0;
-
-    float mFifo[3] = {0, 0, 0};
-    inline void read();
-    inline void read4(float *phaseDelta, float *phase, float *recent0,
-                      float *recent1, float *recent2);
-    inline void write(float *in, float *out, float *feedback, float *phase,
-                      float *recent0, float *recent1, float *recent2);
-
-    inline void jumpTo(float *next)
-    {
-      mpRead = next;
-    }
-
-    bool allocate(int Ns);
   };
 
 } /* namespace od */
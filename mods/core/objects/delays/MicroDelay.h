@@ -1,6 +1,7 @@
 #pragma once
 
 #include <od/objects/Object.h>
+#include <od/extras/DelayLine.h>
 
 namespace od
 {
@@ -19,12 +20,7 @@ namespace od
 #endif
 
   private:
-    std::vector<float> mBuffer;
-    int mReadIndex = 0;
-    int mWriteIndex = 0;
-    int mMaxDelayInSamples = 0;
-
-    void setMaxDelay(int n);
+    DelayLine mDelayLine;
   };
 
 } /* namespace od */
@@ -42,7 +42,7 @@ namespace od
     float *K = AudioThread::getFrame();
     float *R = AudioThread::getFrame();
 
-    float32x4_t glog2 = vdupq_n_f32(FULLSCALE_IN_VOLTS * logf(2.0f));
+    float32x4_t vpo = vdupq_n_f32(FULLSCALE_IN_VOLTS);
     float32x4_t maxf = vdupq_n_f32(0.9999f);
     float32x4_t minf = vdupq_n_f32(minNormF);
     float32x4_t f0 = vdupq_n_f32(normF0);
@@ -63,7 +63,7 @@ namespace od
     {
       float32x4_t q = vld1q_f32(octave + i);
 
-      q = f0 * simd_exp(q * glog2);
+      q = f0 * simd_exp2_fast(q * vpo);
       q = vminq_f32(maxf, q);
       q = vmaxq_f32(minf, q);
       float32x4_t cutoffq = q;
@@ -0,0 +1,235 @@
+/*
+ * Inspired by: http://www.musicdsp.org/archive.php?classid=3#24
+ */
+
+#include <core/objects/filters/LadderFilterBank.h>
+#include <od/extras/Random.h>
+#include <od/AudioThread.h>
+#include <od/config.h>
+#include <hal/ops.h>
+#include <math.h>
+#include <string.h>
+#include <sstream>
+
+#define MAX_VOICES 16
+
+// band-limited saturation
+#define SATURATE(x)                                      \
+  {                                                      \
+    x = vminq_f32(x, max);                               \
+    x = vmaxq_f32(x, min);                               \
+    x = vmlaq_f32(x, c9, vmulq_f32(x, vmulq_f32(x, x))); \
+  }
+
+namespace od
+{
+
+  LadderFilterBank::LadderFilterBank(int n)
+  {
+    mVoiceCount = CLAMP(1, MAX_VOICES, n);
+
+    // Inlets are ordered by voice: In, V/Oct, Resonance.
+    for (int i = 0; i < mVoiceCount; i++)
+    {
+      std::ostringstream in, voct, res;
+      in << "In" << i + 1;
+      voct << "V/Oct" << i + 1;
+      res << "Resonance" << i + 1;
+      addInputFromHeap(new Inlet(in.str()));
+      addInputFromHeap(new Inlet(voct.str()));
+      addInputFromHeap(new Inlet(res.str()));
+    }
+    addInput(mFundamental);
+
+    for (int i = 0; i < mVoiceCount; i++)
+    {
+      std::ostringstream out;
+      out << "Out" << i + 1;
+      addOutputFromHeap(new Outlet(out.str()));
+    }
+
+    mGroups.resize((mVoiceCount + 3) / 4);
+    for (Group &g : mGroups)
+    {
+      g.stage0 = g.stage1 = g.stage2 = g.stage3 = vdupq_n_f32(0);
+      g.delay0 = g.delay1 = g.delay2 = g.delay3 = vdupq_n_f32(0);
+    }
+  }
+
+  LadderFilterBank::~LadderFilterBank()
+  {
+  }
+
+  void LadderFilterBank::process()
+  {
+    float *zero = 0;
+    float *discard = 0;
+
+    if (mVoiceCount % 4)
+    {
+      // Unused lanes of the last group are fed from silence.
+      zero = AudioThread::getFrame();
+      discard = AudioThread::getFrame();
+      memset(zero, 0, sizeof(float) * FRAMELENGTH);
+    }
+
+    for (int i = 0; i < (int)mGroups.size(); i++)
+    {
+      processGroup(mGroups[i], 4 * i, zero, discard);
+    }
+
+    if (zero)
+    {
+      AudioThread::releaseFrame(zero);
+      AudioThread::releaseFrame(discard);
+    }
+  }
+
+  // The coefficient calculation is vectorized across time (as in LadderFilter)
+  // for each voice, then transposed so that the serial recurrence is
+  // vectorized across voices.
+  void LadderFilterBank::processGroup(Group &g, int firstVoice,
+                                      float *zero, float *discard)
+  {
+    float *in[4], *octave[4], *res[4], *out[4];
+    for (int v = 0; v < 4; v++)
+    {
+      int voice = firstVoice + v;
+      if (voice < mVoiceCount)
+      {
+        in[v] = mInputs[3 * voice]->buffer();
+        octave[v] = mInputs[3 * voice + 1]->buffer();
+        res[v] = mInputs[3 * voice + 2]->buffer();
+        out[v] = mOutputs[voice]->buffer();
+      }
+      else
+      {
+        in[v] = zero;
+        octave[v] = zero;
+        res[v] = zero;
+        out[v] = discard;
+      }
+    }
+    float *freq = mFundamental.buffer();
+    float minNormF = 2.0f * globalConfig.samplePeriod;
+
+    float32x4_t vpo = vdupq_n_f32(FULLSCALE_IN_VOLTS);
+    float32x4_t maxf = vdupq_n_f32(0.9999f);
+    float32x4_t minf = vdupq_n_f32(minNormF);
+    float32x4_t halfpi = vdupq_n_f32(0.5f * M_PI);
+    float32x4_t sr = vdupq_n_f32(2.0f * globalConfig.samplePeriod);
+
+    float32x4_t c1 = vdupq_n_f32(1.8f);
+    float32x4_t c2 = vdupq_n_f32(-0.8f);
+    float32x4_t c3 = vdupq_n_f32(2.0f);
+    float32x4_t c4 = vdupq_n_f32(-1.0f);
+    float32x4_t c6 = vdupq_n_f32(1.386249f);
+    float32x4_t c7 = vdupq_n_f32(12.0f);
+    float32x4_t c8 = vdupq_n_f32(6.0f);
+
+    float32x4_t c9 = vdupq_n_f32(-1.0f / 6.0f);
+    float32x4_t max = vdupq_n_f32(1.4142135623730951f);
+    float32x4_t min = vdupq_n_f32(-1.4142135623730951f);
+    float32x4_t noise = vdupq_n_f32(Random::generateFloat(-1e-10f, 1e-10f));
+
+    float32x4_t stage0 = g.stage0;
+    float32x4_t stage1 = g.stage1;
+    float32x4_t stage2 = g.stage2;
+    float32x4_t stage3 = g.stage3;
+
+    float32x4_t delay0 = g.delay0;
+    float32x4_t delay1 = g.delay1;
+    float32x4_t delay2 = g.delay2;
+    float32x4_t delay3 = g.delay3;
+
+    // Rows are indexed by voice before the transpose and by time after it.
+    float32x4_t P[4], K[4], R[4], X[4], Y[4];
+
+    for (int i = 0; i < FRAMELENGTH; i += 4)
+    {
+      float32x4_t f0 = sr * vld1q_f32(freq + i);
+
+      // calculate filter coefficients for 4 samples of each voice
+      for (int v = 0; v < 4; v++)
+      {
+        float32x4_t q = vld1q_f32(octave[v] + i);
+        q = f0 * simd_exp2_fast(q * vpo);
+        q = vminq_f32(maxf, q);
+        q = vmaxq_f32(minf, q);
+        float32x4_t cutoffq = q;
+        float32x4_t sq = simd_sin(halfpi * q);
+
+        // p = cutoff * (1.8f - 0.8f * cutoff);
+        float32x4_t pq = vmulq_f32(cutoffq, vmlaq_f32(c1, c2, cutoffq));
+        // k = 2.0f * sin(0.5 * pi * cutoff) - 1.0f;
+        float32x4_t kq = vmlaq_f32(c4, c3, sq);
+        // t1 = (1.0f - p) * 1.386249f;
+        float32x4_t t1q = vmlsq_f32(c6, c6, pq);
+        // t2 = 12.0f + t1 * t1;
+        float32x4_t t2q = vmlaq_f32(c7, t1q, t1q);
+
+        float32x4_t a = vmlaq_f32(t2q, c8, t1q);
+        float32x4_t b = vmlsq_f32(t2q, c8, t1q);
+        // division
+        float32x4_t invb = vrecpeq_f32(b);
+        // iterate 3 times for 24 bits of precision
+        invb = vmulq_f32(invb, vrecpsq_f32(b, invb));
+        invb = vmulq_f32(invb, vrecpsq_f32(b, invb));
+        invb = vmulq_f32(invb, vrecpsq_f32(b, invb));
+
+        // r = res * (t2 + 6.0f * t1) / (t2 - 6.0f * t1);
+        R[v] = vmulq_f32(vld1q_f32(res[v] + i), a * invb);
+        P[v] = pq;
+        K[v] = kq;
+        X[v] = vld1q_f32(in[v] + i);
+      }
+
+      simd_transpose4x4(P);
+      simd_transpose4x4(K);
+      simd_transpose4x4(R);
+      simd_transpose4x4(X);
+
+      // run the recurrence for 4 samples with one voice per lane
+      for (int t = 0; t < 4; t++)
+      {
+        float32x4_t pd = P[t];
+        float32x4_t kd = K[t];
+
+        float32x4_t xd = vaddq_f32(X[t], noise); // add regularization noise
+        xd = vmlsq_f32(xd, R[t], stage3);        // feedback
+
+        // Four cascaded one-pole filters (bilinear transform)
+        stage0 = vsubq_f32(vmulq_f32(pd, vaddq_f32(xd, delay0)), vmulq_f32(kd, stage0));
+        stage1 = vsubq_f32(vmulq_f32(pd, vaddq_f32(stage0, delay1)), vmulq_f32(kd, stage1));
+        stage2 = vsubq_f32(vmulq_f32(pd, vaddq_f32(stage1, delay2)), vmulq_f32(kd, stage2));
+        stage3 = vsubq_f32(vmulq_f32(pd, vaddq_f32(stage2, delay3)), vmulq_f32(kd, stage3));
+        SATURATE(stage3);
+
+        delay0 = xd;
+        delay1 = stage0;
+        delay2 = stage1;
+        delay3 = stage2;
+
+        Y[t] = stage3;
+      }
+
+      simd_transpose4x4(Y);
+
+      for (int v = 0; v < 4; v++)
+      {
+        vst1q_f32(out[v] + i, Y[v]);
+      }
+    }
+
+    g.stage0 = stage0;
+    g.stage1 = stage1;
+    g.stage2 = stage2;
+    g.stage3 = stage3;
+
+    g.delay0 = delay0;
+    g.delay1 = delay1;
+    g.delay2 = delay2;
+    g.delay3 = delay3;
+  }
+
+} // namespace od
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <od/objects/Object.h>
+#include <hal/simd.h>
+#include <vector>
+
+namespace od
+{
+
+  // N independent ladder filters processed together, one voice per SIMD lane.
+  class LadderFilterBank : public Object
+  {
+  public:
+    LadderFilterBank(int n);
+    virtual ~LadderFilterBank();
+
+#ifndef SWIGLUA
+    virtual void process();
+    // Per-voice inputs and outputs are allocated dynamically.
+    Inlet mFundamental{"Fundamental"};
+#endif
+
+    int getVoiceCount()
+    {
+      return mVoiceCount;
+    }
+
+  private:
+    struct Group
+    {
+      float32x4_t stage0, stage1, stage2, stage3;
+      float32x4_t delay0, delay1, delay2, delay3;
+    };
+
+    int mVoiceCount;
+    std::vector<Group> mGroups;
+
+    void processGroup(Group &g, int firstVoice, float *zero, float *discard);
+  };
+
+} /* namespace od */
@@ -24,13 +24,18 @@ namespace od
 
   StereoLadderFilter::StereoLadderFilter()
   {
-    addInput(mLeftInput);
-    addInput(mRightInput);
+    mInput.addChannel("Left In");
+    mInput.addChannel("Right In");
+    mOutput.addChannel("Left Out");
+    mOutput.addChannel("Right Out");
+    // Keep the indices of the separate ports the channels replaced.
+    addInputFromHeap(mInput.getChannel(0));
+    addInputFromHeap(mInput.getChannel(1));
     addInput(mVoltPerOctave);
     addInput(mResonance);
-    addOutput(mLeftOutput);
-    addOutput(mRightOutput);
+    addOutput(mOutput);
     addInput(mFundamental);
+    addInput(mInput);
     mStage0 = vdup_n_f32(0);
     mStage1 = vdup_n_f32(0);
     mStage2 = vdup_n_f32(0);
@@ -48,10 +53,10 @@ namespace od
   // [Ladder Filter]: 1.2840% (34388 ticks, 373 Hz)
   void StereoLadderFilter::process()
   {
-    float *leftOut = mLeftOutput.buffer();
-    float *rightOut = mRightOutput.buffer();
-    float *leftIn = mLeftInput.buffer();
-    float *rightIn = mRightInput.buffer();
+    float *leftOut = mOutput.buffer(0);
+    float *rightOut = mOutput.buffer(1);
+    float *leftIn = mInput.buffer(0);
+    float *rightIn = mInput.buffer(1);
     float *octave = mVoltPerOctave.buffer();
     float *res = mResonance.buffer();
     float *freq = mFundamental.buffer();
@@ -61,7 +66,7 @@ namespace od
     float *K = AudioThread::getFrame();
     float *R = AudioThread::getFrame();
 
-    float32x4_t glog2 = vdupq_n_f32(FULLSCALE_IN_VOLTS * logf(2.0f));
+    float32x4_t vpo = vdupq_n_f32(FULLSCALE_IN_VOLTS);
     float32x4_t maxf = vdupq_n_f32(0.9999f);
     float32x4_t minf = vdupq_n_f32(minNormF);
     float32x4_t halfpi = vdupq_n_f32(0.5f * M_PI);
@@ -81,7 +86,7 @@ namespace od
       float32x4_t q = vld1q_f32(octave + i);
       float32x4_t f0 = sr * vld1q_f32(freq + i);
 
-      q = f0 * simd_exp(q * glog2);
+      q = f0 * simd_exp2_fast(q * vpo);
       q = vminq_f32(maxf, q);
       q = vmaxq_f32(minf, q);
       float32x4_t cutoffq = q;
@@ -14,13 +14,13 @@ namespace od
 
 #ifndef SWIGLUA
     virtual void process();
-    Inlet mLeftInput{"Left In"};
-    Inlet mRightInput{"Right In"};
+    // Channels: "Left In" and "Right In"
+    Inlet mInput{"In"};
     Inlet mVoltPerOctave{"V/Oct"};
     Inlet mResonance{"Resonance"};
     Inlet mFundamental{"Fundamental"};
-    Outlet mLeftOutput{"Left Out"};
-    Outlet mRightOutput{"Right Out"};
+    // Channels: "Left Out" and "Right Out"
+    Outlet mOutput{"Out"};
 #endif
 
   private:
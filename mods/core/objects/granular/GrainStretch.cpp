@@ -1,5 +1,6 @@
 #include <core/objects/granular/GrainStretch.h>
 #include <od/extras/Random.h>
+#include <od/extras/MemoryTracker.h>
 #include <hal/simd.h>
 #include <hal/ops.h>
 #include <algorithm>
@@ -24,6 +25,7 @@ namespace od
 
   GrainStretch::~GrainStretch()
   {
+    MemoryTracker::freed(MEMORY_GRAINS, mGrainBytes);
   }
 
   void GrainStretch::setMaximumGrainCount(int n)
@@ -51,6 +53,11 @@ namespace od
       grain.setEnvelope(Grain::mSineWindow);
       grain.setSquash(2);
     }
+
+    int bytes = mStereoGrains.capacity() * sizeof(StereoGrain) +
+                mMonoGrains.capacity() * sizeof(MonoGrain);
+    MemoryTracker::resize(MEMORY_GRAINS, mGrainBytes, bytes);
+    mGrainBytes = bytes;
   }
 
   StereoGrain *GrainStretch::getNextFreeStereoGrain()
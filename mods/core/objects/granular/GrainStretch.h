@@ -38,6 +38,8 @@ namespace od
     std::vector<MonoGrain> mMonoGrains;
     std::vector<MonoGrain *> mFreeMonoGrains;
     std::vector<MonoGrain *> mActiveMonoGrains;
+    // Bytes currently reported to the MemoryTracker.
+    int mGrainBytes = 0;
 
     int mOutputChannelCount;
     int mGrainCount;
@@ -1,4 +1,5 @@
 #include <core/objects/granular/GranularHead.h>
+#include <od/extras/MemoryTracker.h>
 #include <hal/ops.h>
 #include <algorithm>
 #include <math.h>
@@ -24,6 +25,7 @@ namespace od
   GranularHead::~GranularHead()
   {
     setSample(0);
+    MemoryTracker::freed(MEMORY_GRAINS, mGrainBytes);
   }
 
   int GranularHead::getGrainCount()
@@ -159,6 +161,11 @@ namespace od
     {
       mGainCompensation[i] = 1.0f / sqrtf(n - i);
     }
+
+    int bytes = mStereoGrains.capacity() * sizeof(StereoGrain) +
+                mMonoGrains.capacity() * sizeof(MonoGrain);
+    MemoryTracker::resize(MEMORY_GRAINS, mGrainBytes, bytes);
+    mGrainBytes = bytes;
   }
 
   StereoGrain *GranularHead::getNextFreeStereoGrain()
@@ -46,6 +46,8 @@ namespace od
     std::vector<MonoGrain> mMonoGrains;
     std::vector<MonoGrain *> mFreeMonoGrains;
     std::vector<MonoGrain *> mActiveMonoGrains;
+    // Bytes currently reported to the MemoryTracker.
+    int mGrainBytes = 0;
 
     // gain compensation (indexed by number of free grains)
     std::vector<float> mGainCompensation;
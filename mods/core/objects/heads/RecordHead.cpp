@@ -1,6 +1,12 @@
 #include <core/objects/heads/RecordHead.h>
+#include <od/config.h>
 #include <math.h>
 
+// Samples per channel in each page of undo memory.
+#define PAGE_SIZE_SAMPLES 4096
+// Pages swapped per frame while an undo or redo is in progress.
+#define PAGES_PER_FRAME 2
+
 namespace od
 {
 
@@ -20,4 +26,110 @@ namespace od
 		}
 	}
 
+	void RecordHead::setSample(Sample *sample)
+	{
+		{
+			Lock lock(mHistoryMutex);
+			mHistory.deallocate();
+			Base::setSample(sample);
+		}
+		// The audio thread ignores the history until it is ready again.
+		allocateHistory();
+	}
+
+	void RecordHead::setUndoTime(float seconds)
+	{
+		{
+			Lock lock(mHistoryMutex);
+			mUndoTime = seconds > 0.0f ? seconds : 0.0f;
+			mHistory.deallocate();
+		}
+		allocateHistory();
+	}
+
+	void RecordHead::allocateHistory()
+	{
+		Sample *sample = mpSample;
+		if (sample == 0 || mUndoTime <= 0.0f)
+		{
+			return;
+		}
+
+		int channelCount = sample->mChannelCount;
+		int pageSize = PAGE_SIZE_SAMPLES * channelCount;
+		int poolSize = (int)(mUndoTime * sample->mSampleRate) / PAGE_SIZE_SAMPLES + 1;
+		int size = sample->mSampleCount * channelCount;
+		while (poolSize > 0 && !mHistory.allocate(sample->mpData, size, pageSize, poolSize))
+		{
+			poolSize /= 2;
+		}
+	}
+
+	void RecordHead::updateHistory(bool writing, bool undo, bool redo)
+	{
+		if (!isHistoryReady())
+		{
+			return;
+		}
+
+		mHistory.progress(PAGES_PER_FRAME);
+
+		if (writing)
+		{
+			if (!mHistory.isOpen())
+			{
+				mHistory.beginTake();
+			}
+		}
+		else
+		{
+			mHistory.endTake();
+			if (undo)
+			{
+				mHistory.undo();
+			}
+			else if (redo)
+			{
+				mHistory.redo();
+			}
+		}
+	}
+
+	void RecordHead::preserve(int index, int count)
+	{
+		if (!mHistory.isOpen() || !isHistoryReady())
+		{
+			return;
+		}
+
+		int last = index + count - 1;
+		if (last > mEndIndex)
+		{
+			preserveSpan(0, last - mEndIndex - 1);
+			last = mEndIndex;
+		}
+		preserveSpan(index, last);
+	}
+
+	void RecordHead::preserveSpan(int first, int last)
+	{
+		int sampleCount = mpSample->mSampleCount;
+		if (last >= sampleCount)
+		{
+			last = sampleCount - 1;
+		}
+		if (first < 0 || first > last)
+		{
+			return;
+		}
+
+		int channelCount = mpSample->mChannelCount;
+		int pageSize = mHistory.getPageSize();
+		int end = (last * channelCount + channelCount - 1) / pageSize;
+		for (int slot = first * channelCount / pageSize; slot <= end; slot++)
+		{
+			mHistory.protect(slot);
+		}
+	}
+
 } /* namespace od */
@@ -2,6 +2,8 @@
 
 #include <od/objects/heads/TapeHead.h>
 #include <od/extras/LinearRamp.h>
+#include <core/objects/looping/LoopHistory.h>
+#include <hal/concurrency/Mutex.h>
 
 namespace od
 {
@@ -14,8 +16,48 @@ namespace od
 
 		void zeroBuffer();
 
+		virtual void setSample(Sample *sample);
+
+		// Seconds of overdubbed audio that can be undone (0 disables undo).
+		void setUndoTime(float seconds);
+		float getUndoTime()
+		{
+			return mUndoTime;
+		}
+
+		int getUndoCount()
+		{
+			return mHistory.getUndoCount();
+		}
+
+		int getRedoCount()
+		{
+			return mHistory.getRedoCount();
+		}
+
+	protected:
+		LoopHistory mHistory;
+		float mUndoTime = 0.0f;
+		// Held by the audio thread for the whole frame, and by the UI thread
+		// while it swaps the sample or frees the history.
+		Mutex mHistoryMutex;
+
+		void allocateHistory();
+
+		// Call once per frame before writing.  Each stretch of writing frames
+		// becomes a take.  Undo and redo are ignored while writing.
+		void updateHistory(bool writing, bool undo, bool redo);
+		// Journal count samples from index onwards, wrapping after mEndIndex.
+		void preserve(int index, int count);
+
+		inline bool isHistoryReady()
+		{
+			return mpSample && mHistory.getData() == mpSample->mpData;
+		}
+
 	private:
 		typedef TapeHead Base;
+		void preserveSpan(int first, int last);
 	};
 
 } /* namespace od */
@@ -23,6 +23,8 @@ namespace od
     addInput(mReset);
     addInput(mPunch);
     addInput(mEngage);
+    addInput(mUndo);
+    addInput(mRedo);
     addInput(mFeedback);
     addParameter(mResetPosition);
     addParameter(mFadeTime);
@@ -54,22 +56,39 @@ namespace od
 
   void FeedbackLooper::process()
   {
+    Lock lock(mHistoryMutex);
     if (mpSample == 0)
     {
       return;
     }
 
+    // Only punched-in frames can change the buffer.
+    float *punch = mPunch.buffer();
+    float *engage = mEngage.buffer();
+    bool writing = simd_any_positive(engage, FRAMELENGTH) &&
+                   (mPunched || mPunchFade.mValue > 0.0f || mPunchFade.notFinished() ||
+                    simd_any_positive(punch, FRAMELENGTH));
+    bool undo = simd_any_positive(mUndo.buffer(), FRAMELENGTH);
+    bool redo = simd_any_positive(mRedo.buffer(), FRAMELENGTH);
+    updateHistory(writing, undo, redo);
+    if (writing)
+    {
+      // Heads advance at most one frame's worth of samples.
+      preserve(mCurrentIndex, FRAMELENGTH);
+      preserve(mShadowIndex, FRAMELENGTH);
+    }
+
     if (mChannelCount < 2)
     {
-      mono();
+      mono(writing);
     }
     else
     {
-      stereo();
+      stereo(writing);
     }
   }
 
-  void FeedbackLooper::stereo()
+  void FeedbackLooper::stereo(bool writing)
   {
     float *leftIn = mLeftInput.buffer();
     float *rightIn = mRightInput.buffer();
@@ -89,6 +108,10 @@ namespace od
       mResetRequested = false;
       setResetProportional(mResetPosition.value());
       jumpTo(mLeftResetIndex, fadeTime);
+      if (writing)
+      {
+        preserve(mCurrentIndex, FRAMELENGTH);
+      }
     }
 
     for (int i = 0; i < FRAMELENGTH; i++)
@@ -228,13 +251,17 @@ namespace od
       {
         setResetProportional(mResetPosition.value());
         jumpTo(mLeftResetIndex, fadeTime);
+        if (writing)
+        {
+          preserve(mCurrentIndex, FRAMELENGTH - i);
+        }
       }
     }
 
     mpSample->mDirty = dirty;
   }
 
-  void FeedbackLooper::mono()
+  void FeedbackLooper::mono(bool writing)
   {
 
     float *in = mLeftInput.buffer();
@@ -251,6 +278,10 @@ namespace od
       mResetRequested = false;
       setResetProportional(mResetPosition.value());
       jumpTo(mLeftResetIndex, fadeTime);
+      if (writing)
+      {
+        preserve(mCurrentIndex, FRAMELENGTH);
+      }
     }
 
     for (int i = 0; i < FRAMELENGTH; i++)
@@ -347,6 +378,10 @@ namespace od
       {
         setResetProportional(mResetPosition.value());
         jumpTo(mLeftResetIndex, fadeTime);
+        if (writing)
+        {
+          preserve(mCurrentIndex, FRAMELENGTH - i);
+        }
       }
     }
 
@@ -17,6 +17,8 @@ namespace od
     Inlet mReset{"Reset"};
     Inlet mPunch{"Punch"};
     Inlet mEngage{"Engage"};
+    Inlet mUndo{"Undo"};
+    Inlet mRedo{"Redo"};
     // recommended to put a (0,1) limiter on this input
     Inlet mFeedback{"Feedback"};
     Parameter mResetPosition{"Start"};
@@ -46,8 +48,8 @@ namespace od
       mShadowFade.reset(0.0f, 1.0f);
     }
 
-    void mono();
-    void stereo();
+    void mono(bool writing);
+    void stereo(bool writing);
   };
 
 } /* namespace od */
@@ -0,0 +1,472 @@
+#include <core/objects/looping/LoopHistory.h>
+#include <od/extras/BigHeap.h>
+#include <od/extras/MemoryTracker.h>
+#include <string.h>
+
+namespace od
+{
+
+  LoopHistory::LoopHistory()
+  {
+  }
+
+  LoopHistory::~LoopHistory()
+  {
+    deallocate();
+  }
+
+  bool LoopHistory::allocatePool(int pageCount)
+  {
+    int nbytes = pageCount * mPageSize * sizeof(float);
+    mpMemory = BigHeap::allocateZeroed(nbytes);
+    if (mpMemory == 0)
+    {
+      return false;
+    }
+    mMemorySize = nbytes;
+    MemoryTracker::allocated(MEMORY_OTHER, mMemorySize);
+    return true;
+  }
+
+  bool LoopHistory::allocate(int slotCount, int pageSize, int poolSize)
+  {
+    deallocate();
+    mCopyOnWrite = true;
+    mPageSize = pageSize;
+    mPoolSize = poolSize;
+    mSlotCount = slotCount;
+
+    // One extra page stays silent for slots that were never written.
+    if (!allocatePool(poolSize + 1))
+    {
+      deallocate();
+      return false;
+    }
+    mpSilence = (float *)mpMemory + poolSize * pageSize;
+
+    mSlots.assign(slotCount, mpSilence);
+    mPrevious.assign(slotCount, 0);
+    mOwner.assign(slotCount, 0);
+    mFree.resize(poolSize);
+    mSnapshot.assign(slotCount, mpSilence);
+    mPinnedPages.assign(poolSize, 0);
+    mDeferred.resize(poolSize);
+    // Slots that hold silence are journaled too, so allow for them.
+    mEntries.resize(poolSize + 2 * slotCount);
+    clear();
+    return true;
+  }
+
+  bool LoopHistory::allocate(float *data, int size, int pageSize, int poolSize)
+  {
+    deallocate();
+    mCopyOnWrite = false;
+    mPageSize = pageSize;
+    mPoolSize = poolSize;
+    mSlotCount = (size + pageSize - 1) / pageSize;
+
+    if (!allocatePool(poolSize))
+    {
+      deallocate();
+      return false;
+    }
+
+    mSlots.resize(mSlotCount);
+    for (int i = 0; i < mSlotCount; i++)
+    {
+      mSlots[i] = data + i * pageSize;
+    }
+    mPrevious.assign(mSlotCount, 0);
+    mOwner.assign(mSlotCount, 0);
+    mFree.resize(poolSize);
+    mEntries.resize(poolSize + 1);
+    mDataSize = size;
+    clear();
+    // Set last so that the audio thread can tell when the history is ready.
+    mpData = data;
+    return true;
+  }
+
+  void LoopHistory::deallocate()
+  {
+    mpData = 0;
+    mOpen = false;
+    if (mpMemory)
+    {
+      MemoryTracker::freed(MEMORY_OTHER, mMemorySize);
+      BigHeap::free(mpMemory);
+      mpMemory = 0;
+      mMemorySize = 0;
+    }
+    mpSilence = 0;
+    mDataSize = 0;
+    mPoolSize = 0;
+    mSlotCount = 0;
+    mFreeCount = 0;
+    mSlots.clear();
+    mPrevious.clear();
+    mOwner.clear();
+    mFree.clear();
+    mSnapshot.clear();
+    mPinnedPages.clear();
+    mDeferred.clear();
+    mDeferredCount = 0;
+    mPinned = false;
+    mEntries.clear();
+    mEntryHead = 0;
+    mEntryCount = 0;
+    mTakeHead = 0;
+    mApplied = 0;
+    mUndone = 0;
+    mPending = false;
+  }
+
+  void LoopHistory::clear()
+  {
+    mFreeCount = 0;
+    mDeferredCount = 0;
+    for (int i = 0; i < mPoolSize; i++)
+    {
+      releasePage((float *)mpMemory + i * mPageSize);
+    }
+
+    if (mCopyOnWrite)
+    {
+      for (int i = 0; i < mSlotCount; i++)
+      {
+        mSlots[i] = mpSilence;
+      }
+    }
+
+    for (int i = 0; i < mSlotCount; i++)
+    {
+      mPrevious[i] = 0;
+    }
+
+    mEntryHead = 0;
+    mEntryCount = 0;
+    mTakeHead = 0;
+    mApplied = 0;
+    mUndone = 0;
+    mOpen = false;
+    mLost = false;
+    mPending = false;
+  }
+
+  int LoopHistory::slotSize(int slot)
+  {
+    if (mCopyOnWrite || slot < mSlotCount - 1)
+    {
+      return mPageSize;
+    }
+    return mDataSize - slot * mPageSize;
+  }
+
+  float *LoopHistory::popPage()
+  {
+    if (mFreeCount == 0)
+    {
+      return 0;
+    }
+    return mFree[--mFreeCount];
+  }
+
+  void LoopHistory::releasePage(float *page)
+  {
+    if (page == mpSilence)
+    {
+      return;
+    }
+
+    if (isPinnedPage(page))
+    {
+      mDeferred[mDeferredCount++] = page;
+    }
+    else
+    {
+      mFree[mFreeCount++] = page;
+    }
+  }
+
+  void LoopHistory::releaseTake(Take &take)
+  {
+    for (int i = 0; i < take.count; i++)
+    {
+      releasePage(entryAt(take.first + i).page);
+    }
+  }
+
+  void LoopHistory::evictOldest()
+  {
+    Take &take = takeAt(0);
+    releaseTake(take);
+    mEntryHead = (mEntryHead + take.count) % mEntries.size();
+    mEntryCount -= take.count;
+    mTakeHead = (mTakeHead + 1) % maximumTakes;
+    mApplied--;
+  }
+
+  void LoopHistory::forgetCurrent()
+  {
+    // Only called when the current take is the only one left.
+    releaseTake(takeAt(0));
+    mEntryHead = 0;
+    mEntryCount = 0;
+    mTakeHead = 0;
+    mApplied = 0;
+    mLost = true;
+  }
+
+  void LoopHistory::beginTake()
+  {
+    if (mpMemory == 0)
+    {
+      return;
+    }
+
+    finishPending();
+
+    // Starting over from an undone state discards the redo takes.
+    while (mUndone > 0)
+    {
+      Take &take = takeAt(mApplied + mUndone - 1);
+      releaseTake(take);
+      mEntryCount -= take.count;
+      mUndone--;
+    }
+
+    if (mApplied == maximumTakes)
+    {
+      evictOldest();
+    }
+
+    Take &take = takeAt(mApplied);
+    take.first = mEntryHead + mEntryCount;
+    take.count = 0;
+    mApplied++;
+    mSerial++;
+    mOpen = true;
+    mLost = false;
+  }
+
+  void LoopHistory::beginRecording()
+  {
+    if (mpMemory == 0)
+    {
+      return;
+    }
+
+    finishPending();
+    mSerial++;
+    mOpen = true;
+    // Written in place: only slots that are still silent take a page.
+    mLost = true;
+  }
+
+  void LoopHistory::endTake()
+  {
+    mOpen = false;
+  }
+
+  float *LoopHistory::protectSlow(int slot)
+  {
+    if (!mOpen)
+    {
+      return 0;
+    }
+
+    float *current = mSlots[slot];
+
+    if (!mLost)
+    {
+      // Older takes give way to the current one.
+      while ((mFreeCount == 0 || mEntryCount == (int)mEntries.size()) && mApplied > 1)
+      {
+        evictOldest();
+      }
+
+      if (mFreeCount == 0 || mEntryCount == (int)mEntries.size())
+      {
+        forgetCurrent();
+      }
+      else
+      {
+        float *page = popPage();
+        memcpy(page, current, sizeof(float) * slotSize(slot));
+        Entry &entry = entryAt(mEntryHead + mEntryCount);
+        entry.slot = slot;
+        if (mCopyOnWrite)
+        {
+          entry.page = current;
+          mSlots[slot] = page;
+        }
+        else
+        {
+          entry.page = page;
+        }
+        mEntryCount++;
+        takeAt(mApplied - 1).count++;
+        mOwner[slot] = mSerial;
+        return mSlots[slot];
+      }
+    }
+
+    // Writing in place.  A silent or pinned slot still needs a page of its
+    // own.
+    if (current == mpSilence || isPinnedPage(current))
+    {
+      float *page = popPage();
+      if (page == 0)
+      {
+        return 0;
+      }
+      if (current == mpSilence)
+      {
+        memset(page, 0, sizeof(float) * mPageSize);
+      }
+      else
+      {
+        memcpy(page, current, sizeof(float) * mPageSize);
+        releasePage(current);
+      }
+      mSlots[slot] = page;
+    }
+    mOwner[slot] = mSerial;
+    return mSlots[slot];
+  }
+
+  void LoopHistory::apply(int k, bool undo)
+  {
+    Take &take = takeAt(k);
+    if (mCopyOnWrite)
+    {
+      for (int i = 0; i < mSlotCount; i++)
+      {
+        mPrevious[i] = 0;
+      }
+
+      // A slot appears more than once in a take if it was copied again for a
+      // snapshot, so the order matters.
+      for (int j = 0; j < take.count; j++)
+      {
+        int i = undo ? take.count - 1 - j : j;
+        Entry &entry = entryAt(take.first + i);
+        float *page = mSlots[entry.slot];
+        mSlots[entry.slot] = entry.page;
+        if (mPrevious[entry.slot] == 0)
+        {
+          mPrevious[entry.slot] = page;
+        }
+        entry.page = page;
+      }
+    }
+    else
+    {
+      mPending = true;
+      mPendingTake = k;
+      mPendingNext = 0;
+    }
+  }
+
+  bool LoopHistory::undo()
+  {
+    if (mPending || mApplied == 0)
+    {
+      return false;
+    }
+    mOpen = false;
+    mApplied--;
+    mUndone++;
+    apply(mApplied, true);
+    return true;
+  }
+
+  bool LoopHistory::redo()
+  {
+    if (mPending || mUndone == 0)
+    {
+      return false;
+    }
+    mOpen = false;
+    apply(mApplied, false);
+    mApplied++;
+    mUndone--;
+    return true;
+  }
+
+  bool LoopHistory::pin()
+  {
+    if (!mCopyOnWrite || mpMemory == 0 || mPinned)
+    {
+      return false;
+    }
+
+    for (int i = 0; i < mSlotCount; i++)
+    {
+      float *page = mSlots[i];
+      mSnapshot[i] = page;
+      if (page != mpSilence)
+      {
+        mPinnedPages[pageIndex(page)] = 1;
+      }
+    }
+    mPinned = true;
+    // Pages already written in this take must be copied again.
+    mSerial++;
+    return true;
+  }
+
+  void LoopHistory::unpin()
+  {
+    if (!mPinned)
+    {
+      return;
+    }
+
+    mPinned = false;
+    for (int i = 0; i < mPoolSize; i++)
+    {
+      mPinnedPages[i] = 0;
+    }
+    while (mDeferredCount > 0)
+    {
+      mFree[mFreeCount++] = mDeferred[--mDeferredCount];
+    }
+  }
+
+  bool LoopHistory::progress(int maxPages)
+  {
+    if (!mPending)
+    {
+      return false;
+    }
+
+    Take &take = takeAt(mPendingTake);
+    while (maxPages > 0 && mPendingNext < take.count)
+    {
+      Entry &entry = entryAt(take.first + mPendingNext);
+      float *a = mSlots[entry.slot];
+      float *b = entry.page;
+      int n = slotSize(entry.slot);
+      for (int i = 0; i < n; i++)
+      {
+        float tmp = a[i];
+        a[i] = b[i];
+        b[i] = tmp;
+      }
+      mPendingNext++;
+      maxPages--;
+    }
+
+    mPending = mPendingNext < take.count;
+    return mPending;
+  }
+
+  void LoopHistory::finishPending()
+  {
+    while (progress(mSlotCount))
+    {
+    }
+  }
+
+} /* namespace od */
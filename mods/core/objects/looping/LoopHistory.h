@@ -0,0 +1,236 @@
+#pragma once
+
+#include <stdint.h>
+#include <vector>
+
+namespace od
+{
+
+  // Page-based undo/redo history for loop memory.
+  //
+  // The loop is divided into fixed-size slots.  Before a slot is written for
+  // the first time during a take, protect() preserves its contents in a page
+  // from a pool that is preallocated from the BigHeap, so the audio thread
+  // never allocates.  Only the slots that a take actually touches cost memory.
+  //
+  // There are two modes:
+  //
+  // Copy-on-write (allocate with a slot count): the history owns the loop
+  // memory.  Every slot points at a page (or a shared silent page) and
+  // protect() hands the writer a fresh copy, keeping the old page in the
+  // journal.  Undo and redo just swap page pointers.
+  //
+  // Journal (allocate with external memory, e.g. a Sample buffer): slots
+  // point into that memory and protect() copies the old contents out.  Undo
+  // and redo swap contents, a few pages at a time from progress().
+  //
+  // When the pool runs dry the oldest takes are forgotten.  If the current
+  // take alone does not fit, it is written in place and cannot be undone.
+  //
+  // Copy-on-write mode can also pin a snapshot of the loop: the pages that
+  // make it up are not written or recycled until it is unpinned, so another
+  // thread can read them while the loop carries on.
+  class LoopHistory
+  {
+  public:
+    LoopHistory();
+    ~LoopHistory();
+
+    // Do not call these from the audio thread.
+    bool allocate(int slotCount, int pageSize, int poolSize);
+    bool allocate(float *data, int size, int pageSize, int poolSize);
+    void deallocate();
+
+    // Forget all takes.  In copy-on-write mode the loop becomes silent.
+    void clear();
+
+    // Start journaling a new take.  Any undone takes are discarded.
+    void beginTake();
+    // Start the first take over a cleared loop.  It is not journaled, so it
+    // cannot be undone and costs only the pages that it fills.
+    void beginRecording();
+    void endTake();
+
+    // Returns the memory of a slot, preserving it first if this is the first
+    // write to it in the current take.  Returns 0 if no take is open.
+    inline float *protect(int slot)
+    {
+      if (mOwner[slot] == mSerial && mOpen)
+      {
+        return mSlots[slot];
+      }
+      return protectSlow(slot);
+    }
+
+    inline float *get(int slot)
+    {
+      return mSlots[slot];
+    }
+
+    // Copy-on-write only: the page that was playing in this slot before the
+    // last undo or redo, for crossfading.  Returns 0 if it did not change.
+    inline float *getPrevious(int slot)
+    {
+      return mPrevious[slot];
+    }
+
+    bool undo();
+    bool redo();
+
+    // Copy-on-write only, audio thread.  Freezes the pages of the loop as it
+    // is now.  Later writes go to copies.
+    bool pin();
+    void unpin();
+    bool isPinned()
+    {
+      return mPinned;
+    }
+
+    // Any thread, while pinned.
+    inline float *getSnapshot(int slot)
+    {
+      return mSnapshot[slot];
+    }
+
+    // Journal only: swaps up to maxPages pages of a pending undo or redo.
+    // Returns true while there is still work to do.
+    bool progress(int maxPages);
+
+    bool isAllocated()
+    {
+      return mpMemory != 0;
+    }
+
+    bool isOpen()
+    {
+      return mOpen;
+    }
+
+    bool isPending()
+    {
+      return mPending;
+    }
+
+    // Journal only: the memory that is being tracked.
+    float *getData()
+    {
+      return mpData;
+    }
+
+    int getSlotCount()
+    {
+      return mSlotCount;
+    }
+
+    int getPageSize()
+    {
+      return mPageSize;
+    }
+
+    int getUndoCount()
+    {
+      return mApplied;
+    }
+
+    int getRedoCount()
+    {
+      return mUndone;
+    }
+
+    int getFreePageCount()
+    {
+      return mFreeCount;
+    }
+
+    static const int maximumTakes = 32;
+
+  private:
+    struct Entry
+    {
+      int slot;
+      // Copy-on-write: the other version of the slot.
+      // Journal: the preserved contents of the slot.
+      float *page;
+    };
+
+    struct Take
+    {
+      int first;
+      int count;
+    };
+
+    char *mpMemory = 0;
+    int mMemorySize = 0;
+    float *mpSilence = 0;
+    float *mpData = 0;
+    int mDataSize = 0;
+    bool mCopyOnWrite = true;
+    int mPageSize = 0;
+    int mPoolSize = 0;
+
+    int mSlotCount = 0;
+    std::vector<float *> mSlots;
+    std::vector<float *> mPrevious;
+    // Serial number of the take that last preserved each slot.
+    std::vector<uint32_t> mOwner;
+
+    std::vector<float *> mFree;
+    int mFreeCount = 0;
+
+    // Pages of the pinned snapshot, flagged by pool index.  Those that are
+    // released while pinned wait in mDeferred.
+    std::vector<float *> mSnapshot;
+    std::vector<uint8_t> mPinnedPages;
+    std::vector<float *> mDeferred;
+    int mDeferredCount = 0;
+    bool mPinned = false;
+
+    std::vector<Entry> mEntries;
+    int mEntryHead = 0;
+    int mEntryCount = 0;
+
+    // Takes are kept in order, oldest first: mApplied takes that can be
+    // undone followed by mUndone takes that can be redone.
+    Take mTakes[maximumTakes];
+    int mTakeHead = 0;
+    int mApplied = 0;
+    int mUndone = 0;
+
+    uint32_t mSerial = 0;
+    bool mOpen = false;
+    // The current take did not fit in the pool and is written in place.
+    bool mLost = false;
+
+    bool mPending = false;
+    int mPendingTake = 0;
+    int mPendingNext = 0;
+
+    bool allocatePool(int pageCount);
+    float *protectSlow(int slot);
+    int slotSize(int slot);
+    Take &takeAt(int k)
+    {
+      return mTakes[(mTakeHead + k) % maximumTakes];
+    }
+    Entry &entryAt(int i)
+    {
+      return mEntries[i % mEntries.size()];
+    }
+    float *popPage();
+    int pageIndex(float *page)
+    {
+      return (page - (float *)mpMemory) / mPageSize;
+    }
+    bool isPinnedPage(float *page)
+    {
+      return mPinned && page != mpSilence && mPinnedPages[pageIndex(page)];
+    }
+    void releasePage(float *page);
+    void releaseTake(Take &take);
+    void evictOldest();
+    void forgetCurrent();
+    void apply(int k, bool undo);
+    void finishPending();
+  };
+
+} /* namespace od */
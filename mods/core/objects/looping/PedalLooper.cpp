@@ -1,18 +1,19 @@
 #include <core/objects/looping/PedalLooper.h>
 #include <hal/simd.h>
-#include <od/extras/BigHeap.h>
+#include <hal/ops.h>
 #include <od/AudioThread.h>
 #include <od/UIThread.h>
 #include <od/config.h>
 
-#define COMMIT_CHUNKSIZE_FRAMES 16
+// Samples per channel in each page of loop memory.
+#define PAGE_SIZE_SAMPLES 4096
 
 namespace od
 {
 
-  PedalLooper::PedalLooper(int channelCount) : mChannelCount(channelCount), mRequest(this)
+  PedalLooper::PedalLooper(int channelCount) : mChannelCount(channelCount), mCapture(this)
   {
-    own(mRequest);
+    own(mCapture);
 
     addOutput(mLeftOutput);
     addOutput(mRightOutput);
@@ -21,6 +22,7 @@ namespace od
     addInput(mRecord);
     addInput(mStop);
     addInput(mUndo);
+    addInput(mRedo);
     addParameter(mFeedback);
     addOption(mAfterRecord);
     addOption(mPassInput);
@@ -45,7 +47,13 @@ namespace od
     mUndoState.add("----", 0);
     mUndoState.add("undo", 0);
     mUndoState.setCurrentState(0);
-    mUndoState.setNextState(1);
+    mUndoState.setNextState(0);
+
+    addStateMachine(mRedoState);
+    mRedoState.add("----", 0);
+    mRedoState.add("redo", 0);
+    mRedoState.setCurrentState(0);
+    mRedoState.setNextState(0);
 
     mPlayLevel.setLength(5);
     mRecordLevel.setLength(5);
@@ -54,7 +62,7 @@ namespace od
     setRecordLevel(0);
     setPlayLevel(0);
     setFeedbackLevel(1);
-    mUndoLevel.conditionalReset(0);
+    mUndoLevel.set(1);
   }
 
   PedalLooper::~PedalLooper()
@@ -62,90 +70,59 @@ namespace od
     deallocate();
   }
 
-  bool PedalLooper::allocate(int Ns)
+  bool PedalLooper::allocate(int Nf, float history)
   {
     deallocate();
-    int nbytes = Ns * sizeof(float);
-
-    mpLeftBufferA = BigHeap::allocateZeroed(nbytes);
-    if (mpLeftBufferA == 0)
-    {
-      return false;
-    }
-
-    if (mChannelCount > 1)
-    {
-      mpRightBufferA = BigHeap::allocateZeroed(nbytes);
-      if (mpRightBufferA == 0)
-      {
-        deallocate();
-        return false;
-      }
-    }
-
-    mpLeftBufferB = BigHeap::allocateZeroed(nbytes);
-    if (mpLeftBufferB == 0)
-    {
-      deallocate();
-      return false;
-    }
-
-    if (mChannelCount > 1)
-    {
-      mpRightBufferB = BigHeap::allocateZeroed(nbytes);
-      if (mpRightBufferB == 0)
-      {
-        deallocate();
-        return false;
-      }
-    }
-
-    return true;
+    mFramesPerPage = MAX(1, PAGE_SIZE_SAMPLES / FRAMELENGTH);
+    int slotCount = (Nf + mFramesPerPage - 1) / mFramesPerPage;
+    // The recording fills at most slotCount pages.  The rest of the pool
+    // keeps overdubbed pages for undo, and the oldest takes are forgotten
+    // when it runs out.
+    int poolSize = slotCount + (int)(slotCount * history);
+    int pageSize = mChannelCount * mFramesPerPage * FRAMELENGTH;
+    return mHistory.allocate(slotCount, pageSize, poolSize);
   }
 
   void PedalLooper::deallocate()
   {
-    if (mpLeftBufferA)
-    {
-      BigHeap::free(mpLeftBufferA);
-      mpLeftBufferA = 0;
-    }
+    mMaximumFrameCount = 0;
 
-    if (mpRightBufferA)
+    // Let a capture in progress finish with the pages it has pinned.
+    int state = captureRequested;
+    if (mCaptureState.compare_exchange_strong(state, captureIdle))
     {
-      BigHeap::free(mpRightBufferA);
-      mpRightBufferA = 0;
+      mpCaptureSample->release();
+      mpCaptureSample = 0;
     }
-
-    if (mpLeftBufferB)
+    else if (state != captureIdle)
     {
-      BigHeap::free(mpLeftBufferB);
-      mpLeftBufferB = 0;
+      mCapture.wait();
+      mCaptureState = captureIdle;
     }
 
-    if (mpRightBufferB)
-    {
-      BigHeap::free(mpRightBufferB);
-      mpRightBufferB = 0;
-    }
+    mHistory.deallocate();
   }
 
-  float PedalLooper::allocateTimeUpTo(float seconds)
+  float PedalLooper::allocateTimeUpTo(float seconds, float history)
   {
     int Ns = globalConfig.sampleRate * MAX(0.001f, seconds);
     int Nf = (Ns / FRAMELENGTH + 1);
-    if (Nf == mMaximumFrameCount)
+    history = MAX(0.0f, history);
+    if (Nf == mMaximumFrameCount && history == mHistoryFraction)
     {
       // Already allocated.
       return Nf * globalConfig.framePeriod;
     }
 
+    // Bypass while the memory is replaced.
     mMaximumFrameCount = 0;
+    mHistoryFraction = history;
 
     while (Nf > 1)
     {
-      if (allocate(Nf * FRAMELENGTH))
+      if (allocate(Nf, history))
       {
+        enterEmptyState();
         mMaximumFrameCount = Nf;
         return Nf * globalConfig.framePeriod;
       }
@@ -168,11 +145,10 @@ namespace od
     mRecordState.setNextState(recordState);
     mStopState.setCurrentState(0);
     mStopState.setNextState(1);
-    leaveUndoState();
-    mUndoState.setStateName(0, "----");
+    mHistory.clear();
+    mUndoLevel.set(1);
     mCurrentTake = 0;
-    mUndoState.setStateValue(0, 0);
-    mUndoState.setStateValue(1, 0);
+    updateUndoState();
   }
 
   void PedalLooper::leaveEmptyState()
@@ -189,17 +165,17 @@ namespace od
     mRecordState.setNextState(playState);
     mStopState.setCurrentState(0);
     mStopState.setNextState(1);
-    leaveUndoState();
+    // The recording itself is not an undo level.
+    mUndoLevel.set(1);
+    mHistory.beginRecording();
     mCurrentTake = 1;
-    mUndoState.setStateValue(1, 0);
-    mUndoState.setStateValue(0, 1);
+    updateUndoState();
   }
 
   void PedalLooper::leaveRecordState()
   {
     mFrameCount = mCurrentFrame;
     mCurrentFrame = 0;
-    mUndoState.setStateName(0, "redo");
   }
 
   void PedalLooper::enterPlayState()
@@ -212,7 +188,6 @@ namespace od
     mRecordState.setNextState(overdubState);
     mStopState.setCurrentState(0);
     mStopState.setNextState(1);
-    leaveUndoState();
   }
 
   void PedalLooper::leavePlayState()
@@ -222,19 +197,7 @@ namespace od
   void PedalLooper::enterOverdubState()
   {
     mState = overdubState;
-
-    if (mUndoState.mCurrentIndex == 1)
-    {
-      mBufferSwap = !mBufferSwap;
-      leaveUndoState();
-    }
-    else
-    {
-      mCurrentTake++;
-      mUndoState.setStateValue(1, mCurrentTake - 1);
-      mUndoState.setStateValue(0, mCurrentTake);
-    }
-
+    beginTake();
     setRecordLevel(1);
     setPlayLevel(1);
     setFeedbackLevel(mFeedback.value());
@@ -242,7 +205,6 @@ namespace od
     mRecordState.setNextState(playState);
     mStopState.setCurrentState(0);
     mStopState.setNextState(1);
-    commit();
   }
 
   void PedalLooper::leaveOverdubState()
@@ -274,9 +236,12 @@ namespace od
       return;
     }
 
+    serviceCapture();
+
     bool record = simd_any_positive(mRecord.buffer(), FRAMELENGTH);
     bool stop = simd_any_positive(mStop.buffer(), FRAMELENGTH);
     bool undo = simd_any_positive(mUndo.buffer(), FRAMELENGTH);
+    bool redo = simd_any_positive(mRedo.buffer(), FRAMELENGTH);
 
     // Determine next state
     mPrevState = mState;
@@ -315,14 +280,11 @@ namespace od
     case playState:
       if (undo)
       {
-        if (mUndoState.mCurrentIndex)
-        {
-          leaveUndoState();
-        }
-        else
-        {
-          enterUndoState();
-        }
+        this->undo();
+      }
+      else if (redo)
+      {
+        this->redo();
       }
       if (stop)
       {
@@ -348,20 +310,17 @@ namespace od
       }
       if (undo)
       {
-        enterUndoState();
+        this->undo();
       }
       break;
     case stopState:
       if (undo)
       {
-        if (mUndoState.mCurrentIndex)
-        {
-          leaveUndoState();
-        }
-        else
-        {
-          enterUndoState();
-        }
+        this->undo();
+      }
+      else if (redo)
+      {
+        this->redo();
       }
       if (record)
       {
@@ -382,13 +341,39 @@ namespace od
       setFeedbackLevel(mFeedback.value());
     }
 
+    // Each frame lies within a single page.
+    int slot = mCurrentFrame / mFramesPerPage;
+    int offset = (mCurrentFrame % mFramesPerPage) * FRAMELENGTH;
+    bool writing = isWriting();
+    float *buffer = 0;
+    if (writing)
+    {
+      buffer = mHistory.protect(slot);
+    }
+    if (buffer == 0)
+    {
+      writing = false;
+      buffer = mHistory.get(slot);
+    }
+
+    // Crossfade from the page that was playing before an undo or redo.
+    float *previous = 0;
+    if (mUndoLevel.notFinished())
+    {
+      previous = mHistory.getPrevious(slot);
+    }
+    if (previous == 0)
+    {
+      previous = buffer;
+    }
+
     if (mChannelCount > 1)
     {
-      stereo();
+      stereo(buffer + offset, previous + offset, writing);
     }
     else
     {
-      mono();
+      mono(buffer + offset, previous + offset, writing);
     }
 
     switch (mState)
@@ -431,89 +416,6 @@ namespace od
     mUndoLevel.step();
   }
 
-  static void circularCopyFrames(float *dst, float *src, int len, int start, int n)
-  {
-    while (n > 0)
-    {
-      int j = start * FRAMELENGTH;
-      memcpy(dst + j, src + j, sizeof(float) * FRAMELENGTH);
-      start++;
-      if (start == len)
-      {
-        start = 0;
-      }
-      n--;
-    }
-  }
-
-  void PedalLooper::commit()
-  {
-    // First commit up to COMMIT_CHUNKSIZE_FRAMES in the audio thread.
-
-    mCommitRemaining = mFrameCount;
-    mCommitStart = mCurrentFrame;
-
-    int n = MIN(COMMIT_CHUNKSIZE_FRAMES, mCommitRemaining);
-    float *bufferL = getLeftMaster();
-    float *undoL = getLeftCopy();
-    circularCopyFrames(undoL, bufferL, mFrameCount, mCommitStart, n);
-    if (mChannelCount > 1)
-    {
-      float *bufferR = getRightMaster();
-      float *undoR = getRightCopy();
-      circularCopyFrames(undoR, bufferR, mFrameCount, mCommitStart, n);
-    }
-
-    mCommitRemaining -= n;
-    mCommitStart += n;
-    if (mCommitStart > mFrameCount)
-    {
-      mCommitStart -= mFrameCount;
-    }
-
-    // Schedule the remaining frames in another thread.
-    scheduleCommit();
-  }
-
-  // do not call in the audio thread
-  void PedalLooper::commitRemaining()
-  {
-    if (mFrameCount == 0)
-    {
-      return;
-    }
-
-    while (mCommitRemaining > 0)
-    {
-      int n = MIN(COMMIT_CHUNKSIZE_FRAMES, mCommitRemaining);
-      float *bufferL = getLeftMaster();
-      float *undoL = getLeftCopy();
-      circularCopyFrames(undoL, bufferL, mFrameCount, mCommitStart, n);
-      if (mChannelCount > 1)
-      {
-        float *bufferR = getRightMaster();
-        float *undoR = getRightCopy();
-        circularCopyFrames(undoR, bufferR, mFrameCount, mCommitStart, n);
-      }
-
-      mCommitRemaining -= n;
-      mCommitStart += n;
-      if (mCommitStart > mFrameCount)
-      {
-        mCommitStart -= mFrameCount;
-      }
-    }
-  }
-
-  void PedalLooper::scheduleCommit()
-  {
-    if (!mRequest.pending())
-    {
-      JobQueue *jobQueue = UIThread::getRealtimeJobQueue();
-      jobQueue->push(&mRequest);
-    }
-  }
-
   void PedalLooper::setPlayLevel(float level)
   {
     mPlayLevel.conditionalReset(level);
@@ -545,100 +447,63 @@ namespace od
     }
   }
 
-  void PedalLooper::enterUndoState()
+  void PedalLooper::beginTake()
   {
-    mUndoLevel.conditionalReset(1);
-    mUndoState.setCurrentState(1);
-    mUndoState.setNextState(0);
+    // Pages that are still fading out may be recycled by the new take.
+    mUndoLevel.set(1);
+    mHistory.beginTake();
+    mCurrentTake++;
+    updateUndoState();
   }
 
-  void PedalLooper::leaveUndoState()
+  void PedalLooper::undo()
   {
-    mUndoLevel.conditionalReset(0);
-    mUndoState.setCurrentState(0);
-    mUndoState.setNextState(1);
-  }
-
-  float *PedalLooper::getLeftMaster()
-  {
-    if (mBufferSwap)
-    {
-      return (float *)mpLeftBufferB;
-    }
-    else
+    if (mHistory.undo())
     {
-      return (float *)mpLeftBufferA;
+      mCurrentTake--;
+      mUndoLevel.reset(0, 1);
+      updateUndoState();
     }
   }
 
-  float *PedalLooper::getRightMaster()
+  void PedalLooper::redo()
   {
-    if (mBufferSwap)
+    if (mHistory.redo())
     {
-      return (float *)mpRightBufferB;
-    }
-    else
-    {
-      return (float *)mpRightBufferA;
+      mCurrentTake++;
+      mUndoLevel.reset(0, 1);
+      updateUndoState();
     }
   }
 
-  float *PedalLooper::getLeftCopy()
+  void PedalLooper::updateUndoState()
   {
-    if (mBufferSwap)
-    {
-      return (float *)mpLeftBufferA;
-    }
-    else
-    {
-      return (float *)mpLeftBufferB;
-    }
-  }
+    // The label shows the next state, so keep both on the same index.
+    int undoIndex = mHistory.getUndoCount() > 0 ? 1 : 0;
+    mUndoState.setStateValue(0, mCurrentTake);
+    mUndoState.setStateValue(1, mCurrentTake);
+    mUndoState.setCurrentState(undoIndex);
+    mUndoState.setNextState(undoIndex);
 
-  float *PedalLooper::getRightCopy()
-  {
-    if (mBufferSwap)
-    {
-      return (float *)mpRightBufferA;
-    }
-    else
-    {
-      return (float *)mpRightBufferB;
-    }
+    int redoIndex = mHistory.getRedoCount() > 0 ? 1 : 0;
+    mRedoState.setStateValue(0, mCurrentTake);
+    mRedoState.setStateValue(1, mCurrentTake + 1);
+    mRedoState.setCurrentState(redoIndex);
+    mRedoState.setNextState(redoIndex);
   }
 
-  float *PedalLooper::getLeftPlaying()
+  bool PedalLooper::isWriting()
   {
-    if (mUndoState.mCurrentIndex == 0)
-    {
-      return getLeftMaster();
-    }
-    else
-    {
-      return getLeftCopy();
-    }
+    // Playback alone leaves the loop memory untouched.
+    return mHistory.isOpen() &&
+           (mRecordLevel.mValue > 0.0f || mRecordLevel.notFinished() ||
+            mFeedbackLevel.mValue != 1.0f || mFeedbackLevel.notFinished());
   }
 
-  float *PedalLooper::getRightPlaying()
-  {
-    if (mUndoState.mCurrentIndex == 0)
-    {
-      return getRightMaster();
-    }
-    else
-    {
-      return getRightCopy();
-    }
-  }
-
-  void PedalLooper::mono()
+  void PedalLooper::mono(float *bufferL, float *previousL, bool writing)
   {
     float *inL = mLeftInput.buffer();
     float *outL = mLeftOutput.buffer();
-    float *bufferL = getLeftMaster();
-    bufferL += mCurrentFrame * FRAMELENGTH;
-    float *undoL = getLeftCopy();
-    undoL += mCurrentFrame * FRAMELENGTH;
 
     float pass;
     if (mPassInput.getFlag(mState))
@@ -659,11 +524,22 @@ namespace od
     mFeedbackLevel.getInterpolatedFrame(fdbkLevel);
     mUndoLevel.getInterpolatedFrame(undoLevel);
 
-    for (int i = 0; i < FRAMELENGTH; i++)
+    if (writing)
     {
-      float x = (1 - undoLevel[i]) * bufferL[i] + undoLevel[i] * undoL[i];
-      outL[i] = playLevel[i] * x + pass * inL[i];
-      bufferL[i] = fdbkLevel[i] * x + recLevel[i] * inL[i];
+      for (int i = 0; i < FRAMELENGTH; i++)
+      {
+        float x = (1 - undoLevel[i]) * previousL[i] + undoLevel[i] * bufferL[i];
+        outL[i] = playLevel[i] * x + pass * inL[i];
+        bufferL[i] = fdbkLevel[i] * x + recLevel[i] * inL[i];
+      }
+    }
+    else
+    {
+      for (int i = 0; i < FRAMELENGTH; i++)
+      {
+        float x = (1 - undoLevel[i]) * previousL[i] + undoLevel[i] * bufferL[i];
+        outL[i] = playLevel[i] * x + pass * inL[i];
+      }
     }
 
     AudioThread::releaseFrame(playLevel);
@@ -672,7 +548,7 @@ namespace od
     AudioThread::releaseFrame(undoLevel);
   }
 
-  void PedalLooper::stereo()
+  void PedalLooper::stereo(float *bufferL, float *previousL, bool writing)
   {
     float *inL = mLeftInput.buffer();
     float *inR = mRightInput.buffer();
@@ -680,15 +556,10 @@ namespace od
     float *outL = mLeftOutput.buffer();
     float *outR = mRightOutput.buffer();
 
-    float *bufferL = getLeftMaster();
-    bufferL += mCurrentFrame * FRAMELENGTH;
-    float *bufferR = getRightMaster();
-    bufferR += mCurrentFrame * FRAMELENGTH;
-
-    float *undoL = getLeftCopy();
-    undoL += mCurrentFrame * FRAMELENGTH;
-    float *undoR = getRightCopy();
-    undoR += mCurrentFrame * FRAMELENGTH;
+    // The right channel follows the left one in each page.
+    int stride = mFramesPerPage * FRAMELENGTH;
+    float *bufferR = bufferL + stride;
+    float *previousR = previousL + stride;
 
     float pass;
     if (mPassInput.getFlag(mState))
@@ -709,15 +580,29 @@ namespace od
     mFeedbackLevel.getInterpolatedFrame(fdbkLevel);
     mUndoLevel.getInterpolatedFrame(undoLevel);
 
-    for (int i = 0; i < FRAMELENGTH; i++)
+    if (writing)
+    {
+      for (int i = 0; i < FRAMELENGTH; i++)
+      {
+        float x = (1 - undoLevel[i]) * previousL[i] + undoLevel[i] * bufferL[i];
+        outL[i] = playLevel[i] * x + pass * inL[i];
+        bufferL[i] = fdbkLevel[i] * x + recLevel[i] * inL[i];
+
+        x = (1 - undoLevel[i]) * previousR[i] + undoLevel[i] * bufferR[i];
+        outR[i] = playLevel[i] * x + pass * inR[i];
+        bufferR[i] = fdbkLevel[i] * x + recLevel[i] * inR[i];
+      }
+    }
+    else
     {
-      float x = (1 - undoLevel[i]) * bufferL[i] + undoLevel[i] * undoL[i];
-      outL[i] = playLevel[i] * x + pass * inL[i];
-      bufferL[i] = fdbkLevel[i] * x + recLevel[i] * inL[i];
+      for (int i = 0; i < FRAMELENGTH; i++)
+      {
+        float x = (1 - undoLevel[i]) * previousL[i] + undoLevel[i] * bufferL[i];
+        outL[i] = playLevel[i] * x + pass * inL[i];
 
-      x = (1 - undoLevel[i]) * bufferR[i] + undoLevel[i] * undoR[i];
-      outR[i] = playLevel[i] * x + pass * inR[i];
-      bufferR[i] = fdbkLevel[i] * x + recLevel[i] * inR[i];
+        x = (1 - undoLevel[i]) * previousR[i] + undoLevel[i] * bufferR[i];
+        outR[i] = playLevel[i] * x + pass * inR[i];
+      }
     }
 
     AudioThread::releaseFrame(playLevel);
@@ -726,9 +611,42 @@ namespace od
     AudioThread::releaseFrame(undoLevel);
   }
 
+  void PedalLooper::copyFrames(Sample *sample, int Ns, bool snapshot)
+  {
+    int stride = mFramesPerPage * FRAMELENGTH;
+    float *out = sample->mpData;
+    for (int frame = 0, i = 0; i < Ns; frame++)
+    {
+      int slot = frame / mFramesPerPage;
+      float *bufferL = snapshot ? mHistory.getSnapshot(slot) : mHistory.get(slot);
+      bufferL += (frame % mFramesPerPage) * FRAMELENGTH;
+      // Stereo samples of a mono loop get the same audio on both sides.
+      float *bufferR = mChannelCount > 1 ? bufferL + stride : bufferL;
+      int n = MIN(FRAMELENGTH, Ns - i);
+
+      if (sample->mChannelCount == 1)
+      {
+        // Sample is mono.  Just copy the left channel.
+        memcpy(out + i, bufferL, sizeof(float) * n);
+      }
+      else
+      {
+        for (int j = 0; j < n; j++)
+        {
+          out[2 * (i + j)] = bufferL[j];
+          out[2 * (i + j) + 1] = bufferR[j];
+        }
+      }
+      i += n;
+    }
+
+    sample->mDirty = true;
+    sample->alterWaterMark();
+  }
+
   int PedalLooper::fillSample(Sample *sample)
   {
-    if (sample == 0)
+    if (sample == 0 || !mHistory.isAllocated())
     {
       return 0;
     }
@@ -740,45 +658,79 @@ namespace od
       return 0;
     }
 
-    if (sample->mChannelCount == 1)
+    copyFrames(sample, Ns, false);
+    return Ns;
+  }
+
+  int PedalLooper::captureToSample(Sample *sample)
+  {
+    if (mCaptureState != captureIdle)
     {
-      // Sample is mono.  Just copy the left channel.
-      memcpy(sample->mpData, getLeftPlaying(), sizeof(float) * Ns);
+      return -1;
     }
-    else if (mChannelCount == 2)
+
+    if (sample == 0 || !mHistory.isAllocated())
     {
-      // Sample and loop buffer are stereo.
-      float *bufferL = getLeftPlaying();
-      float *bufferR = getRightPlaying();
-      float *out = sample->mpData;
-      if (sample->mChannelCount == 2)
-      {
-        for (int i = 0; i < Ns; i++)
-        {
-          out[2 * i] = bufferL[i];
-          out[2 * i + 1] = bufferR[i];
-        }
-      }
+      return 0;
     }
-    else
+
+    int Ns = MIN((int)sample->mSampleCount, mFrameCount * FRAMELENGTH);
+
+    if (Ns == 0)
     {
-      // Sample is stereo but loop buffer is mono.
-      float *bufferL = getLeftPlaying();
-      float *out = sample->mpData;
-      if (sample->mChannelCount == 2)
-      {
-        for (int i = 0; i < Ns; i++)
-        {
-          out[2 * i] = bufferL[i];
-          out[2 * i + 1] = bufferL[i];
-        }
-      }
+      return 0;
     }
 
-    sample->mDirty = true;
-    sample->alterWaterMark();
-
+    sample->attach();
+    mpCaptureSample = sample;
+    mCaptureSucceeded = false;
+    mCaptureState = captureRequested;
     return Ns;
   }
 
+  void PedalLooper::serviceCapture()
+  {
+    int state = mCaptureState;
+    if (state == captureFinished)
+    {
+      mHistory.unpin();
+      mCaptureState = captureIdle;
+      return;
+    }
+
+    if (state != captureRequested ||
+        !mCaptureState.compare_exchange_strong(state, captureCopying))
+    {
+      return;
+    }
+
+    // The loop may have changed since the request.
+    int Ns = MIN((int)mpCaptureSample->mSampleCount, mFrameCount * FRAMELENGTH);
+    if (Ns > 0 && mHistory.pin())
+    {
+      mCaptureSampleCount = Ns;
+      JobQueue *jobQueue = UIThread::getRealtimeJobQueue();
+      jobQueue->push(&mCapture);
+    }
+    else
+    {
+      mpCaptureSample->release();
+      mpCaptureSample = 0;
+      mCaptureState = captureIdle;
+    }
+  }
+
+  // do not call in the audio thread
+  void PedalLooper::copySnapshot()
+  {
+    if (mpCaptureSample)
+    {
+      copyFrames(mpCaptureSample, mCaptureSampleCount, true);
+      mpCaptureSample->release();
+      mpCaptureSample = 0;
+      mCaptureSucceeded = true;
+    }
+    mCaptureState = captureFinished;
+  }
+
 } /* namespace od */
@@ -2,8 +2,10 @@
 
 #include <od/objects/Object.h>
 #include <od/extras/LinearRamp.h>
-#include <od/ui/JobQueue.h>
 #include <od/audio/Sample.h>
+#include <od/ui/JobQueue.h>
+#include <core/objects/looping/LoopHistory.h>
+#include <atomic>
 #include <od/config.h>
 
 namespace od
@@ -16,7 +18,9 @@ namespace od
     virtual ~PedalLooper();
 
     // returns actual time allocated
-    float allocateTimeUpTo(float seconds);
+    // Undo memory is extra pages worth this fraction of the loop.  An
+    // overdub that touches more of the loop than that cannot be undone.
+    float allocateTimeUpTo(float seconds, float history = 0.5f);
     void deallocate();
     float maximumLoopTime()
     {
@@ -26,6 +30,22 @@ namespace od
     // Returns the number of samples copied.
     int fillSample(Sample *sample);
 
+    // Copies the loop into the sample in the background without stopping it.
+    // Returns the number of samples that will be copied, 0 if there is
+    // nothing to copy, or -1 if a copy is already in progress.  Poll
+    // isCapturing() to find out when it is done, then captureSucceeded().
+    int captureToSample(Sample *sample);
+    bool isCapturing()
+    {
+      return mCaptureState != captureIdle;
+    }
+    // Did the last capture copy the loop?  False when it was aborted (e.g.
+    // the loop was cleared or its pages could not be pinned).
+    bool captureSucceeded()
+    {
+      return mCaptureSucceeded;
+    }
+
     int getLoopLengthInSamples()
     {
       return mFrameCount * FRAMELENGTH;
@@ -36,6 +56,16 @@ namespace od
       return mFrameCount * globalConfig.framePeriod;
     }
 
+    int getUndoCount()
+    {
+      return mHistory.getUndoCount();
+    }
+
+    int getRedoCount()
+    {
+      return mHistory.getRedoCount();
+    }
+
 #ifndef SWIGLUA
     virtual void process();
     Inlet mLeftInput{"Left In"};
@@ -45,23 +75,25 @@ namespace od
     Inlet mRecord{"Record"};
     Inlet mStop{"Stop"};
     Inlet mUndo{"Undo"};
+    Inlet mRedo{"Redo"};
     Parameter mFeedback{"Feedback", 1.0f};
     StateMachine mRecordState{"Record"};
     StateMachine mStopState{"Stop"};
     StateMachine mUndoState{"Undo"};
+    StateMachine mRedoState{"Redo"};
     Option mAfterRecord{"After Record", 0};   // 0 - play, 1 - overdub, 2 - stop
     Option mPassInput{"Pass Input", 0b11111}; // same order as LooperState
 #endif
 
   protected:
-    char *mpLeftBufferA = 0;
-    char *mpRightBufferA = 0;
-    char *mpLeftBufferB = 0;
-    char *mpRightBufferB = 0;
+    // Loop memory, paged so that overdubs only preserve what they touch.
+    LoopHistory mHistory;
+    int mFramesPerPage = 1;
     int mChannelCount;
     int mCurrentFrame = 0;
     int mFrameCount = 0;
     int mMaximumFrameCount = 0;
+    float mHistoryFraction = 0.0f;
     int mCurrentTake = 0;
 
     enum LooperState
@@ -84,16 +116,11 @@ namespace od
     void setRecordLevel(float level);
     void setFeedbackLevel(float level);
 
-    void enterUndoState();
-    void leaveUndoState();
-
-    bool mBufferSwap = false;
-    float *getLeftMaster();
-    float *getRightMaster();
-    float *getLeftCopy();
-    float *getRightCopy();
-    float *getLeftPlaying();
-    float *getRightPlaying();
+    void beginTake();
+    void undo();
+    void redo();
+    void updateUndoState();
+    bool isWriting();
 
     void enterEmptyState();
     void leaveEmptyState();
@@ -110,14 +137,14 @@ namespace od
     void enterStopState();
     void leaveStopState();
 
-    void mono();
-    void stereo();
+    void mono(float *buffer, float *previous, bool writing);
+    void stereo(float *buffer, float *previous, bool writing);
     void bypass();
 
-    class Request : public Job
+    class Capture : public Job
     {
     public:
-      Request(PedalLooper *looper) : mpLooper(looper)
+      Capture(PedalLooper *looper) : mpLooper(looper)
       {
       }
 
@@ -125,21 +152,36 @@ namespace od
 
       virtual void work()
       {
-        mpLooper->commitRemaining();
+        mpLooper->copySnapshot();
+      }
+      virtual const char *getTraceName()
+      {
+        return "PedalLooper::capture";
       }
     };
 
-    Request mRequest;
+    enum CaptureState
+    {
+      captureIdle,
+      // Waiting for the audio thread to pin the pages.
+      captureRequested,
+      captureCopying,
+      // Waiting for the audio thread to unpin the pages.
+      captureFinished
+    };
 
-    void scheduleCommit();
+    Capture mCapture;
+    std::atomic<int> mCaptureState{captureIdle};
+    Sample *mpCaptureSample = 0;
+    int mCaptureSampleCount = 0;
+    std::atomic<bool> mCaptureSucceeded{false};
 
-    int mCommitStart = 0;
-    int mCommitRemaining = 0;
-    void commit();
+    void serviceCapture();
     // do not call in the audio thread
-    void commitRemaining();
+    void copySnapshot();
+    void copyFrames(Sample *sample, int Ns, bool snapshot);
 
-    bool allocate(int Ns);
+    bool allocate(int Nf, float history);
   };
 
 } /* namespace od */
@@ -29,7 +29,7 @@ namespace od
     float *sync = mSync.buffer();
     float *freq = mFundamental.buffer();
     // Some constants in SIMD vector form.
-    float32x4_t glog2 = vdupq_n_f32(FULLSCALE_IN_VOLTS * logf(2.0f));
+    float32x4_t vpo = vdupq_n_f32(FULLSCALE_IN_VOLTS);
     float32x4_t two = vdupq_n_f32(2.0f);
     float32x4_t one = vdupq_n_f32(1.0f);
     float32x4_t zero = vdupq_n_f32(0.0f);
@@ -51,7 +51,7 @@ namespace od
       q = vminq_f32(one, q);
       q = vmaxq_f32(negOne, q);
       // Scale the linear frequency by the V/oct input
-      q = dP * simd_exp(q * glog2);
+      q = dP * simd_exp2(q * vpo);
 
       // Accumulate phase while handling sync
       float tmp[4];
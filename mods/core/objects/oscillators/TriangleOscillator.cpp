@@ -35,7 +35,7 @@ namespace od
     float *out = mOutput.buffer();
     float *sync = mSync.buffer();
     float *freq = mFundamental.buffer();
-    float32x4_t glog2 = vdupq_n_f32(FULLSCALE_IN_VOLTS * logf(2.0f));
+    float32x4_t vpo = vdupq_n_f32(FULLSCALE_IN_VOLTS);
     float32x4_t two = vdupq_n_f32(2.0f);
     float32x4_t one = vdupq_n_f32(1.0f);
     float32x4_t zero = vdupq_n_f32(0.0f);
@@ -50,7 +50,7 @@ namespace od
       float32x4_t dP = sr * vld1q_f32(freq + i);
       q = vminq_f32(one, q);
       q = vmaxq_f32(negOne, q);
-      q = dP * simd_exp(q * glog2);
+      q = dP * simd_exp2(q * vpo);
 
       // accumulate phase while handling sync
       float tmp[4];
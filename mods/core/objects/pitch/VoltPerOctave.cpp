@@ -42,13 +42,13 @@ namespace od
       float *out = mOutput.buffer();
 
       // cost: 45 cycles/sample
-      float32x4_t glog2 = vdupq_n_f32(FULLSCALE_IN_VOLTS) * simd_log(vdupq_n_f32(2.0f));
+      float32x4_t vpo = vdupq_n_f32(FULLSCALE_IN_VOLTS);
       float32x4_t one = vdupq_n_f32(1.0f);
       float32x4_t negOne = vdupq_n_f32(-1.0f);
       float32x4_t q = vld1q_f32(in);
       q = vminq_f32(one, q);
       q = vmaxq_f32(negOne, q);
-      q = simd_exp(q * glog2);
+      q = simd_exp2(q * vpo);
 
       for (int i = 0; i < FRAMELENGTH; i += 4)
       {
@@ -86,7 +86,7 @@ namespace od
 
 #if USE_INTRINSICS
       // cost: 45 cycles/sample
-      float32x4_t glog2 = vdupq_n_f32(FULLSCALE_IN_VOLTS) * simd_log(vdupq_n_f32(2.0f));
+      float32x4_t vpo = vdupq_n_f32(FULLSCALE_IN_VOLTS);
       float32x4_t one = vdupq_n_f32(1.0f);
       float32x4_t negOne = vdupq_n_f32(-1.0f);
 
@@ -95,7 +95,7 @@ namespace od
         float32x4_t q = vld1q_f32(in + i);
         q = vminq_f32(one, q);
         q = vmaxq_f32(negOne, q);
-        q = simd_exp(q * glog2);
+        q = simd_exp2(q * vpo);
         vst1q_f32(out + i, q);
       }
 #endif
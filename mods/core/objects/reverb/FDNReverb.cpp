@@ -0,0 +1,198 @@
+#include <core/objects/reverb/FDNReverb.h>
+#include <od/AudioThread.h>
+#include <od/config.h>
+#include <hal/ops.h>
+#include <math.h>
+#include <string.h>
+
+namespace od
+{
+
+  // Delay lengths (in samples at 48kHz), chosen to be mutually prime.
+  static const int lineTuning[FDNREVERB_LINES] = {
+      1123, 1277, 1429, 1571, 1733, 1907, 2069, 2237};
+
+  static const float scaledamp = 0.4f;
+  static const float inputgain = 0.5f;
+  static const float outputgain = 0.5f;
+
+  // 4-point Hadamard transform within a vector.
+  static inline float32x4_t hadamard4(float32x4_t x, float32x4_t s0,
+                                      float32x4_t s1)
+  {
+    // (x0+x1, x0-x1, x2+x3, x2-x3)
+    x = vmlaq_f32(vrev64q_f32(x), x, s0);
+    // (y0+y2, y1+y3, y0-y2, y1-y3)
+    float32x4_t h = vcombine_f32(vget_high_f32(x), vget_low_f32(x));
+    return vmlaq_f32(h, x, s1);
+  }
+
+  FDNReverb::FDNReverb()
+  {
+    addInput(mLeftInput);
+    addInput(mRightInput);
+    addOutput(mLeftOutput);
+    addOutput(mRightOutput);
+    addParameter(mSize);
+    addParameter(mDamp);
+    addParameter(mWidth);
+
+    float scale = globalConfig.sampleRate / 48000.0f;
+    int total = 0;
+    for (int i = 0; i < FDNREVERB_LINES; i++)
+    {
+      mOffset[i] = total;
+      mLength[i] = MAX(FRAMELENGTH, (int)(lineTuning[i] * scale));
+      mIndex[i] = 0;
+      total += mLength[i];
+    }
+    mMemory.resize(total);
+    mute();
+  }
+
+  FDNReverb::~FDNReverb()
+  {
+  }
+
+  void FDNReverb::mute()
+  {
+    std::fill(mMemory.begin(), mMemory.end(), 0.0f);
+    mLowA = vdupq_n_f32(0.0f);
+    mLowB = vdupq_n_f32(0.0f);
+  }
+
+  // Copy out the frame that is about to be overwritten, in at most 2 pieces.
+  void FDNReverb::readLine(int line, float *out)
+  {
+    float *buffer = mMemory.data() + mOffset[line];
+    int index = mIndex[line];
+    int n = MIN(FRAMELENGTH, mLength[line] - index);
+    memcpy(out, buffer + index, n * sizeof(float));
+    memcpy(out + n, buffer, (FRAMELENGTH - n) * sizeof(float));
+  }
+
+  void FDNReverb::writeLine(int line, const float *in)
+  {
+    float *buffer = mMemory.data() + mOffset[line];
+    int index = mIndex[line];
+    int n = MIN(FRAMELENGTH, mLength[line] - index);
+    memcpy(buffer + index, in, n * sizeof(float));
+    memcpy(buffer, in + n, (FRAMELENGTH - n) * sizeof(float));
+    index += FRAMELENGTH;
+    if (index >= mLength[line])
+    {
+      index -= mLength[line];
+    }
+    mIndex[line] = index;
+  }
+
+  void FDNReverb::process()
+  {
+    float *leftIn = mLeftInput.buffer();
+    float *rightIn = mRightInput.buffer();
+    float *leftOut = mLeftOutput.buffer();
+    float *rightOut = mRightOutput.buffer();
+    float size = CLAMP(0, 1, mSize.value());
+    float damp = CLAMP(0, 1, mDamp.value());
+    float width = CLAMP(0, 1, mWidth.value());
+
+    // Per-line feedback gain for the requested decay time (RT60).
+    float rt60 = 0.2f + 9.8f * size * size;
+    float G[FDNREVERB_LINES];
+    for (int i = 0; i < FDNREVERB_LINES; i++)
+    {
+      G[i] = powf(10.0f, -3.0f * mLength[i] * globalConfig.samplePeriod / rt60);
+    }
+    // 1/sqrt(8) makes the 8-point Hadamard matrix orthonormal.
+    float32x4_t norm = vdupq_n_f32(0.35355339059f);
+    float32x4_t gA = vmulq_f32(norm, vld1q_f32(G));
+    float32x4_t gB = vmulq_f32(norm, vld1q_f32(G + 4));
+
+    float32x4_t d = vdupq_n_f32(damp * scaledamp);
+
+    float wet1 = outputgain * (0.5f + 0.5f * width);
+    float wet2 = outputgain * (0.5f - 0.5f * width);
+    const float signs[4] = {1.0f, -1.0f, 1.0f, -1.0f};
+    float32x4_t alt = vld1q_f32(signs);
+    float32x4_t cL0 = vmulq_n_f32(alt, wet1);
+    float32x4_t cL1 = vmulq_n_f32(alt, wet2);
+    float32x4_t cR0 = cL1;
+    float32x4_t cR1 = cL0;
+
+    float32x4_t s0 = alt;
+    const float halves[4] = {1.0f, 1.0f, -1.0f, -1.0f};
+    float32x4_t s1 = vld1q_f32(halves);
+    float32x4_t gin = vdupq_n_f32(inputgain);
+
+    float32x4_t lowA = mLowA;
+    float32x4_t lowB = mLowB;
+
+    // Delayed samples, one frame per line. Overwritten in place with the
+    // samples to write back.
+    float *line[FDNREVERB_LINES];
+    for (int i = 0; i < FDNREVERB_LINES; i++)
+    {
+      line[i] = AudioThread::getFrame();
+      readLine(i, line[i]);
+    }
+
+    // Rows are indexed by line before the transpose and by time after it.
+    float32x4_t A[4], B[4], L[4], R[4];
+
+    for (int i = 0; i < FRAMELENGTH; i += 4)
+    {
+      for (int j = 0; j < 4; j++)
+      {
+        A[j] = vld1q_f32(line[j] + i);
+        B[j] = vld1q_f32(line[j + 4] + i);
+      }
+      simd_transpose4x4(A);
+      simd_transpose4x4(B);
+
+      for (int t = 0; t < 4; t++)
+      {
+        // damping: low = y + d * (low - y)
+        lowA = vmlaq_f32(A[t], d, vsubq_f32(lowA, A[t]));
+        lowB = vmlaq_f32(B[t], d, vsubq_f32(lowB, B[t]));
+
+        // stereo taps
+        L[t] = vmlaq_f32(vmulq_f32(lowA, cL0), lowB, cL1);
+        R[t] = vmlaq_f32(vmulq_f32(lowA, cR0), lowB, cR1);
+
+        // 8-point Hadamard: [H4 H4; H4 -H4]
+        float32x4_t ha = hadamard4(lowA, s0, s1);
+        float32x4_t hb = hadamard4(lowB, s0, s1);
+        float32x4_t fa = vmulq_f32(gA, vaddq_f32(ha, hb));
+        float32x4_t fb = vmulq_f32(gB, vsubq_f32(ha, hb));
+
+        // inject left into lines 0-3 and right into lines 4-7
+        A[t] = vmlaq_f32(fa, gin, vld1q_dup_f32(leftIn + i + t));
+        B[t] = vmlaq_f32(fb, gin, vld1q_dup_f32(rightIn + i + t));
+      }
+
+      simd_transpose4x4(A);
+      simd_transpose4x4(B);
+      for (int j = 0; j < 4; j++)
+      {
+        vst1q_f32(line[j] + i, A[j]);
+        vst1q_f32(line[j + 4] + i, B[j]);
+      }
+
+      // Sum the taps across lines.
+      simd_transpose4x4(L);
+      simd_transpose4x4(R);
+      vst1q_f32(leftOut + i, vaddq_f32(vaddq_f32(L[0], L[1]), vaddq_f32(L[2], L[3])));
+      vst1q_f32(rightOut + i, vaddq_f32(vaddq_f32(R[0], R[1]), vaddq_f32(R[2], R[3])));
+    }
+
+    for (int i = 0; i < FDNREVERB_LINES; i++)
+    {
+      writeLine(i, line[i]);
+      AudioThread::releaseFrame(line[i]);
+    }
+
+    mLowA = lowA;
+    mLowB = lowB;
+  }
+
+} /* namespace od */
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <od/objects/Object.h>
+#include <hal/simd.h>
+#include <vector>
+
+#define FDNREVERB_LINES 8
+
+namespace od
+{
+
+  // 8-line feedback delay network with Hadamard mixing.
+  // All delay lines share one contiguous memory block and are read and
+  // written a whole frame at a time (every line is longer than a frame).
+  class FDNReverb : public Object
+  {
+  public:
+    FDNReverb();
+    virtual ~FDNReverb();
+
+#ifndef SWIGLUA
+    virtual void process();
+    Inlet mLeftInput{"Left In"};
+    Inlet mRightInput{"Right In"};
+    Outlet mLeftOutput{"Left Out"};
+    Outlet mRightOutput{"Right Out"};
+    Parameter mSize{"Size", 0.5f};
+    Parameter mDamp{"Damp", 0.5f};
+    Parameter mWidth{"Width", 1.0f};
+#endif
+
+    void mute();
+
+  private:
+    std::vector<float> mMemory;
+    int mOffset[FDNREVERB_LINES];
+    int mLength[FDNREVERB_LINES];
+    int mIndex[FDNREVERB_LINES];
+
+    // damping filter state (lines 0-3 and 4-7)
+    float32x4_t mLowA, mLowB;
+
+    void readLine(int line, float *out);
+    void writeLine(int line, const float *in);
+  };
+
+} /* namespace od */
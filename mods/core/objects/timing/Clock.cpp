@@ -1,4 +1,8 @@
 #include <core/objects/timing/Clock.h>
+#include <od/objects/TriggerScanner.h>
+#include <od/AudioThread.h>
+#include <hal/simd.h>
+#include <math.h>
 
 namespace od
 {
@@ -11,6 +15,7 @@ namespace od
         addParameter(mMultiplier);
         addParameter(mPulseWidth);
         addOption(mRational);
+        addOption(mTransport);
     }
 
     Clock::~Clock()
@@ -20,54 +25,113 @@ namespace od
     void Clock::process()
     {
         float *out = mOutput.buffer();
-        float *sync = mSync.buffer();
 
-        float periodInSeconds = getPeriod();
+        float beatInSeconds = getPeriod();
+        float ratio;
         if (mRational.value())
         {
-            periodInSeconds *= MAX(1, mDivider.roundTarget());
-            periodInSeconds /= MAX(1, mMultiplier.roundTarget());
+            ratio = MAX(1, mDivider.roundTarget());
+            ratio /= MAX(1, mMultiplier.roundTarget());
         }
         else
         {
-            periodInSeconds *= MAX(1, mDivider.value());
-            periodInSeconds /= MAX(1, mMultiplier.value());
+            ratio = MAX(1, mDivider.value());
+            ratio /= MAX(1, mMultiplier.value());
         }
 
+        switch (mTransport.value())
+        {
+        case CLOCK_TRANSPORT_LEAD:
+        {
+            TransportTask *transport = AudioThread::getTransportTask();
+            transport->setTempo(60.0f / beatInSeconds);
+            transport->start();
+            if (TriggerScanner(mSync).any())
+            {
+                transport->reset();
+            }
+            followTransport(ratio);
+            return;
+        }
+        case CLOCK_TRANSPORT_FOLLOW:
+            followTransport(ratio);
+            return;
+        }
+
+        float periodInSeconds = beatInSeconds * ratio;
+
         uint32_t period = periodInSeconds * globalConfig.sampleRate;
         uint32_t high = (periodInSeconds * mPulseWidth.value()) * globalConfig.sampleRate;
 
-        for (int i = 0; i < FRAMELENGTH; i++)
+        // The output only changes at a sync or at the end of a phase, so run
+        // from one to the next instead of stepping every sample.
+        TriggerScanner syncs(mSync);
+        int s = syncs.next();
+        int i = 0;
+
+        while (i < FRAMELENGTH)
         {
-            if (sync[i] > 0.0f)
+            if (i == s)
             {
                 mCurrentValue = 1.0f;
                 mState = 1;
                 mPhase = 0;
+                s = syncs.next();
             }
 
-            out[i] = mCurrentValue;
+            // Samples up to and including the one that ends this phase.
+            uint32_t target = mState ? high : period;
+            uint32_t m = (mPhase < target ? target - mPhase : 0) + 1;
+            int n = MIN(m, (uint32_t)(s - i));
+
+            for (int j = 0; j < n; j++)
+            {
+                out[i + j] = mCurrentValue;
+            }
+            i += n;
 
-            switch (mState)
+            if ((uint32_t)n < m)
             {
-            case 0:
-                if (mPhase >= period)
-                {
-                    mCurrentValue = 1.0f;
-                    mState = 1;
-                    mPhase = 0;
-                }
-                break;
-            case 1:
-                if (mPhase >= high)
-                {
-                    mCurrentValue = 0.0f;
-                    mState = 0;
-                }
-                break;
+                mPhase += n;
             }
+            else if (mState == 0)
+            {
+                mCurrentValue = 1.0f;
+                mState = 1;
+                mPhase = 1;
+            }
+            else
+            {
+                mCurrentValue = 0.0f;
+                mState = 0;
+                mPhase += n;
+            }
+        }
+    }
+
+    void Clock::followTransport(float ratio)
+    {
+        // High for the first part (pulse width) of each period.  Periods are
+        // counted from the transport's first beat rather than from each bar,
+        // so they stay even when the divider does not divide the bar.
+        TransportTask *transport = AudioThread::getTransportTask();
+        double start = transport->getFramePosition() / ratio;
+        float *out = mOutput.buffer();
+        const float offsets[4] = {0.0f, 1.0f, 2.0f, 3.0f};
+        float32x4_t index = vld1q_f32(offsets);
+        float32x4_t four = vdupq_n_f32(4.0f);
+        float32x4_t base = vdupq_n_f32(start - floor(start));
+        float32x4_t step = vdupq_n_f32(transport->getBeatsPerSample() / ratio);
+        float32x4_t width = vdupq_n_f32(mPulseWidth.value());
+        uint32x4_t one = vreinterpretq_u32_f32(vdupq_n_f32(1.0f));
 
-            mPhase++;
+        for (int i = 0; i < FRAMELENGTH; i += 4)
+        {
+            float32x4_t x = vaddq_f32(base, vmulq_f32(index, step));
+            index = vaddq_f32(index, four);
+            x = vsubq_f32(x, vcvtq_f32_s32(vcvtq_s32_f32(x)));
+            uint32x4_t high = vcltq_f32(x, width);
+            vst1q_f32(out + i, vreinterpretq_f32_u32(vandq_u32(high, one)));
         }
     }
 
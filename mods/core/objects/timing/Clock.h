@@ -4,6 +4,14 @@
 #include <od/config.h>
 #include <hal/ops.h>
 
+// Transport choices
+#define CLOCK_TRANSPORT_OFF 1
+// Pulse on the transport's beats (times the multiplier over the divider).
+#define CLOCK_TRANSPORT_FOLLOW 2
+// As FOLLOW, but also set the transport tempo from this clock's period and
+// restart the transport on sync.
+#define CLOCK_TRANSPORT_LEAD 3
+
 namespace od
 {
 
@@ -21,6 +29,7 @@ namespace od
     Parameter mMultiplier{"Multiplier", 1};
     Parameter mPulseWidth{"Pulse Width", 0.5};
     Option mRational{"Rational", 1};
+    Option mTransport{"Transport", CLOCK_TRANSPORT_OFF};
 #endif
 
   protected:
@@ -29,6 +38,9 @@ namespace od
     int mState = 0;
 
     virtual float getPeriod() = 0;
+
+  private:
+    void followTransport(float ratio);
   };
 
   class ClockInSeconds : public Clock
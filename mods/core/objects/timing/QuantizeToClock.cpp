@@ -7,10 +7,9 @@
 
 #include <core/objects/timing/QuantizeToClock.h>
 #include <od/config.h>
+#include <od/AudioThread.h>
 #include <hal/simd.h>
 
-#define LOCAL_NEON_ENABLE 1
-
 namespace od
 {
 
@@ -19,90 +18,77 @@ namespace od
     addInput(mInput);
     addInput(mClock);
     addOutput(mOutput);
+    addOption(mClockSource);
   }
 
   QuantizeToClock::~QuantizeToClock()
   {
   }
 
-#if LOCAL_NEON_ENABLE
-  // 8k cycles
+  // Offset of the next sample (from i) where a gate crosses 0.5, or
+  // FRAMELENGTH.
+  static inline int nextEdge(float *x, int i, bool high)
+  {
+    if (high)
+    {
+      return i + simd_first_less_or_equal(x + i, FRAMELENGTH - i, 0.5f);
+    }
+    else
+    {
+      return i + simd_first_greater(x + i, FRAMELENGTH - i, 0.5f);
+    }
+  }
+
   void QuantizeToClock::process()
   {
     float *in = mInput.buffer();
     float *clock = mClock.buffer();
     float *out = mOutput.buffer();
-    float32x4_t thresh = vdupq_n_f32(0.5f);
 
-    for (int i = 0; i < FRAMELENGTH; i += 4)
+    if (mClockSource.value() == QUANTIZETOCLOCK_TRANSPORT_BEATS)
     {
-      float32x4_t x = vld1q_f32(in + i);
-      float32x4_t c = vld1q_f32(clock + i);
-      uint32_t xHi[4], cHi[4];
-      vst1q_u32(xHi, vcgtq_f32(x, thresh));
-      vst1q_u32(cHi, vcgtq_f32(c, thresh));
+      clock = AudioThread::getTransportTask()->mBeat.buffer();
+    }
 
-      for (int j = 0; j < 4; j++)
-      {
-        if (!mInputState && xHi[j])
-        {
-          mGotRisingEdge = true;
-          mInputState = true;
-        }
+    // Visit the edges of both inputs in order (input first when they
+    // coincide).  The output only changes on clock edges.
+    int a = nextEdge(in, 0, mInputState);
+    int c = nextEdge(clock, 0, mClockState);
+    int i = 0;
 
-        if (mInputState && !xHi[j])
+    while (a < FRAMELENGTH || c < FRAMELENGTH)
+    {
+      if (a <= c)
+      {
+        if (mInputState)
         {
           mGotFallingEdge = true;
           mInputState = false;
         }
-
-        if (!mClockState && cHi[j])
-        {
-          mClockState = true;
-          if (mGotRisingEdge || mInputState)
-          {
-            mCurrentValue = 1.0f;
-            mGotRisingEdge = false;
-          }
-        }
-
-        if (mClockState && !cHi[j])
+        else
         {
-          mClockState = false;
-          if (mGotFallingEdge || !mInputState)
-          {
-            mCurrentValue = 0.0f;
-            mGotFallingEdge = false;
-          }
+          mGotRisingEdge = true;
+          mInputState = true;
         }
-
-        out[i + j] = mCurrentValue;
+        a = nextEdge(in, a + 1, mInputState);
+        continue;
       }
-    }
-  }
-#else
-  // 15k cycles
-  void QuantizeToClock::process()
-  {
-    float *in = mInput.buffer();
-    float *clock = mClock.buffer();
-    float *out = mOutput.buffer();
 
-    for (int i = 0; i < FRAMELENGTH; i++)
-    {
-      if (!mInputState && in[i] > 0.5f)
+      for (; i < c; i++)
       {
-        mGotRisingEdge = true;
-        mInputState = true;
+        out[i] = mCurrentValue;
       }
 
-      if (mInputState && in[i] < 0.5f)
+      if (mClockState)
       {
-        mGotFallingEdge = true;
-        mInputState = false;
+        mClockState = false;
+        if (mGotFallingEdge || !mInputState)
+        {
+          mCurrentValue = 0.0f;
+          mGotFallingEdge = false;
+        }
       }
-
-      if (!mClockState && clock[i] > 0.5f)
+      else
       {
         mClockState = true;
         if (mGotRisingEdge || mInputState)
@@ -111,21 +97,14 @@ namespace od
           mGotRisingEdge = false;
         }
       }
+      c = nextEdge(clock, c + 1, mClockState);
+    }
 
-      if (mClockState && clock[i] < 0.5f)
-      {
-        mClockState = false;
-        if (mGotFallingEdge || !mInputState)
-        {
-          mCurrentValue = 0.0f;
-          mGotFallingEdge = false;
-        }
-      }
-
+    for (; i < FRAMELENGTH; i++)
+    {
       out[i] = mCurrentValue;
     }
   }
-#endif
 
 } // namespace od
 /* namespace od */
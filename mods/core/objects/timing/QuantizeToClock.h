@@ -10,6 +10,10 @@
 
 #include <od/objects/Object.h>
 
+// Clock choices
+#define QUANTIZETOCLOCK_CLOCK_INPUT 1
+#define QUANTIZETOCLOCK_TRANSPORT_BEATS 2
+
 namespace od
 {
 
@@ -24,6 +28,7 @@ namespace od
     Inlet mInput{"In"};
     Inlet mClock{"Clock"};
     Outlet mOutput{"Out"};
+    Option mClockSource{"Clock Source", QUANTIZETOCLOCK_CLOCK_INPUT};
 #endif
 
   private:
@@ -9,8 +9,6 @@
 #include <hal/simd.h>
 #include <od/config.h>
 
-#define LOCAL_NEON_ENABLE 1
-
 namespace od
 {
 
@@ -29,51 +27,50 @@ namespace od
   {
   }
 
-#if LOCAL_NEON_ENABLE
   void TrackAndHold::process()
   {
     float value = mValue.value();
     float *in = mInput.buffer();
     float *track = mTrack.buffer();
     float *out = mOutput.buffer();
-    float32x4_t thresh = vdupq_n_f32(0.5f);
+    int i = 0;
 
     switch (mFlavor.value())
     {
     case TRACKNHOLD_CHOICE_HIGH:
-      for (int i = 0; i < FRAMELENGTH; i += 4)
+      // Alternate between holding until the next rising edge of the track
+      // signal and tracking until the next falling edge.
+      while (i < FRAMELENGTH)
       {
-        float32x4_t x = vld1q_f32(track + i);
-        uint32_t high[4];
-        vst1q_u32(high, vcgtq_f32(x, thresh));
-        for (int j = 0; j < 4; j++)
+        int j = i + simd_first_greater(track + i, FRAMELENGTH - i, 0.5f);
+        for (; i < j; i++)
+        {
+          out[i] = value;
+        }
+        j = i + simd_first_less_or_equal(track + i, FRAMELENGTH - i, 0.5f);
+        for (; i < j; i++)
         {
-          if (high[j])
-          {
-            value = in[i + j];
-          }
-          out[i + j] = value;
+          out[i] = value = in[i];
         }
       }
       break;
     case TRACKNHOLD_CHOICE_LOW:
-      for (int i = 0; i < FRAMELENGTH; i += 4)
+      while (i < FRAMELENGTH)
       {
-        float32x4_t x = vld1q_f32(track + i);
-        uint32_t low[4];
-        vst1q_u32(low, vcltq_f32(x, thresh));
-        for (int j = 0; j < 4; j++)
+        int j = i + simd_first_less(track + i, FRAMELENGTH - i, 0.5f);
+        for (; i < j; i++)
+        {
+          out[i] = value;
+        }
+        j = i + simd_first_greater_or_equal(track + i, FRAMELENGTH - i, 0.5f);
+        for (; i < j; i++)
         {
-          if (low[j])
-          {
-            value = in[i + j];
-          }
-          out[i + j] = value;
+          out[i] = value = in[i];
         }
       }
       break;
     case TRACKNHOLD_CHOICE_MINMAX:
-      for (int i = 0; i < FRAMELENGTH; i++)
+      for (i = 0; i < FRAMELENGTH; i++)
       {
         if (track[i] < 0.5f && in[i] < value)
         {
@@ -90,51 +87,5 @@ namespace od
 
     mValue.hardSet(value);
   }
-#else
-  void TrackAndHold::process()
-  {
-    float *in = mInput.buffer();
-    float *track = mTrack.buffer();
-    float *out = mOutput.buffer();
-
-    switch (mFlavor.value())
-    {
-    case TRACKNHOLD_CHOICE_HIGH:
-      for (int i = 0; i < FRAMELENGTH; i++)
-      {
-        if (track[i] > 0.5f)
-        {
-          mValue = in[i];
-        }
-        out[i] = mValue;
-      }
-      break;
-    case TRACKNHOLD_CHOICE_LOW:
-      for (int i = 0; i < FRAMELENGTH; i++)
-      {
-        if (track[i] < 0.5f)
-        {
-          mValue = in[i];
-        }
-        out[i] = mValue;
-      }
-      break;
-    case TRACKNHOLD_CHOICE_MINMAX:
-      for (int i = 0; i < FRAMELENGTH; i++)
-      {
-        if (track[i] < 0.5f && in[i] < mValue)
-        {
-          mValue = in[i];
-        }
-        else if (track[i] > 0.5f && in[i] > mValue)
-        {
-          mValue = in[i];
-        }
-        out[i] = mValue;
-      }
-      break;
-    }
-  }
-#endif
 } // namespace od
 /* namespace od */
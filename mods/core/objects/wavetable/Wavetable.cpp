@@ -0,0 +1,160 @@
+#include <core/objects/wavetable/Wavetable.h>
+#include <od/extras/RealFFT.h>
+#include <hal/ops.h>
+#include <hal/log.h>
+#include <algorithm>
+
+namespace od
+{
+
+  // Non-owning. Wavetables remove themselves when they are deleted.
+  static std::vector<Wavetable *> cache;
+
+  Wavetable *Wavetable::get(Sample *sample, Slices *slices)
+  {
+    if (sample == 0 || sample->mSampleCount < 2)
+    {
+      return 0;
+    }
+
+    std::vector<int> intervals;
+    getIntervals(slices, intervals);
+
+    for (Wavetable *wt : cache)
+    {
+      if (wt->mpSample == sample && wt->mpSlices == slices &&
+          wt->mWaterMark == sample->mWaterMark && wt->mIntervals == intervals)
+      {
+        wt->attach();
+        return wt;
+      }
+    }
+
+    Wavetable *wt = new Wavetable(sample, slices);
+    wt->attach();
+    cache.push_back(wt);
+    return wt;
+  }
+
+  Wavetable::Wavetable(Sample *sample, Slices *slices) : mpSample(sample),
+                                                           mpSlices(slices)
+  {
+    mpSample->attach();
+    if (mpSlices)
+    {
+      mpSlices->attach();
+    }
+    mWaterMark = mpSample->mWaterMark;
+    getIntervals(mpSlices, mIntervals);
+    build();
+  }
+
+  Wavetable::~Wavetable()
+  {
+    cache.erase(std::remove(cache.begin(), cache.end(), this), cache.end());
+    mpSample->release();
+    if (mpSlices)
+    {
+      mpSlices->release();
+    }
+  }
+
+  void Wavetable::getIntervals(Slices *slices, std::vector<int> &intervals)
+  {
+    intervals.clear();
+    if (slices == 0)
+    {
+      return;
+    }
+
+    int n = MIN(WAVETABLE_MAX_FRAMES, slices->getIntervalCount());
+    for (int i = 0; i < n; i++)
+    {
+      intervals.push_back(slices->getIntervalStart(i));
+      intervals.push_back(slices->getIntervalLength(i));
+    }
+  }
+
+  // Resample one cycle (channel 0) to WAVETABLE_LENGTH points.
+  void Wavetable::resampleCycle(float *out, int start, int length)
+  {
+    int last = mpSample->mSampleCount - 1;
+    float step = (float)length / WAVETABLE_LENGTH;
+    for (int i = 0; i < WAVETABLE_LENGTH; i++)
+    {
+      float pos = i * step;
+      int j = (int)pos;
+      float w = pos - j;
+      int k0 = MIN(last, start + j);
+      // wrap around to the start of the cycle
+      int k1 = j + 1 < length ? MIN(last, start + j + 1) : start;
+      out[i] = (1.0f - w) * mpSample->get(k0, 0) + w * mpSample->get(k1, 0);
+    }
+  }
+
+  void Wavetable::build()
+  {
+    int intervalCount = mpSlices ? mpSlices->getIntervalCount() : 0;
+    mFrameCount = CLAMP(1, WAVETABLE_MAX_FRAMES, intervalCount);
+    if (intervalCount > WAVETABLE_MAX_FRAMES)
+    {
+      logWarn("Wavetable: using only the first %d of %d slices.",
+              WAVETABLE_MAX_FRAMES, intervalCount);
+    }
+
+    mTables.resize(mFrameCount * WAVETABLE_LEVELS * WAVETABLE_STRIDE);
+
+    int nbins = WAVETABLE_LENGTH / 2 + 1;
+    RealFFT fft(WAVETABLE_LENGTH);
+    RealBuffer cycle(WAVETABLE_LENGTH);
+    RealBuffer table(WAVETABLE_LENGTH);
+    ComplexBuffer spectrum(nbins);
+    ComplexBuffer filtered(nbins);
+
+    for (int frame = 0; frame < mFrameCount; frame++)
+    {
+      if (intervalCount == 0)
+      {
+        resampleCycle(cycle.data(), 0, mpSample->mSampleCount);
+      }
+      else
+      {
+        resampleCycle(cycle.data(), mpSlices->getIntervalStart(frame),
+                      MAX(2, mpSlices->getIntervalLength(frame)));
+      }
+
+      fft.compute(spectrum.data(), cycle.data());
+
+      for (int level = 0; level < WAVETABLE_LEVELS; level++)
+      {
+        // Brick-wall low-pass at the highest harmonic allowed in this octave.
+        int maxHarmonic = getMaxHarmonic(level);
+        for (int k = 0; k < nbins; k++)
+        {
+          if (k <= maxHarmonic)
+          {
+            filtered[k] = spectrum[k];
+          }
+          else
+          {
+            filtered[k].r = 0.0f;
+            filtered[k].i = 0.0f;
+          }
+        }
+        // The Nyquist bin is ambiguous when it is the last one kept.
+        if (maxHarmonic == WAVETABLE_LENGTH / 2)
+        {
+          filtered[maxHarmonic].r = 0.0f;
+          filtered[maxHarmonic].i = 0.0f;
+        }
+
+        fft.computeInverse(table.data(), filtered.data());
+
+        float *dst = getTable(frame, level);
+        std::copy(table.begin(), table.end(), dst);
+        dst[WAVETABLE_LENGTH] = dst[0];
+      }
+    }
+  }
+
+} /* namespace od */
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <od/extras/ReferenceCounted.h>
+#include <od/audio/Sample.h>
+#include <od/audio/Slices.h>
+#include <vector>
+
+// Length of one cycle in each table.
+#define WAVETABLE_LENGTH 1024
+// One band-limited table per octave.
+#define WAVETABLE_LEVELS 10
+// Each table has a guard point (equal to its first point) for interpolation.
+#define WAVETABLE_STRIDE (WAVETABLE_LENGTH + 1)
+#define WAVETABLE_MAX_FRAMES 64
+
+namespace od
+{
+
+  // Band-limited mip-maps (one table per octave) prepared from a sample.
+  // Each slice interval of the sample becomes one frame of the wavetable.
+  // Wavetables are shared by all oscillators playing the same sample.
+  class Wavetable : public ReferenceCounted
+  {
+  public:
+    // Returns an attached wavetable from the cache, building it if necessary.
+    // Call from the UI thread only.
+    static Wavetable *get(Sample *sample, Slices *slices);
+    virtual ~Wavetable();
+
+#ifndef SWIGLUA
+    int getFrameCount()
+    {
+      return mFrameCount;
+    }
+
+    // Highest harmonic present in the given level.
+    static int getMaxHarmonic(int level)
+    {
+      return (WAVETABLE_LENGTH / 2) >> level;
+    }
+
+    float *getTable(int frame, int level)
+    {
+      return mTables.data() + (frame * WAVETABLE_LEVELS + level) * WAVETABLE_STRIDE;
+    }
+
+    float *data()
+    {
+      return mTables.data();
+    }
+#endif
+
+  private:
+    Wavetable(Sample *sample, Slices *slices);
+
+    void build();
+    void resampleCycle(float *out, int start, int length);
+    static void getIntervals(Slices *slices, std::vector<int> &intervals);
+
+    Sample *mpSample;
+    Slices *mpSlices;
+    uint32_t mWaterMark;
+    // Start and length of each slice interval the frames were built from, so
+    // that edited slices get a new wavetable.
+    std::vector<int> mIntervals;
+    int mFrameCount = 0;
+    std::vector<float> mTables;
+  };
+
+} /* namespace od */
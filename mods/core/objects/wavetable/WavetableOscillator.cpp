@@ -0,0 +1,163 @@
+#include <core/objects/wavetable/WavetableOscillator.h>
+#include <hal/simd.h>
+#include <math.h>
+
+namespace od
+{
+
+  WavetableOscillator::WavetableOscillator()
+  {
+    addInput(mVoltPerOctave);
+    addInput(mSync);
+    addOutput(mOutput);
+    addInput(mFundamental);
+    addInput(mPhase);
+    addParameter(mInternalPhase);
+    mInternalPhase.enableSerialization();
+  }
+
+  WavetableOscillator::~WavetableOscillator()
+  {
+    if (mpWavetable)
+    {
+      mpWavetable->release();
+    }
+  }
+
+  void WavetableOscillator::setSample(Sample *sample, Slices *slices)
+  {
+    Wavetable *pWavetable = mpWavetable;
+    // Prevent audio code from accessing the current wavetable.
+    mpWavetable = 0;
+    if (pWavetable)
+    {
+      pWavetable->release();
+    }
+
+    Base::setSample(sample, slices);
+
+    // Allow audio code to access the new wavetable.
+    mpWavetable = Wavetable::get(sample, slices);
+  }
+
+  void WavetableOscillator::process()
+  {
+    Wavetable *pWavetable = mpWavetable;
+    float *out = mOutput.buffer();
+
+    if (pWavetable == 0)
+    {
+      simd_set(out, FRAMELENGTH, 0);
+      return;
+    }
+
+    float *octave = mVoltPerOctave.buffer();
+    float *sync = mSync.buffer();
+    float *freq = mFundamental.buffer();
+    float *phase = mPhase.buffer();
+    float *select = mSliceSelect.buffer();
+    float *tables = pWavetable->data();
+    float32x4_t vpo = vdupq_n_f32(FULLSCALE_IN_VOLTS);
+    float32x4_t one = vdupq_n_f32(1.0f);
+    float32x4_t half = vdupq_n_f32(0.5f);
+    float32x4_t oneEp = vdupq_n_f32(0.9999f);
+    float32x4_t zero = vdupq_n_f32(0.0f);
+    float32x4_t negOne = vdupq_n_f32(-1.0f);
+    float32x4_t sr = vdupq_n_f32(globalConfig.samplePeriod);
+    float32x4_t L = vdupq_n_f32(WAVETABLE_LENGTH);
+    float32x4_t M = vdupq_n_f32(pWavetable->getFrameCount() - 1);
+    int32x4_t lastFrame = vdupq_n_s32(pWavetable->getFrameCount() - 1);
+    int32x4_t frameStride = vdupq_n_s32(WAVETABLE_LEVELS * WAVETABLE_STRIDE);
+    int32x4_t levelStride = vdupq_n_s32(WAVETABLE_STRIDE);
+    int32x4_t minLevel = vdupq_n_s32(0);
+    int32x4_t maxLevel = vdupq_n_s32(WAVETABLE_LEVELS - 1);
+    int32x4_t exponentBias = vdupq_n_s32(126);
+    float internalPhase = mInternalPhase.value();
+    int32_t U[4], V[4];
+
+    // Algorithm Outline
+    // 1) Accumulate phase (as in SingleCycle).
+    // 2) Choose the octave level whose highest harmonic is below Nyquist.
+    // 3) Look up the two neighboring frames in that level.
+    // 4) Linear interpolation within each table, crossfade between frames.
+
+    for (int i = 0; i < FRAMELENGTH; i += 4)
+    {
+      // Calculate phase increment.
+      float32x4_t p = vld1q_f32(phase + i);
+      float32x4_t dP = sr * vld1q_f32(freq + i);
+      float32x4_t q = vld1q_f32(octave + i);
+      q = vminq_f32(one, q);
+      q = vmaxq_f32(negOne, q);
+      q = dP * simd_exp2(q * vpo);
+      float32x4_t dQ = vabsq_f32(q);
+
+      // Accumulate phase while handling sync.
+      float tmp[4];
+      uint32_t syncTrue[4];
+      float32x4_t s = vld1q_f32(sync + i);
+      vst1q_u32(syncTrue, vcgtq_f32(s, zero));
+      vst1q_f32(tmp, q);
+      for (int j = 0; j < 4; j++)
+      {
+        internalPhase += tmp[j];
+        if (syncTrue[j])
+        {
+          internalPhase = 0;
+        }
+        tmp[j] = internalPhase;
+      }
+      q = vld1q_f32(tmp) + p;
+
+      // Wrap to [0,1]
+      q = vsubq_f32(q, vcvtq_f32_s32(vcvtq_s32_f32(q)));
+      q += one;
+      q = vsubq_f32(q, vcvtq_f32_s32(vcvtq_s32_f32(q)));
+
+      // Level = ceil(log2(L * dQ)) read straight from the float exponent.
+      // Level k contains harmonics up to L/2^(k+1), so this keeps all of
+      // them below Nyquist.
+      int32x4_t level = vreinterpretq_s32_f32(vmaxq_f32(L * dQ, half));
+      level = vsubq_s32(vshrq_n_s32(level, 23), exponentBias);
+      level = vminq_s32(maxLevel, vmaxq_s32(minLevel, level));
+
+      // Frame selection and crossfade weights.
+      float32x4_t t = vld1q_f32(select + i);
+      t = vminq_f32(oneEp, t);
+      t = vmaxq_f32(zero, t);
+      float32x4_t m = t * M;
+      int32x4_t mI = vcvtq_s32_f32(m);
+      float32x4_t w1 = m - vcvtq_f32_s32(mI);
+      float32x4_t w0 = one - w1;
+      int32x4_t mJ = vminq_s32(lastFrame, vaddq_s32(mI, vdupq_n_s32(1)));
+
+      // Inter-sample weights (same for both frames).
+      float32x4_t pos = q * L;
+      int32x4_t posI = vcvtq_s32_f32(pos);
+      float32x4_t u1 = pos - vcvtq_f32_s32(posI);
+      float32x4_t u0 = one - u1;
+
+      int32x4_t base = vmlaq_s32(posI, level, levelStride);
+      vst1q_s32(U, vmlaq_s32(base, mI, frameStride));
+      vst1q_s32(V, vmlaq_s32(base, mJ, frameStride));
+
+      // Gather the 4 corners.
+      float S00[4], S01[4], S10[4], S11[4];
+      for (int j = 0; j < 4; j++)
+      {
+        S00[j] = tables[U[j]];
+        S01[j] = tables[U[j] + 1];
+        S10[j] = tables[V[j]];
+        S11[j] = tables[V[j] + 1];
+      }
+
+      float32x4_t s0 = u0 * vld1q_f32(S00) + u1 * vld1q_f32(S01);
+      float32x4_t s1 = u0 * vld1q_f32(S10) + u1 * vld1q_f32(S11);
+      vst1q_f32(out + i, w0 * s0 + w1 * s1);
+    }
+
+    internalPhase -= (int)internalPhase;
+    mInternalPhase.hardSet(internalPhase);
+  }
+
+} /* namespace od */
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <od/objects/heads/SliceHead.h>
+#include <core/objects/wavetable/Wavetable.h>
+
+namespace od
+{
+
+  // Drop-in replacement for SingleCycle that plays from band-limited tables.
+  class WavetableOscillator : public SliceHead
+  {
+  public:
+    WavetableOscillator();
+    virtual ~WavetableOscillator();
+
+    virtual void setSample(Sample *sample, Slices *slices);
+
+#ifndef SWIGLUA
+    virtual void process();
+    Inlet mVoltPerOctave{"V/Oct"};
+    Inlet mSync{"Sync"};
+    Outlet mOutput{"Out"};
+    Inlet mFundamental{"Fundamental"};
+    Inlet mPhase{"Phase"};
+    Parameter mInternalPhase{"Internal Phase", 0.0f};
+#endif
+
+  private:
+    typedef SliceHead Base;
+    Wavetable *mpWavetable = 0;
+  };
+
+} /* namespace od */
@@ -8,6 +8,7 @@
 #include <hal/log.h>
 #include <hal/uart.h>
 #include <limits.h>
+#include <algorithm>
 #include <hal/simd.h>
 
 // Command constants duplicated from:
@@ -28,6 +29,9 @@
 #define TO_CV_SLEW_M 0x14
 #define TO_CV_OFF 0x15
 
+// Internal command for the end of a TR pulse.
+#define TR_PULSE_END 0x100
+
 #define LOCAL_USE_NEON 1
 
 namespace teletype
@@ -37,7 +41,6 @@ namespace teletype
 
   Dispatcher::Dispatcher() : Task("Teletype Dispatcher")
   {
-    mSamplesPerTick = globalConfig.sampleRate * ticks2secsD(1);
     mLastTimestamp = ticks();
     hardReset();
   }
@@ -66,19 +69,99 @@ namespace teletype
     {
       mTRLevel0[port] = mTRPolarity[port] ? 0.0f : 1.0f;
       mTRLevel1[port] = mTRPolarity[port] ? 0.0f : 1.0f;
-      mTRDelays[port] = 0;
+      mTREdgeCount[port] = 0;
       mTRPulseActive[port] = false;
-      mTRPulseRemaining[port] = 0;
 
       mCVTarget[port] = 0.0f;
       mCVCurrent[port] = 0.0f;
       mCVDelays[port] = 0;
+      mCVEdgeCount[port] = 0;
+
+      mIsActive[port] = false;
+    }
+    mActiveCount = 0;
+    mEventCount = 0;
+  }
+
+  void Dispatcher::activate(int port)
+  {
+    if (!mIsActive[port])
+    {
+      mIsActive[port] = true;
+      mActivePorts[mActiveCount++] = port;
+    }
+  }
+
+  void Dispatcher::addEdge(Edge *edges, int &count, int offset, float value)
+  {
+    // Events are executed in time order, so offsets never decrease.
+    if (count > 0 && edges[count - 1].offset == offset)
+    {
+      edges[count - 1].value = value;
+    }
+    else if (count < MaxEdges)
+    {
+      edges[count].offset = offset;
+      edges[count].value = value;
+      count++;
+    }
+    else
+    {
+      // Out of room, so the last change in this frame wins.
+      edges[count - 1].value = value;
+    }
+  }
+
+  bool Dispatcher::later(const Event &a, const Event &b)
+  {
+    int32_t diff = a.time - b.time;
+    if (diff != 0)
+    {
+      return diff > 0;
     }
+    return (int32_t)(a.serial - b.serial) > 0;
+  }
+
+  void Dispatcher::schedule(uint32_t time, int command, int port, int value)
+  {
+    if (mEventCount == MaxEvents)
+    {
+      // Far more than teletype can send in a frame, so just drop it.
+      return;
+    }
+
+    Event &event = mEvents[mEventCount++];
+    event.time = time;
+    event.serial = mNextSerial++;
+    event.command = command;
+    event.port = port;
+    event.value = value;
+    std::push_heap(mEvents, mEvents + mEventCount, later);
+  }
+
+  void Dispatcher::schedulePulseEnd(int port, uint32_t time)
+  {
+    mTRPulseEnd[port] = time;
+
+    // Move the pending end of this port (if any) instead of adding another,
+    // so retriggered pulses cannot fill the queue.
+    for (int i = 0; i < mEventCount; i++)
+    {
+      Event &event = mEvents[i];
+      if (event.command == TR_PULSE_END && event.port == port)
+      {
+        event.time = time;
+        event.serial = mNextSerial++;
+        std::make_heap(mEvents, mEvents + mEventCount, later);
+        return;
+      }
+    }
+
+    schedule(time, TR_PULSE_END, port, 0);
   }
 
   void Dispatcher::commandTRSet(int delay, int port, int level)
   {
-    mTRLevel0[port] = mTRLevel1[port];
     if (level)
     {
       mTRLevel1[port] = mTRPolarity[port] ? 1.0f : 0.0f;
@@ -87,27 +170,26 @@ namespace teletype
     {
       mTRLevel1[port] = mTRPolarity[port] ? 0.0f : 1.0f;
     }
-    mTRDelays[port] = delay;
+    addEdge(mTREdges[port], mTREdgeCount[port], delay, mTRLevel1[port]);
+    activate(port);
     mTRPulseActive[port] = false;
-    mTRPulseRemaining[port] = 0;
   }
 
   void Dispatcher::commandTRToggle(int delay, int port)
   {
-    mTRLevel0[port] = mTRLevel1[port];
     mTRLevel1[port] = mTRLevel1[port] > 0 ? 0.0f : 1.0f;
-    mTRDelays[port] = delay;
+    addEdge(mTREdges[port], mTREdgeCount[port], delay, mTRLevel1[port]);
+    activate(port);
     mTRPulseActive[port] = false;
-    mTRPulseRemaining[port] = 0;
   }
 
   void Dispatcher::commandTRPulse(int delay, int port)
   {
-    mTRPulseActive[port] = true;
-    mTRPulseRemaining[port] = mTRPulseTime[port] - globalConfig.frameLength + delay;
-    mTRLevel0[port] = mTRLevel1[port];
     mTRLevel1[port] = mTRPolarity[port] ? 1.0f : 0.0f;
-    mTRDelays[port] = delay;
+    addEdge(mTREdges[port], mTREdgeCount[port], delay, mTRLevel1[port]);
+    activate(port);
+    mTRPulseActive[port] = true;
+    schedulePulseEnd(port, mFrameTime + delay + mTRPulseTime[port]);
   }
 
   void Dispatcher::commandTRPulseTime(int port, int ms)
@@ -117,7 +199,13 @@ namespace teletype
         (int)globalConfig.frameLength,
         MIN(maxPulseTime, ms) * ((int)globalConfig.sampleRate / 1000));
     mTRPulseTime[port] = sampleCount;
-    mTRPulseRemaining[port] = MIN(mTRPulseRemaining[port], sampleCount);
+
+    // A pulse in progress ends no later than a new one would.
+    uint32_t end = mFrameTime + sampleCount;
+    if (mTRPulseActive[port] && (int32_t)(end - mTRPulseEnd[port]) < 0)
+    {
+      schedulePulseEnd(port, end);
+    }
   }
 
   void Dispatcher::commandTRPolarity(int delay, int port, bool polarity)
@@ -129,30 +217,26 @@ namespace teletype
     }
   }
 
-  void Dispatcher::updateTR()
+  void Dispatcher::endFrame()
   {
-    for (int port = 0; port < PortCount; port++)
+    int i = 0;
+    while (i < mActiveCount)
     {
-      if (mTRPulseActive[port])
+      int port = mActivePorts[i];
+      // continue levels as-is
+      mTRLevel0[port] = mTRLevel1[port];
+      mTREdgeCount[port] = 0;
+      mCVDelays[port] = 0;
+      mCVEdgeCount[port] = 0;
+
+      if (mCVSlewEnabled[port] && mCVCurrent[port] != mCVTarget[port])
       {
-        // decrement pulse remaining count
-        if (mTRPulseRemaining[port] < (int)globalConfig.frameLength)
-        {
-          commandTRSet(mTRPulseRemaining[port], port, false);
-        }
-        else
-        {
-          mTRPulseRemaining[port] -= globalConfig.frameLength;
-          // continue level as-is
-          mTRLevel0[port] = mTRLevel1[port];
-          mTRDelays[port] = 0;
-        }
+        i++;
       }
       else
       {
-        // continue level as-is
-        mTRLevel0[port] = mTRLevel1[port];
-        mTRDelays[port] = 0;
+        mIsActive[port] = false;
+        mActivePorts[i] = mActivePorts[--mActiveCount];
       }
     }
   }
@@ -162,10 +246,20 @@ namespace teletype
     return value * (1.0f / 16384);
   }
 
+  void Dispatcher::setCVTarget(int delay, int port, float target)
+  {
+    mCVTarget[port] = target;
+    if (mCVEdgeCount[port] == 0)
+    {
+      mCVDelays[port] = delay;
+    }
+    addEdge(mCVEdges[port], mCVEdgeCount[port], delay, target);
+    activate(port);
+  }
+
   void Dispatcher::commandCV(int delay, int port, int value)
   {
-    mCVTarget[port] = convertCV(value) + mCVOffset[port];
-    mCVDelays[port] = delay;
+    setCVTarget(delay, port, convertCV(value) + mCVOffset[port]);
   }
 
   void Dispatcher::commandCVSlew(int port, int ms)
@@ -176,6 +270,8 @@ namespace teletype
     float maxDiff = globalConfig.framePeriod / slewTime;
     mCVMaxDiff[port] = maxDiff;
     mCVSlewEnabled[port] = ms > 0;
+    // Only active ports slew, so pick up any distance left to travel.
+    activate(port);
   }
 
   void Dispatcher::commandCVSet(int delay, int port, int value)
@@ -188,41 +284,19 @@ namespace teletype
   {
     float oldOffset = mCVOffset[port];
     mCVOffset[port] = convertCV(value);
-    commandCV(delay, port, mCVTarget[port] - oldOffset);
+    setCVTarget(delay, port, mCVTarget[port] - oldOffset + mCVOffset[port]);
   }
 
   void Dispatcher::updateCV()
   {
     float inverseFrameLength = globalConfig.frameRate * globalConfig.samplePeriod;
-    int port = 0;
-#if LOCAL_USE_NEON
-    int n4 = 4 * (PortCount / 4);
-    float32x4_t r = vdupq_n_f32(inverseFrameLength);
-    int32x4_t n = vdupq_n_s32(globalConfig.frameLength);
-    int32x4_t zero = vdupq_n_s32(0);
-    for (port = 0; port < n4; port += 4)
-    {
-      int32x4_t delay = vld1q_s32((int32_t *)mCVDelays + port);
-      float32x4_t maxDiff = vcvtq_f32_s32(n - delay) * r * vld1q_f32(mCVMaxDiff + port);
-      float32x4_t target = vld1q_f32(mCVTarget + port);
-      float32x4_t current = vld1q_f32(mCVCurrent + port);
-      float32x4_t diff = target - current;
-      uint32x4_t more = vcgtq_f32(diff, maxDiff);
-      uint32x4_t less = vcltq_f32(diff, -maxDiff);
-      diff = vbslq_f32(more, maxDiff, diff);
-      diff = vbslq_f32(less, -maxDiff, diff);
-      current += diff;
-      vst1q_f32(mCVCurrent + port, current);
-      vst1q_s32((int32_t *)mCVDelays + port, zero);
-    }
-#endif
-    for (; port < PortCount; port++)
+    for (int i = 0; i < mActiveCount; i++)
     {
+      int port = mActivePorts[i];
       float maxDiff = mCVMaxDiff[port] * (globalConfig.frameLength - mCVDelays[port]) * inverseFrameLength;
       float diff = CLAMP(-maxDiff, maxDiff,
                          mCVTarget[port] - mCVCurrent[port]);
       mCVCurrent[port] += diff;
-      mCVDelays[port] = 0;
     }
   }
 
@@ -253,107 +327,144 @@ namespace teletype
     }
   }
 
-  int Dispatcher::ticksToSamples(tick_t nticks)
+  void Dispatcher::execute(const Event &event)
   {
-    return nticks * mSamplesPerTick;
+    int delay = CLAMP(0, FRAMELENGTH - 1, (int32_t)(event.time - mFrameTime));
+
+    switch (event.command)
+    {
+    case TO_TR:
+      // SC.TR 1-n α --> Set TR value to α (0/1)
+      commandTRSet(delay, event.port, event.value);
+      break;
+    case TO_TR_TOG:
+      // SC.TR.TOG 1-n --> Toggle TR
+      commandTRToggle(delay, event.port);
+      break;
+    case TO_TR_TIME:
+      // SC.TR.TIME 1-n α -->  time for TR.PULSE; α in milliseconds
+      commandTRPulseTime(event.port, event.value);
+      break;
+    case TO_TR_TIME_S:
+      // SC.TR.TIME.S 1-n α -->  time for TR.PULSE; α in seconds
+      commandTRPulseTime(event.port, event.value * 1000);
+      break;
+    case TO_TR_TIME_M:
+      // SC.TR.TIME.M 1-n α --> time for TR.PULSE; α in minutes
+      commandTRPulseTime(event.port, event.value * 60000);
+      break;
+    case TO_TR_PULSE:
+      // SC.TR.PULSE 1-n --> Pulse TR using TO.TR.TIME/S/M as an interval
+      commandTRPulse(delay, event.port);
+      break;
+    case TO_TR_POL:
+      // SC.TR.POL 1-n α --> polarity for TO.TR.PULSE set to α (0-1)
+      commandTRPolarity(delay, event.port, event.value);
+      break;
+
+    case TO_CV:
+      // SC.CV 1-n α --> CV target α (bipolar)
+      commandCV(delay, event.port, event.value);
+      break;
+    case TO_CV_SET:
+      // SC.CV.SET 1-n α --> set CV to α (bipolar); ignoring SLEW
+      commandCVSet(delay, event.port, event.value);
+      break;
+    case TO_CV_SLEW:
+      // SC.CV.SLEW 1-n α --> CV slew time; α in milliseconds
+      commandCVSlew(event.port, event.value);
+      break;
+    case TO_CV_SLEW_S:
+      // SC.CV.SLEW.S 1-n α --> CV slew time; α in seconds
+      commandCVSlew(event.port, event.value * 1000);
+      break;
+    case TO_CV_SLEW_M:
+      // SC.CV.SLEW.M 1-n α --> CV slew time; α in minutes
+      commandCVSlew(event.port, event.value * 60000);
+      break;
+    case TO_CV_OFF:
+      // SC.CV.OFF 1-n α --> CV offset; α added at final stage
+      commandCVOffset(delay, event.port, event.value);
+      break;
+
+    case TR_PULSE_END:
+      if (mTRPulseActive[event.port] && event.time == mTRPulseEnd[event.port])
+      {
+        commandTRSet(delay, event.port, false);
+      }
+      break;
+
+    default:
+      // unknown command
+      break;
+    }
   }
 
   void Dispatcher::process(float *inputs, float *outputs)
   {
-    updateTR();
-    updateCV();
-
+    endFrame();
+    mFrameTime += FRAMELENGTH;
+
+    // Messages received during the last frame land at the same relative
+    // position in this one.  Measuring against the time between the last two
+    // calls, rather than a nominal tick rate, absorbs the audio thread's
+    // jitter.
+    tick_t now = ticks();
+    tick_t elapsed = MAX(1, now - mLastTimestamp);
     I2cMessage msg;
     while (I2c_popMessage(&msg))
     {
-
       if (msg.length == 0)
       {
         continue;
       }
 
-      int delay = CLAMP(0, FRAMELENGTH - 1, ticksToSamples(msg.timestamp - mLastTimestamp));
+      int delay = CLAMP(0, FRAMELENGTH - 1,
+                        (int)((msg.timestamp - mLastTimestamp) * FRAMELENGTH / elapsed));
+      schedule(mFrameTime + delay, msg.data[0], getPort(msg), getValue(msg));
 
       // Diagnostic: pulse the null port for every received message.
-      commandTRPulse(delay, 0);
+      schedule(mFrameTime + delay, TO_TR_PULSE, NullPort, 0);
+    }
+    mLastTimestamp = now;
 
-      switch (msg.data[0])
-      {
-      case TO_TR:
-        // SC.TR 1-n α --> Set TR value to α (0/1)
-        commandTRSet(delay, getPort(msg), getValue(msg));
-        break;
-      case TO_TR_TOG:
-        // SC.TR.TOG 1-n --> Toggle TR
-        commandTRToggle(delay, getPort(msg));
-        break;
-      case TO_TR_TIME:
-        // SC.TR.TIME 1-n α -->  time for TR.PULSE; α in milliseconds
-        commandTRPulseTime(getPort(msg), getValue(msg));
-        break;
-      case TO_TR_TIME_S:
-        // SC.TR.TIME.S 1-n α -->  time for TR.PULSE; α in seconds
-        commandTRPulseTime(getPort(msg), getValue(msg) * 1000);
-        break;
-      case TO_TR_TIME_M:
-        // SC.TR.TIME.M 1-n α --> time for TR.PULSE; α in minutes
-        commandTRPulseTime(getPort(msg), getValue(msg) * 60000);
-        break;
-      case TO_TR_PULSE:
-        // SC.TR.PULSE 1-n --> Pulse TR using TO.TR.TIME/S/M as an interval
-        commandTRPulse(delay, getPort(msg));
-        break;
-      case TO_TR_POL:
-        // SC.TR.POL 1-n α --> polarity for TO.TR.PULSE set to α (0-1)
-        commandTRPolarity(delay, getPort(msg), getValue(msg));
-        break;
-
-      case TO_CV:
-        // SC.CV 1-n α --> CV target α (bipolar)
-        commandCV(delay, getPort(msg), getValue(msg));
-        break;
-      case TO_CV_SET:
-        // SC.CV.SET 1-n α --> set CV to α (bipolar); ignoring SLEW
-        commandCVSet(delay, getPort(msg), getValue(msg));
-        break;
-      case TO_CV_SLEW:
-        // SC.CV.SLEW 1-n α --> CV slew time; α in milliseconds
-        commandCVSlew(getPort(msg), getValue(msg));
-        break;
-      case TO_CV_SLEW_S:
-        // SC.CV.SLEW.S 1-n α --> CV slew time; α in seconds
-        commandCVSlew(getPort(msg), getValue(msg) * 1000);
-        break;
-      case TO_CV_SLEW_M:
-        // SC.CV.SLEW.M 1-n α --> CV slew time; α in minutes
-        commandCVSlew(getPort(msg), getValue(msg) * 60000);
-        break;
-      case TO_CV_OFF:
-        // SC.CV.OFF 1-n α --> CV offset; α added at final stage
-        commandCVOffset(delay, getPort(msg), getValue(msg));
-        break;
-
-      default:
-        // unknown command
-        break;
-      }
+    // Everything due in this frame, in time order.
+    while (mEventCount > 0 &&
+           (int32_t)(mEvents[0].time - mFrameTime) < FRAMELENGTH)
+    {
+      Event event = mEvents[0];
+      std::pop_heap(mEvents, mEvents + mEventCount, later);
+      mEventCount--;
+      execute(event);
     }
 
-    mLastTimestamp = ticks();
+    updateCV();
   }
 
-  void Dispatcher::fillTRFrame(int port, float *out)
+  // Hold value, changing it at each edge.
+  static inline void fillEdges(float *out, float value,
+                               const Dispatcher::Edge *edges, int count)
   {
-    for (int i = 0; i < mTRDelays[port]; i++)
+    int i = 0;
+    for (int e = 0; e < count; e++)
     {
-      out[i] = mTRLevel0[port];
+      for (; i < edges[e].offset; i++)
+      {
+        out[i] = value;
+      }
+      value = edges[e].value;
     }
-    for (int i = mTRDelays[port]; i < FRAMELENGTH; i++)
+    for (; i < FRAMELENGTH; i++)
     {
-      out[i] = mTRLevel1[port];
+      out[i] = value;
     }
   }
 
+  void Dispatcher::fillTRFrame(int port, float *out)
+  {
+    fillEdges(out, mTRLevel0[port], mTREdges[port], mTREdgeCount[port]);
+  }
+
   float Dispatcher::fillCVFrame(int port, float *out, float lastValue)
   {
     if (mCVSlewEnabled[port])
@@ -375,16 +486,13 @@ namespace teletype
       }
 #endif
     }
+    else if (mCVEdgeCount[port] > 0)
+    {
+      fillEdges(out, lastValue, mCVEdges[port], mCVEdgeCount[port]);
+    }
     else
     {
-      for (int i = 0; i < mCVDelays[port]; i++)
-      {
-        out[i] = lastValue;
-      }
-      for (int i = mCVDelays[port]; i < FRAMELENGTH; i++)
-      {
-        out[i] = mCVTarget[port];
-      }
+      fillEdges(out, mCVTarget[port], 0, 0);
     }
     return out[FRAMELENGTH - 1];
   }
@@ -23,6 +23,7 @@ namespace teletype
 #ifndef SWIGLUA
     void process(float *inputs, float *outputs);
 
+    // Idle ports are filled with a constant.
     void fillTRFrame(int port, float *out);
     float fillCVFrame(int port, float *out, float lastValue);
 
@@ -43,34 +44,78 @@ namespace teletype
     static const int MaxPort = PortCount - 1;
     static const int MinPort = 1;
     static const int NullPort = 0;
+    // Changes to one port within a single frame.
+    static const int MaxEdges = 8;
+    // Commands waiting for their time, including the ends of pulses.
+    static const int MaxEvents = 256;
+
+    struct Edge
+    {
+      int offset;
+      float value;
+    };
 
     // TR state
+    // Level at the start of the frame and after its last edge.
     float mTRLevel0[PortCount];
     float mTRLevel1[PortCount];
-    int mTRDelays[PortCount];
+    Edge mTREdges[PortCount][MaxEdges];
+    int mTREdgeCount[PortCount];
     bool mTRPolarity[PortCount];
     int mTRPulseTime[PortCount];
-    int mTRPulseRemaining[PortCount];
     bool mTRPulseActive[PortCount];
+    // Time of the pending pulse end (there is at most one per port).
+    uint32_t mTRPulseEnd[PortCount];
 
     // CV state
     float mCVTarget[PortCount];
     float mCVCurrent[PortCount];
+    // Offset of the first change in this frame.
     int mCVDelays[PortCount];
+    Edge mCVEdges[PortCount][MaxEdges];
+    int mCVEdgeCount[PortCount];
     float mCVOffset[PortCount];
     float mCVMaxDiff[PortCount];
     bool mCVSlewEnabled[PortCount];
 #endif
 
   protected:
+    struct Event
+    {
+      // In samples.
+      uint32_t time;
+      // Keeps events for the same sample in the order they arrived.
+      uint32_t serial;
+      int command;
+      int port;
+      int value;
+    };
+
+    // Min-heap on (time, serial).
+    Event mEvents[MaxEvents];
+    int mEventCount = 0;
+    uint32_t mNextSerial = 0;
+
+    // Ports with edges in this frame or a CV that is still slewing.
+    int mActivePorts[PortCount];
+    int mActiveCount = 0;
+    bool mIsActive[PortCount];
+
+    // Time of the first sample of the current frame.
+    uint32_t mFrameTime = 0;
     tick_t mLastTimestamp;
-    double mSamplesPerTick;
     int mDefaultSlewTimeMs = 2;
     bool mEnabled = false;
 
-    void updateTR();
+    void endFrame();
     void updateCV();
-    int ticksToSamples(tick_t nticks);
+    void activate(int port);
+    void addEdge(Edge *edges, int &count, int offset, float value);
+    void setCVTarget(int delay, int port, float target);
+    void schedule(uint32_t time, int command, int port, int value);
+    void schedulePulseEnd(int port, uint32_t time);
+    void execute(const Event &event);
+    static bool later(const Event &a, const Event &b);
   };
 
 } // namespace teletype
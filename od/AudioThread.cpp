@@ -5,27 +5,39 @@
 #include <od/tasks/ConnectionQueue.h>
 #include <od/extras/LookupTables.h>
 #include <od/extras/Profiler.h>
+#include <od/extras/Tracer.h>
 #include <od/config.h>
+#include <hal/heap.h>
 #include <hal/log.h>
 #include <limits.h>
 
 namespace od
 {
 
+  // Frames in the mono pool.
+  static const int framePoolSize = 1024;
+
   struct AudioThreadLocals
   {
     WatermarkedBufferPool<float> framePool;
+    // Blocks of 2 frames for stereo outlets.
+    WatermarkedBufferPool<float> stereoFramePool;
+    // Handed out when the stereo pool runs out, so that outlets always have
+    // somewhere to write.  Never released.
+    float *stereoScratch = 0;
     bool outOfFramesLatch = false;
 
     TaskScheduler tasks;
     InputTask *inputTask = 0;
     OutputTask *outputTask = 0;
+    TransportTask *transportTask = 0;
 
     ConnectionQueue *conQ = 0;
 
     ObjectCache<FifoProbe> *fifoProbeCache = 0;
 
     ExecutionTimer audioTimer;
+    uint32_t frameCount = 0;
   };
 
   static AudioThreadLocals *local = 0;
@@ -37,7 +49,13 @@ namespace od
   void AudioThread::init()
   {
     local = new AudioThreadLocals();
-    local->framePool.allocate(globalConfig.frameLength, 1024);
+    local->framePool.allocate(globalConfig.frameLength, framePoolSize);
+    // Stereo signals used to take two mono frames each, so give them room for
+    // as many channels as the mono pool has.
+    local->stereoFramePool.allocate(2 * globalConfig.frameLength,
+                                    framePoolSize / 2);
+    local->stereoScratch = (float *)Heap_memalign(
+        CACHELINE_SIZE_MAX, 2 * globalConfig.frameLength * sizeof(float));
     Outlet::initializeGlobalOutlets();
     LookupTables::initialize();
     Profiler::add(&local->audioTimer, "audio", true);
@@ -46,6 +64,9 @@ namespace od
     local->inputTask = new InputTask();
     addTask(local->inputTask, INT_MAX - 1);
 
+    local->transportTask = new TransportTask();
+    addTask(local->transportTask, INT_MAX - 2);
+
     local->outputTask = new OutputTask();
     addTask(local->outputTask, INT_MIN + 2);
 
@@ -90,6 +111,11 @@ namespace od
     return local->outputTask;
   }
 
+  TransportTask *AudioThread::getTransportTask()
+  {
+    return local->transportTask;
+  }
+
   FifoProbe *AudioThread::getFifoProbe()
   {
     return local->fifoProbeCache->get();
@@ -100,11 +126,36 @@ namespace od
     local->fifoProbeCache->release(probe);
   }
 
-  float *AudioThread::getFrame()
+  static WatermarkedBufferPool<float> &poolFor(int count)
+  {
+    logAssert(count <= 2);
+    if (count <= 1)
+    {
+      return local->framePool;
+    }
+    else
+    {
+      return local->stereoFramePool;
+    }
+  }
+
+  float *AudioThread::getFrame(int category)
+  {
+    return getFrames(1, category);
+  }
+
+  void AudioThread::releaseFrame(float *frame, int category)
+  {
+    releaseFrames(frame, 1, category);
+  }
+
+  float *AudioThread::getFrames(int count, int category)
   {
-    float *frame = local->framePool.get();
+    WatermarkedBufferPool<float> &pool = poolFor(count);
+    float *frame = pool.get();
     if (frame)
     {
+      MemoryTracker::allocated(category, pool.mBufferSize * sizeof(float));
       local->outOfFramesLatch = false;
       return frame;
     }
@@ -113,22 +164,28 @@ namespace od
       if (!local->outOfFramesLatch)
       {
         local->outOfFramesLatch = true;
-        if (local->framePool.mPoolSizeInBuffers == 0)
+        if (pool.mPoolSizeInBuffers == 0)
         {
-          logFatal("AudioThread::getFrame(): pool not allocated yet!");
+          logFatal("AudioThread::getFrames(%d): pool not allocated yet!", count);
         }
         else
         {
-          logFatal("AudioThread::getFrame(): out of buffers!");
+          logFatal("AudioThread::getFrames(%d): out of buffers!", count);
         }
       }
-      return 0;
+      // Multichannel outlets write through their block without checking.
+      return count > 1 ? local->stereoScratch : 0;
     }
   }
 
-  void AudioThread::releaseFrame(float *frame)
+  void AudioThread::releaseFrames(float *frames, int count, int category)
   {
-    local->framePool.release(frame);
+    WatermarkedBufferPool<float> &pool = poolFor(count);
+    if (frames && frames != local->stereoScratch)
+    {
+      MemoryTracker::freed(category, pool.mBufferSize * sizeof(float));
+      pool.release(frames);
+    }
   }
 
   void AudioThread::connect(Outlet *outlet, Inlet *inlet, Object *object)
@@ -146,12 +203,21 @@ namespace od
     local->conQ->pushDisconnection(outlet, object);
   }
 
+  uint32_t AudioThread::getFrameCount()
+  {
+    return local->frameCount;
+  }
+
   void AudioThread::printStatus()
   {
     logInfo("FramePool: %d of %d (watermark=%d)",
             local->framePool.countBuffersInUse(),
             local->framePool.mPoolSizeInBuffers,
             local->framePool.mMaxBuffersUsed);
+    logInfo("StereoFramePool: %d of %d (watermark=%d)",
+            local->stereoFramePool.countBuffersInUse(),
+            local->stereoFramePool.mPoolSizeInBuffers,
+            local->stereoFramePool.mMaxBuffersUsed);
     logInfo("Fifo Probes: %lu active %lu free",
             local->fifoProbeCache->activeSize(),
             local->fifoProbeCache->freeSize());
@@ -164,7 +230,9 @@ extern "C"
 {
   void Pump_callback(float *inputs, float *outputs)
   {
+    od::TraceScope scope(od::TRACE_AUDIO, "frame");
     od::local->audioTimer.start();
+    od::local->frameCount++;
     od::local->tasks.process(inputs, outputs);
     od::local->audioTimer.stop();
   }
@@ -2,7 +2,9 @@
 
 #include <od/tasks/InputTask.h>
 #include <od/tasks/OutputTask.h>
+#include <od/tasks/TransportTask.h>
 #include <od/objects/measurement/FifoProbe.h>
+#include <od/extras/MemoryTracker.h>
 
 namespace od
 {
@@ -19,6 +21,7 @@ namespace od
 
     static InputTask *getInputTask();
     static OutputTask *getOutputTask();
+    static TransportTask *getTransportTask();
 
     static void connect(Outlet *outlet, Inlet *inlet, Object *object = 0);
     static void disconnect(Inlet *inlet, Object *object = 0);
@@ -31,11 +34,18 @@ namespace od
     static void releaseFifoProbe(FifoProbe *probe);
 
     // Returns (i.e. allocates) a FRAMELENGTH buffer from the pre-allocated pool of frame buffers.
-    static float *getFrame();
+    static float *getFrame(int category = MEMORY_FRAMES);
     // Releases (i.e. frees) the previously gotten frame buffer.
-    static void releaseFrame(float *frame);
+    static void releaseFrame(float *frame, int category = MEMORY_FRAMES);
+    // Same for a block of count (up to 2) consecutive frame buffers.  Blocks
+    // of 2 are never null, a shared scratch block stands in when they run out.
+    static float *getFrames(int count, int category = MEMORY_FRAMES);
+    static void releaseFrames(float *frames, int count, int category = MEMORY_FRAMES);
     // The previous 2 calls are constant-time non-locking and thus safe to call in the audio thread.
 
+    // Number of frames processed so far (starting at 1 for the first frame).
+    static uint32_t getFrameCount();
+
 #endif
 
   private:
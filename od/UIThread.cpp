@@ -5,6 +5,7 @@
 #include <od/graphics/screensavers/Lines.h>
 #include <od/graphics/screensavers/Bubbles.h>
 #include <od/extras/Profiler.h>
+#include <od/extras/Tracer.h>
 #include <od/ui/ChannelLEDs.h>
 #include <od/AudioThread.h>
 #include <hal/events.h>
@@ -65,6 +66,11 @@ namespace od
     local->eventTimer.stop();
   }
 
+  tick_t UIThread::getFrameStart()
+  {
+    return local->displayTimer.mStart;
+  }
+
   void UIThread::restartScreenSaverTimer()
   {
     local->screenSaverTimer = 0;
@@ -184,6 +190,7 @@ namespace od
       return;
     }
 
+    TraceScope scope(TRACE_UI, "updateDisplay");
     local->displayTimer.start();
 
     Graphic::updateTween();
@@ -226,7 +233,9 @@ namespace od
     }
 
     // place on queue to have it sent to the LCD
+    Tracer::begin(TRACE_UI, "Display_putBuffer");
     Display_putBuffer(frame);
+    Tracer::end(TRACE_UI, "Display_putBuffer");
 
     // set pwm outputs
     InputTask *task = AudioThread::getInputTask();
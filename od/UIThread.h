@@ -2,6 +2,7 @@
 
 #include <od/graphics/GraphicContext.h>
 #include <od/ui/JobQueue.h>
+#include <hal/timing.h>
 
 namespace od
 {
@@ -27,6 +28,11 @@ namespace od
 
     static JobQueue *getRealtimeJobQueue();
 
+#ifndef SWIGLUA
+    // When the last display update started.
+    static tick_t getFrameStart();
+#endif
+
   private:
     UIThread();
   };
@@ -2,6 +2,7 @@
 #include <od/extras/RealFFT.h>
 #include <od/extras/EWMA.h>
 #include <od/extras/BigHeap.h>
+#include <od/extras/MemoryTracker.h>
 #include <hal/ops.h>
 #include <math.h>
 #include <string.h>
@@ -113,6 +114,7 @@ namespace od
   {
     if (mpBuffer)
     {
+      MemoryTracker::freed(MEMORY_OTHER, mLength * sizeof(float));
       BigHeap::free(mpBuffer);
       mpBuffer = 0;
       mLength = 0;
@@ -123,12 +125,7 @@ namespace od
                                           uint32_t end, float targetRate,
                                           float overlap)
   {
-    if (mpBuffer)
-    {
-      BigHeap::free(mpBuffer);
-      mpBuffer = 0;
-      mLength = 0;
-    }
+    freeResources();
 
     // at least 1Hz
     targetRate = MAX(1, targetRate);
@@ -159,8 +156,10 @@ namespace od
     mpBuffer = BigHeap::allocate(mLength * sizeof(float));
     if (mpBuffer == 0)
     {
+      mLength = 0;
       return false;
     }
+    MemoryTracker::allocated(MEMORY_OTHER, mLength * sizeof(float));
 
     mOriginalSampleRate = sample->mSampleRate;
     mStartSample = start;
@@ -3,6 +3,7 @@
 #include <od/audio/WavFileWriter.h>
 #include <od/extras/Conversions.h>
 #include <od/extras/BigHeap.h>
+#include <od/extras/MemoryTracker.h>
 #include <od/extras/Random.h>
 #include <od/constants.h>
 #include <hal/ops.h>
@@ -44,6 +45,7 @@ namespace od
       mpData = buffer;
       mChannelCount = Nc;
       mSampleCount = Ns;
+      MemoryTracker::allocated(MEMORY_SAMPLES, getSizeInBytes());
       setSampleRate(mSampleRate);
       alterWaterMark();
     }
@@ -60,6 +62,7 @@ namespace od
     {
       mChannelCount = _Nc;
       mSampleCount = _Ns;
+      MemoryTracker::allocated(MEMORY_SAMPLES, getSizeInBytes());
       setSampleRate(mSampleRate);
       alterWaterMark();
       return true;
@@ -92,6 +95,7 @@ namespace od
   {
     if (mpData)
     {
+      MemoryTracker::freed(MEMORY_SAMPLES, getSizeInBytes());
       BigHeap::free((char *)mpData);
     }
 
@@ -1,5 +1,6 @@
 #include <od/audio/SampleLoader.h>
 #include <od/audio/WavFileReader.h>
+#include <od/extras/Tracer.h>
 
 namespace od
 {
@@ -95,7 +96,10 @@ namespace od
                 else
                     sr = SamplesPerBlock;
 
-                if (reader.readSamples(buffer, sr) != (uint32_t)sr)
+                Tracer::begin(mTraceTrack, "SampleLoader::read");
+                uint32_t samplesRead = reader.readSamples(buffer, sr);
+                Tracer::end(mTraceTrack, "SampleLoader::read");
+                if (samplesRead != (uint32_t)sr)
                 {
                     return STATUS_ERROR_READING_FILE;
                 }
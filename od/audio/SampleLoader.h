@@ -24,6 +24,10 @@ namespace od
     uint32_t mSamplesRemaining = 0;
     Sample *mpSample = NULL;
     virtual void work();
+    virtual const char *getTraceName()
+    {
+      return "SampleLoader";
+    }
     int load();
   };
 
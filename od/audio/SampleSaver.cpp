@@ -1,5 +1,6 @@
 #include <od/audio/SampleSaver.h>
 #include <od/audio/WavFileWriter.h>
+#include <od/extras/FileIndex.h>
 
 namespace od
 {
@@ -31,6 +32,8 @@ namespace od
 			mStatus = save();
 			mpSample->release();
 			mpSample = NULL;
+			// Even a failed save may have left a file behind.
+			FileIndex::invalidateParent(mFilename);
 		}
 	}
 
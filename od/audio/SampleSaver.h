@@ -26,6 +26,10 @@ namespace od
     uint32_t mSamplesRemaining = 0;
 
     virtual void work();
+    virtual const char *getTraceName()
+    {
+      return "SampleSaver";
+    }
     int save();
   };
 
@@ -2,6 +2,7 @@
 #include <od/audio/WavFileReader.h>
 #include <od/extras/FileWriter.h>
 #include <od/extras/FileReader.h>
+#include <od/extras/MemoryTracker.h>
 #include <hal/simd.h>
 #include <hal/log.h>
 #include <algorithm>
@@ -10,12 +11,31 @@
 namespace od
 {
 
+  // Version 1 stores the slices sorted, as one block of records:
+  //   int count, then {int start, int loopStart, int loopEnd, float speed}
+  // Version 0 had the same layout but was written a field at a time and
+  // not necessarily sorted.
+  static const uint32_t formatVersion = 1;
+  static_assert(sizeof(Slice) == 4 * sizeof(int), "Slice record layout");
+
   Slices::Slices()
   {
   }
 
   Slices::~Slices()
   {
+    MemoryTracker::freed(MEMORY_SLICES, mTrackedBytes);
+  }
+
+  void Slices::updateMemoryUsage()
+  {
+    int bytes = mSorted.capacity() * sizeof(Slice) +
+                mIntervalStarts.capacity() * sizeof(int) +
+                mIntervalLengths.capacity() * sizeof(int) +
+                mIndex.capacity() * sizeof(int) +
+                mIndexRank.capacity() * sizeof(int);
+    MemoryTracker::resize(MEMORY_SLICES, mTrackedBytes, bytes);
+    mTrackedBytes = bytes;
   }
 
   bool Slices::save(const char *filename)
@@ -28,18 +48,12 @@ namespace od
       return false;
     }
 
-    writer.writeHeader("Slices", 0, 0);
-    writer.writeBytes(&n, sizeof(int));
-    for (Slice &slice : mSorted)
-    {
-      writer.writeBytes(&slice.mStart, sizeof(int));
-      writer.writeBytes(&slice.mLoopStart, sizeof(int));
-      writer.writeBytes(&slice.mLoopEnd, sizeof(int));
-      writer.writeBytes(&slice.mSpeed, sizeof(float));
-    }
+    uint32_t nbytes = n * sizeof(Slice);
+    bool ok = writer.writeHeader("Slices", formatVersion, 0) &&
+              writer.writeBytes(&n, sizeof(int)) == sizeof(int) &&
+              writer.writeBytes(mSorted.data(), nbytes) == nbytes;
 
-    writer.close();
-    return true;
+    return writer.close() && ok;
   }
 
   bool Slices::load(const char *filename)
@@ -61,6 +75,12 @@ namespace od
       return false;
     }
 
+    if (major > formatVersion)
+    {
+      logWarn("%s: unsupported slices version %d.", filename, major);
+      return false;
+    }
+
     if (reader.readBytes(&n, sizeof(int)) != sizeof(int))
     {
       logWarn("Failed to read # of slices.");
@@ -72,37 +92,31 @@ namespace od
       return true;
     }
 
-    mSorted.clear();
-    mIntervalsNeedRefresh = true;
-    mSorted.reserve(n);
-    for (int i = 0; i < n; i++)
+    // Check the count before multiplying so a corrupt count cannot wrap.
+    uint32_t remaining = reader.getSizeInBytes() - reader.tellBytes();
+    if (n < 0 || (uint32_t)n > remaining / sizeof(Slice))
     {
-      Slice slice;
-      if (reader.readBytes(&slice.mStart, sizeof(int)) != sizeof(int))
-      {
-        logWarn("Failed to read slice %d start.", i);
-        return false;
-      }
-      if (reader.readBytes(&slice.mLoopStart, sizeof(int)) != sizeof(int))
-      {
-        logWarn("Failed to read slice %d loop start.", i);
-        return false;
-      }
-      if (reader.readBytes(&slice.mLoopEnd, sizeof(int)) != sizeof(int))
-      {
-        logWarn("Failed to read slice %d loop end.", i);
-        return false;
-      }
-      if (reader.readBytes(&slice.mSpeed, sizeof(float)) != sizeof(float))
-      {
-        logWarn("Failed to read slice %d speed.", i);
-        return false;
-      }
+      logWarn("%s: slice count (%d) exceeds the file size.", filename, n);
+      return false;
+    }
+    uint32_t nbytes = n * sizeof(Slice);
 
-      mSorted.push_back(slice);
+    // Both versions store whole records back to back, so read them at once.
+    std::vector<Slice> slices(n);
+    if (reader.readBytes(slices.data(), nbytes) != nbytes)
+    {
+      logWarn("Failed to read %d slices.", n);
+      return false;
     }
 
-    sort();
+    mSorted.swap(slices);
+    mIntervalsNeedRefresh = true;
+    if (major == 0 && !std::is_sorted(mSorted.begin(), mSorted.end()))
+    {
+      std::sort(mSorted.begin(), mSorted.end());
+    }
+    refreshIndex();
+    updateMemoryUsage();
 
     return true;
   }
@@ -151,14 +165,59 @@ namespace od
     mIntervalsNeedRefresh = true;
   }
 
+  // Fill the index from the sorted slices starting at i, in-order from node k.
+  int Slices::buildIndex(int i, int k)
+  {
+    if (k < (int)mIndex.size())
+    {
+      i = buildIndex(i, 2 * k);
+      mIndex[k] = mSorted[i].mStart;
+      mIndexRank[k] = i++;
+      i = buildIndex(i, 2 * k + 1);
+    }
+    return i;
+  }
+
+  void Slices::refreshIndex()
+  {
+    int n = mSorted.size();
+    mIndex.resize(n + 1);
+    mIndexRank.resize(n + 1);
+    buildIndex(0, 1);
+    mIndexValid = true;
+  }
+
+  // Index of the first slice starting at or after sample (size() if none).
+  int Slices::lowerBound(int sample)
+  {
+    if (!mIndexValid)
+    {
+      return std::lower_bound(mSorted.begin(), mSorted.end(), sample) -
+             mSorted.begin();
+    }
+
+    const int *index = mIndex.data();
+    int n = mIndex.size();
+    int k = 1;
+    while (k < n)
+    {
+      // The next 4 levels share a cache line once k is large enough.
+      __builtin_prefetch(index + 16 * k);
+      k = 2 * k + (index[k] < sample);
+    }
+    // Undo the right turns taken after the last left turn.
+    k >>= __builtin_ffs(~k);
+    return k == 0 ? n - 1 : mIndexRank[k];
+  }
+
   SlicesIterator Slices::getPositionAfter(int sample)
   {
-    return std::lower_bound(mSorted.begin(), mSorted.end(), sample);
+    return mSorted.begin() + lowerBound(sample);
   }
 
   SlicesIterator Slices::getPositionBefore(int sample)
   {
-    SlicesIterator i = std::lower_bound(mSorted.begin(), mSorted.end(), sample);
+    SlicesIterator i = mSorted.begin() + lowerBound(sample);
     if (std::distance(mSorted.begin(), i) > 0)
     {
       i--;
@@ -168,7 +227,7 @@ namespace od
 
   SlicesIterator Slices::findNearestNoCheck(int sample)
   {
-    SlicesIterator i = std::lower_bound(mSorted.begin(), mSorted.end(), sample);
+    SlicesIterator i = mSorted.begin() + lowerBound(sample);
     if (i == mSorted.begin())
     {
       // sample < all slices
@@ -199,6 +258,8 @@ namespace od
     SlicesIterator i = std::lower_bound(mSorted.begin(), mSorted.end(), slice);
     i = mSorted.insert(i, slice);
     mIntervalsNeedRefresh = true;
+    refreshIndex();
+    updateMemoryUsage();
     // Check the loop of the previous slice doesn't overlap with this new slice.
     if (i > mSorted.begin())
     {
@@ -224,29 +285,37 @@ namespace od
     SlicesIterator j = std::upper_bound(mSorted.begin(), mSorted.end(), last);
     mSorted.erase(i, j);
     mIntervalsNeedRefresh = true;
+    refreshIndex();
   }
 
   void Slices::removeIterator(SlicesIterator i)
   {
     mSorted.erase(i);
     mIntervalsNeedRefresh = true;
+    refreshIndex();
   }
 
   void Slices::removeRangeOfIterators(SlicesIterator first, SlicesIterator last)
   {
     mSorted.erase(first, last);
     mIntervalsNeedRefresh = true;
+    refreshIndex();
   }
 
   void Slices::append(const Slice &slice)
   {
     mSorted.push_back(slice);
     mIntervalsNeedRefresh = true;
+    // Appends come in bulk and are followed by sort().
+    mIndexValid = false;
+    updateMemoryUsage();
   }
 
   void Slices::sort()
   {
     std::sort(mSorted.begin(), mSorted.end());
+    refreshIndex();
+    updateMemoryUsage();
   }
 
   // Starting at sourceStart, copy slices from 'srcSlices' to the interval [from, to].
@@ -340,6 +409,7 @@ namespace od
   {
     mSorted.clear();
     mIntervalsNeedRefresh = true;
+    refreshIndex();
   }
 
   int Slices::size()
@@ -370,6 +440,7 @@ namespace od
       }
     }
     mIntervalsNeedRefresh = false;
+    updateMemoryUsage();
   }
 
   int Slices::getIntervalCount()
@@ -65,6 +65,22 @@ namespace od
         std::vector<int> mIntervalLengths;
         bool mIntervalsNeedRefresh = false;
         void refreshIntervals();
+
+        // Slice starts in Eytzinger (breadth-first) order, 1-based, with the
+        // sorted index of each.  Searching it touches far fewer cache lines
+        // than a binary search of mSorted.  Rebuilt by every change to
+        // mSorted except append(), so it is never built on the audio thread.
+        // Code that edits slice starts in place must call sort() afterwards.
+        std::vector<int> mIndex;
+        std::vector<int> mIndexRank;
+        bool mIndexValid = false;
+        void refreshIndex();
+        int buildIndex(int i, int k);
+        int lowerBound(int sample);
+
+        // Bytes currently reported to the MemoryTracker.
+        int mTrackedBytes = 0;
+        void updateMemoryUsage();
     };
 
 } /* namespace od */
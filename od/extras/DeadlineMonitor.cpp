@@ -0,0 +1,238 @@
+#include <od/extras/DeadlineMonitor.h>
+#include <od/config.h>
+#include <hal/pump.h>
+#include <hal/log.h>
+#include <hal/ops.h>
+#include <math.h>
+#include <string.h>
+
+namespace od
+{
+
+  DeadlineMonitor &DeadlineMonitor::singleton()
+  {
+    static DeadlineMonitor m;
+    return m;
+  }
+
+  DeadlineMonitor::DeadlineMonitor()
+  {
+    clear();
+  }
+
+  void DeadlineMonitor::clear()
+  {
+    memset(mBuckets, 0, sizeof(mBuckets));
+    mFrameCount = 0;
+    mOverrunCount = 0;
+    mWorstCount = 0;
+    mThrottledAtReset = Pump_getThrottledCount();
+  }
+
+  void DeadlineMonitor::reset()
+  {
+    singleton().mResetRequested = true;
+  }
+
+  void DeadlineMonitor::beginFrame()
+  {
+    DeadlineMonitor &m = singleton();
+    if (m.mResetRequested)
+    {
+      m.clear();
+      m.mResetRequested = false;
+    }
+    if (m.mDeadline == 0)
+    {
+      m.mDeadline = globalConfig.framePeriod / ticks2secsD(1);
+    }
+    m.mTaskCount = 0;
+    m.mFrameStart = ticks();
+    m.mTaskStart = m.mFrameStart;
+  }
+
+  void DeadlineMonitor::endTask(const char *name)
+  {
+    DeadlineMonitor &m = singleton();
+    tick_t now = ticks();
+    if (m.mTaskCount < maximumTasks)
+    {
+      m.mTaskNames[m.mTaskCount] = name;
+      m.mTaskTimes[m.mTaskCount] = now - m.mTaskStart;
+      m.mTaskCount++;
+    }
+    m.mTaskStart = now;
+  }
+
+  void DeadlineMonitor::endFrame()
+  {
+    DeadlineMonitor &m = singleton();
+    tick_t elapsed = ticks() - m.mFrameStart;
+
+    m.mFrameCount++;
+    if (elapsed > m.mDeadline)
+    {
+      m.mOverrunCount++;
+    }
+
+    int i = 0;
+    if (elapsed > 0 && m.mDeadline > 0)
+    {
+      float load = (float)elapsed / (float)m.mDeadline;
+      i = overrunBucket + (int)floorf(2.0f * log2f(load));
+      i = MAX(0, MIN(bucketCount - 1, i));
+    }
+    m.mBuckets[i]++;
+
+    // Is this one of the worst frames so far?
+    int k = m.mWorstCount;
+    if (k == worstCount)
+    {
+      if (elapsed <= m.mWorst[k - 1].elapsed)
+      {
+        return;
+      }
+      k--;
+    }
+    else
+    {
+      m.mWorstCount++;
+    }
+
+    // Keep the list sorted in decreasing order of load.
+    while (k > 0 && m.mWorst[k - 1].elapsed < elapsed)
+    {
+      m.mWorst[k] = m.mWorst[k - 1];
+      k--;
+    }
+
+    // The task names are only valid during the frame, so copy them.
+    Frame &frame = m.mWorst[k];
+    frame.elapsed = elapsed;
+    frame.taskCount = m.mTaskCount;
+    for (int j = 0; j < m.mTaskCount; j++)
+    {
+      strncpy(frame.tasks[j].name, m.mTaskNames[j], nameLength);
+      frame.tasks[j].name[nameLength] = 0;
+      frame.tasks[j].elapsed = m.mTaskTimes[j];
+    }
+  }
+
+  uint32_t DeadlineMonitor::getFrameCount()
+  {
+    return singleton().mFrameCount;
+  }
+
+  uint32_t DeadlineMonitor::getOverrunCount()
+  {
+    return singleton().mOverrunCount;
+  }
+
+  uint32_t DeadlineMonitor::getThrottledCount()
+  {
+    return Pump_getThrottledCount() - singleton().mThrottledAtReset;
+  }
+
+  int DeadlineMonitor::getBucketCount()
+  {
+    return bucketCount;
+  }
+
+  uint32_t DeadlineMonitor::getBucket(int i)
+  {
+    if (i < 0 || i >= bucketCount)
+    {
+      return 0;
+    }
+    return singleton().mBuckets[i];
+  }
+
+  float DeadlineMonitor::getBucketLimit(int i)
+  {
+    // Upper edge of the bucket.  The last bucket also holds everything above it.
+    return powf(2.0f, 0.5f * (i - overrunBucket + 1));
+  }
+
+  int DeadlineMonitor::getWorstFrameCount()
+  {
+    return singleton().mWorstCount;
+  }
+
+  float DeadlineMonitor::getWorstLoad(int i)
+  {
+    DeadlineMonitor &m = singleton();
+    if (i < 0 || i >= m.mWorstCount || m.mDeadline == 0)
+    {
+      return 0.0f;
+    }
+    return (float)m.mWorst[i].elapsed / (float)m.mDeadline;
+  }
+
+  int DeadlineMonitor::getWorstTaskCount(int i)
+  {
+    DeadlineMonitor &m = singleton();
+    if (i < 0 || i >= m.mWorstCount)
+    {
+      return 0;
+    }
+    return m.mWorst[i].taskCount;
+  }
+
+  const char *DeadlineMonitor::getWorstTaskName(int i, int j)
+  {
+    DeadlineMonitor &m = singleton();
+    if (i < 0 || i >= m.mWorstCount || j < 0 || j >= m.mWorst[i].taskCount)
+    {
+      return "";
+    }
+    return m.mWorst[i].tasks[j].name;
+  }
+
+  float DeadlineMonitor::getWorstTaskLoad(int i, int j)
+  {
+    DeadlineMonitor &m = singleton();
+    if (i < 0 || i >= m.mWorstCount || j < 0 || j >= m.mWorst[i].taskCount || m.mDeadline == 0)
+    {
+      return 0.0f;
+    }
+    return (float)m.mWorst[i].tasks[j].elapsed / (float)m.mDeadline;
+  }
+
+  void DeadlineMonitor::print()
+  {
+    DeadlineMonitor &m = singleton();
+    logInfo("DeadlineMonitor: %lu frames, %lu overruns, %lu throttled",
+            (unsigned long)getFrameCount(),
+            (unsigned long)getOverrunCount(),
+            (unsigned long)getThrottledCount());
+
+    float lower = 0.0f;
+    for (int i = 0; i < bucketCount; i++)
+    {
+      float upper = getBucketLimit(i);
+      if (m.mBuckets[i] > 0)
+      {
+        if (i == bucketCount - 1)
+        {
+          logInfo("  >= %5.1f%%: %lu", 100.0f * lower, (unsigned long)m.mBuckets[i]);
+        }
+        else
+        {
+          logInfo("  %5.1f%% - %5.1f%%: %lu", 100.0f * lower, 100.0f * upper,
+                  (unsigned long)m.mBuckets[i]);
+        }
+      }
+      lower = upper;
+    }
+
+    for (int i = 0; i < m.mWorstCount; i++)
+    {
+      logInfo("worst #%d: %5.1f%%", i + 1, 100.0f * getWorstLoad(i));
+      for (int j = 0; j < m.mWorst[i].taskCount; j++)
+      {
+        logInfo("  %s: %5.1f%%", getWorstTaskName(i, j), 100.0f * getWorstTaskLoad(i, j));
+      }
+    }
+  }
+
+} // namespace od
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <hal/timing.h>
+#include <stdint.h>
+
+namespace od
+{
+
+  // Measures how long each audio frame takes to render relative to its
+  // deadline (the frame period).  Keeps a log-scaled histogram of frame
+  // loads, the worst frames seen so far along with the per-task breakdown
+  // at that moment, and overrun/throttle counters.
+  class DeadlineMonitor
+  {
+  public:
+    // Takes effect at the start of the next frame.
+    static void reset();
+    static void print();
+
+    static uint32_t getFrameCount();
+    static uint32_t getOverrunCount();
+    // Frames skipped by the pump because the UI was being starved.
+    static uint32_t getThrottledCount();
+
+    // Loads are fractions of the deadline (1.0 = the whole frame period).
+    static int getBucketCount();
+    static uint32_t getBucket(int i);
+    static float getBucketLimit(int i);
+
+    // Worst frames in decreasing order of load.
+    static int getWorstFrameCount();
+    static float getWorstLoad(int i);
+    static int getWorstTaskCount(int i);
+    static const char *getWorstTaskName(int i, int j);
+    static float getWorstTaskLoad(int i, int j);
+
+#ifndef SWIGLUA
+    static const int bucketCount = 16;
+    // Bucket i holds loads in [2^((i - overrunBucket) / 2), 2^((i - overrunBucket + 1) / 2)).
+    static const int overrunBucket = 12;
+    static const int worstCount = 8;
+    static const int maximumTasks = 32;
+    static const int nameLength = 15;
+
+    // Audio thread only.
+    static void beginFrame();
+    static void endTask(const char *name);
+    static void endFrame();
+#endif
+
+  private:
+    DeadlineMonitor();
+    static DeadlineMonitor &singleton();
+
+    struct TaskTime
+    {
+      char name[nameLength + 1];
+      tick_t elapsed;
+    };
+
+    struct Frame
+    {
+      tick_t elapsed = 0;
+      int taskCount = 0;
+      TaskTime tasks[maximumTasks];
+    };
+
+    void clear();
+
+    uint32_t mBuckets[bucketCount];
+    uint32_t mFrameCount = 0;
+    uint32_t mOverrunCount = 0;
+    uint32_t mThrottledAtReset = 0;
+    volatile bool mResetRequested = false;
+
+    Frame mWorst[worstCount];
+    int mWorstCount = 0;
+
+    // Scratch for the frame in progress.
+    tick_t mFrameStart = 0;
+    tick_t mTaskStart = 0;
+    int mTaskCount = 0;
+    const char *mTaskNames[maximumTasks];
+    tick_t mTaskTimes[maximumTasks];
+
+    tick_t mDeadline = 0;
+  };
+
+} // namespace od
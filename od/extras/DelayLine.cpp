@@ -0,0 +1,213 @@
+#include <od/extras/DelayLine.h>
+#include <od/extras/BigHeap.h>
+#include <od/extras/MemoryTracker.h>
+#include <od/config.h>
+#include <hal/ops.h>
+#include <string.h>
+
+namespace od
+{
+
+  DelayLine::DelayLine()
+  {
+  }
+
+  DelayLine::~DelayLine()
+  {
+    deallocate();
+  }
+
+  bool DelayLine::allocate(int maxDelayInSamples)
+  {
+    deallocate();
+
+    // Room for the longest delay plus the block being written, in whole
+    // blocks of 4 (see write4()).
+    int length = 4 * ((MAX(4, maxDelayInSamples) + 3) / 4) + FRAMELENGTH;
+    // Enough for a frame-long read plus a cubic neighborhood.
+    int guard = FRAMELENGTH + 4;
+    int nbytes = (length + guard) * sizeof(float);
+
+    mpBuffer = (float *)BigHeap::allocateZeroed(nbytes);
+    if (mpBuffer == 0)
+    {
+      return false;
+    }
+    MemoryTracker::allocated(MEMORY_DELAYLINES, nbytes);
+
+    mLength = length;
+    mGuard = guard;
+    mMaxDelay = length - FRAMELENGTH;
+    mHead = 0;
+    return true;
+  }
+
+  void DelayLine::deallocate()
+  {
+    if (mpBuffer)
+    {
+      MemoryTracker::freed(MEMORY_DELAYLINES, (mLength + mGuard) * sizeof(float));
+      BigHeap::free((char *)mpBuffer);
+      mpBuffer = 0;
+    }
+    mLength = 0;
+    mGuard = 0;
+    mMaxDelay = 0;
+    mHead = 0;
+  }
+
+  void DelayLine::zero()
+  {
+    if (mpBuffer)
+    {
+      bzero(mpBuffer, (mLength + mGuard) * sizeof(float));
+    }
+  }
+
+  void DelayLine::write(const float *in, int n)
+  {
+    int first = MIN(n, mLength - mHead);
+    memcpy(mpBuffer + mHead, in, first * sizeof(float));
+    if (mHead < mGuard)
+    {
+      // mirror
+      int m = MIN(first, mGuard - mHead);
+      memcpy(mpBuffer + mLength + mHead, in, m * sizeof(float));
+    }
+
+    int second = n - first;
+    if (second > 0)
+    {
+      memcpy(mpBuffer, in + first, second * sizeof(float));
+      // mirror
+      int m = MIN(second, mGuard);
+      memcpy(mpBuffer + mLength, in + first, m * sizeof(float));
+    }
+  }
+
+  void DelayLine::advance(int n)
+  {
+    mHead += n;
+    if (mHead >= mLength)
+    {
+      mHead -= mLength;
+    }
+  }
+
+  void DelayLine::read(float *out, int delay, int n)
+  {
+    delay = CLAMP(0, mMaxDelay, delay);
+    int start = mHead - delay;
+    if (start < 0)
+    {
+      start += mLength;
+    }
+    memcpy(out, mpBuffer + start, n * sizeof(float));
+  }
+
+  inline int32x4_t DelayLine::neighborhood(int i, const float *delay,
+                                           int pre, int post,
+                                           float32x4_t *frac)
+  {
+    const float steps[4] = {0.0f, 1.0f, 2.0f, 3.0f};
+    float32x4_t d = vld1q_f32(delay + i);
+    d = vmaxq_f32(vdupq_n_f32(post), d);
+    d = vminq_f32(vdupq_n_f32(mMaxDelay - pre), d);
+
+    // position relative to the write head (always positive)
+    float32x4_t x = vdupq_n_f32(mLength + i) + vld1q_f32(steps) - d;
+    int32x4_t x0 = vcvtq_s32_f32(x);
+    *frac = x - vcvtq_f32_s32(x0);
+
+    // wrap into [0, mLength)
+    int32x4_t p = vaddq_s32(x0, vdupq_n_s32(mHead - pre));
+    int32x4_t L = vdupq_n_s32(mLength);
+    uint32x4_t over = vcgeq_s32(p, L);
+    p = vsubq_s32(p, vandq_s32(L, vreinterpretq_s32_u32(over)));
+    over = vcgeq_s32(p, L);
+    p = vsubq_s32(p, vandq_s32(L, vreinterpretq_s32_u32(over)));
+    return p;
+  }
+
+  void DelayLine::readLinear(float *out, const float *delay, int n)
+  {
+    float32x4_t one = vdupq_n_f32(1.0f);
+    int32_t P[4];
+    float Y0[4], Y1[4];
+
+    for (int i = 0; i < n; i += 4)
+    {
+      float32x4_t w1;
+      vst1q_s32(P, neighborhood(i, delay, 0, 1, &w1));
+      for (int j = 0; j < 4; j++)
+      {
+        const float *y = mpBuffer + P[j];
+        Y0[j] = y[0];
+        Y1[j] = y[1];
+      }
+      float32x4_t w0 = one - w1;
+      vst1q_f32(out + i, w0 * vld1q_f32(Y0) + w1 * vld1q_f32(Y1));
+    }
+  }
+
+  void DelayLine::readQuadratic(float *out, const float *delay, int n)
+  {
+    float32x4_t half = vdupq_n_f32(0.5f);
+    int32_t P[4];
+    float Ym[4], Y0[4], Y1[4];
+
+    for (int i = 0; i < n; i += 4)
+    {
+      float32x4_t f;
+      vst1q_s32(P, neighborhood(i, delay, 1, 1, &f));
+      for (int j = 0; j < 4; j++)
+      {
+        const float *y = mpBuffer + P[j];
+        Ym[j] = y[0];
+        Y0[j] = y[1];
+        Y1[j] = y[2];
+      }
+      float32x4_t ym = vld1q_f32(Ym);
+      float32x4_t y0 = vld1q_f32(Y0);
+      float32x4_t y1 = vld1q_f32(Y1);
+      // y0 + f * (0.5 * (y1 - ym) + 0.5 * f * (y1 + ym - 2 * y0))
+      float32x4_t c1 = half * (y1 - ym);
+      float32x4_t c2 = half * (y1 + ym) - y0;
+      vst1q_f32(out + i, vmlaq_f32(y0, f, vmlaq_f32(c1, f, c2)));
+    }
+  }
+
+  void DelayLine::readCubic(float *out, const float *delay, int n)
+  {
+    float32x4_t half = vdupq_n_f32(0.5f);
+    float32x4_t onePointFive = vdupq_n_f32(1.5f);
+    float32x4_t two = vdupq_n_f32(2.0f);
+    float32x4_t twoPointFive = vdupq_n_f32(2.5f);
+    int32_t P[4];
+    float Ym[4], Y0[4], Y1[4], Y2[4];
+
+    for (int i = 0; i < n; i += 4)
+    {
+      float32x4_t f;
+      vst1q_s32(P, neighborhood(i, delay, 1, 2, &f));
+      for (int j = 0; j < 4; j++)
+      {
+        const float *y = mpBuffer + P[j];
+        Ym[j] = y[0];
+        Y0[j] = y[1];
+        Y1[j] = y[2];
+        Y2[j] = y[3];
+      }
+      float32x4_t ym = vld1q_f32(Ym);
+      float32x4_t y0 = vld1q_f32(Y0);
+      float32x4_t y1 = vld1q_f32(Y1);
+      float32x4_t y2 = vld1q_f32(Y2);
+      // 4-point, 3rd-order Hermite (Catmull-Rom)
+      float32x4_t c1 = half * (y1 - ym);
+      float32x4_t c2 = ym - twoPointFive * y0 + two * y1 - half * y2;
+      float32x4_t c3 = half * (y2 - ym) + onePointFive * (y0 - y1);
+      vst1q_f32(out + i, vmlaq_f32(y0, f, vmlaq_f32(c1, f, vmlaq_f32(c2, f, c3))));
+    }
+  }
+
+} /* namespace od */
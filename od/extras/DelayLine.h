@@ -0,0 +1,99 @@
+#pragma once
+
+#include <hal/simd.h>
+
+namespace od
+{
+
+  // Circular delay line whose first samples are mirrored into a guard region
+  // past the end of the buffer, so that reads of up to a frame (plus the
+  // interpolation neighborhood) are always contiguous in memory.
+  //
+  // Samples are addressed relative to the write head: sample i of a block
+  // is written at head + i and a tap with delay d reads at head + i - d.
+  // Write the block before reading taps that are shorter than the block.
+  class DelayLine
+  {
+  public:
+    DelayLine();
+    virtual ~DelayLine();
+
+    // Returns false if the memory could not be allocated.
+    bool allocate(int maxDelayInSamples);
+    void deallocate();
+    void zero();
+
+    bool allocated()
+    {
+      return mpBuffer != 0;
+    }
+
+    int maxDelay()
+    {
+      return mMaxDelay;
+    }
+
+    // Write n samples at the write head (without advancing it).
+    void write(const float *in, int n);
+    // Move the write head forward n samples.
+    void advance(int n);
+    // write() then advance()
+    void push(const float *in, int n)
+    {
+      write(in, n);
+      advance(n);
+    }
+
+    // Single tap with a fixed integer delay (n <= FRAMELENGTH).
+    void read(float *out, int delay, int n);
+
+    // Four samples at a time, for feedback loops shorter than a frame.  The
+    // head must only ever be advanced by multiples of 4, and the delay must
+    // be a multiple of 4 in [0, maxDelay()].
+    inline void write4(float32x4_t x)
+    {
+      vst1q_f32(mpBuffer + mHead, x);
+      if (mHead < mGuard)
+      {
+        // mirror
+        vst1q_f32(mpBuffer + mLength + mHead, x);
+      }
+    }
+
+    inline void push4(float32x4_t x)
+    {
+      write4(x);
+      mHead += 4;
+      if (mHead >= mLength)
+      {
+        mHead -= mLength;
+      }
+    }
+
+    inline float32x4_t read4(int delay)
+    {
+      int start = mHead - delay;
+      if (start < 0)
+      {
+        start += mLength;
+      }
+      return vld1q_f32(mpBuffer + start);
+    }
+    // Per-sample fractional delays (in samples), n must be a multiple of 4.
+    void readLinear(float *out, const float *delay, int n);
+    void readQuadratic(float *out, const float *delay, int n);
+    void readCubic(float *out, const float *delay, int n);
+
+  private:
+    float *mpBuffer = 0;
+    int mLength = 0;
+    int mGuard = 0;
+    int mMaxDelay = 0;
+    int mHead = 0;
+
+    // Start of the interpolation neighborhood (pre) for 4 taps.
+    inline int32x4_t neighborhood(int i, const float *delay, int pre,
+                                  int post, float32x4_t *frac);
+  };
+
+} /* namespace od */
@@ -0,0 +1,1081 @@
+#include <od/extras/FileIndex.h>
+#include <od/extras/FileReader.h>
+#include <od/extras/FileWriter.h>
+#include <od/extras/Utils.h>
+#include <od/audio/WavFileReader.h>
+#include <od/ui/JobQueue.h>
+#include <hal/concurrency/Mutex.h>
+#include <hal/fileops.h>
+#include <hal/dir.h>
+#include <hal/log.h>
+#include <hal/ops.h>
+#include <algorithm>
+#include <deque>
+#include <map>
+#include <math.h>
+#include <string.h>
+
+namespace od
+{
+
+  static const char *description = "FileIndex";
+  static const uint32_t formatVersion = 2;
+
+  bool FileIndexEntry::isDirectory() const
+  {
+    return attributes & FILEOPS_DIR;
+  }
+
+  bool FileIndexEntry::isSoundFile() const
+  {
+    return !isDirectory() && glob(name.c_str(), "*.WAV");
+  }
+
+  float FileIndexEntry::getTotalSeconds() const
+  {
+    if (sampleRate > 0.0f)
+    {
+      return sampleCount / sampleRate;
+    }
+    return 0.0f;
+  }
+
+  struct IndexedDirectory
+  {
+    // Sorted by name.
+    std::vector<FileIndexEntry> entries;
+    // Mount generation of the last read from the card (0 if never).
+    uint32_t generation = 0;
+  };
+
+  class ScanJob : public Job
+  {
+  public:
+    virtual void work();
+    virtual const char *getTraceName()
+    {
+      return "FileIndex::scan";
+    }
+  };
+
+  struct FileIndexLocals
+  {
+    FileIndexLocals()
+    {
+      job.attach();
+      queue.attach();
+      queue.start();
+    }
+
+    Mutex mutex;
+    std::map<std::string, IndexedDirectory> directories;
+    uint32_t generation = 1;
+    std::string filename;
+    bool dirty = false;
+
+    std::deque<std::string> pending;
+    // Directories written to since they were read.  Only the directory itself
+    // is read again, plus any subdirectory the index does not know yet.
+    std::deque<std::string> refreshes;
+    // Sound files waiting for an overview, served ahead of the scan.
+    std::deque<std::string> overviews;
+    bool running = false;
+    ScanJob job;
+    JobQueue queue{"fidx"};
+
+    // Held while writing the index file.
+    Mutex saving;
+  };
+
+  // Created on first use, from the UI thread.
+  static FileIndexLocals *local = 0;
+
+  static FileIndexLocals &locals()
+  {
+    if (local == 0)
+    {
+      local = new FileIndexLocals();
+    }
+    return *local;
+  }
+
+  static inline std::string joinPath(const std::string &path,
+                                     const std::string &name)
+  {
+    std::string result;
+    result.reserve(path.size() + name.size() + 1);
+    result.append(path);
+    result.push_back('/');
+    result.append(name);
+    return result;
+  }
+
+  static inline bool byName(const FileIndexEntry &a, const FileIndexEntry &b)
+  {
+    return a.name < b.name;
+  }
+
+  static inline bool sameFile(const FileIndexEntry &a, const FileIndexEntry &b)
+  {
+    return a.isDirectory() == b.isDirectory() && a.size == b.size &&
+           a.modified == b.modified;
+  }
+
+  static std::vector<FileIndexEntry>::iterator
+  findEntry(std::vector<FileIndexEntry> &entries, const std::string &name)
+  {
+    FileIndexEntry key;
+    key.name = name;
+    auto i = std::lower_bound(entries.begin(), entries.end(), key, byName);
+    if (i != entries.end() && i->name == name)
+    {
+      return i;
+    }
+    return entries.end();
+  }
+
+  static bool readDirectory(const std::string &path,
+                            std::vector<FileIndexEntry> &entries)
+  {
+    char *tmp;
+    uint32_t attributes;
+    uint64_t size;
+    uint32_t modified;
+
+    dir_t dir = Dir_open(path.c_str());
+    if (dir == 0)
+    {
+      return false;
+    }
+
+    while (Dir_readInfo(dir, &tmp, &attributes, &size, &modified))
+    {
+      if (attributes & (FILEOPS_HID | FILEOPS_SYS))
+      {
+        // ignore hidden and system files
+        continue;
+      }
+      else if (tmp[0] == '.')
+      {
+        // ignore dot files
+        continue;
+      }
+
+      entries.emplace_back();
+      FileIndexEntry &entry = entries.back();
+      entry.name = tmp;
+      entry.attributes = attributes;
+      entry.size = size;
+      entry.modified = modified;
+    }
+
+    Dir_close(dir);
+
+    std::sort(entries.begin(), entries.end(), byName);
+    return true;
+  }
+
+  static void probe(const std::string &path, FileIndexEntry &entry)
+  {
+    WavFileReader reader;
+    entry.probed = true;
+    if (reader.open(path))
+    {
+      entry.channelCount = reader.getChannelCount();
+      entry.sampleRate = reader.getSampleRate();
+      entry.sampleCount = reader.getSampleCount();
+      entry.cueCount = reader.getCueCount();
+      reader.close();
+    }
+    else
+    {
+      // Unreadable.  Not tried again until the file changes.
+      entry.channelCount = 0;
+      entry.sampleRate = 0.0f;
+      entry.sampleCount = 0;
+      entry.cueCount = 0;
+    }
+  }
+
+  // Peak of a short window at the start of each bin, so that a long file
+  // costs a few seeks instead of a full read.
+  static void sketch(const std::string &path, FileIndexEntry &entry)
+  {
+    const uint32_t windowSize = 256;
+    const int n = FileIndex::overviewSize;
+    WavFileReader reader;
+
+    entry.overview.clear();
+    if (!reader.open(path))
+    {
+      return;
+    }
+
+    int channelCount = reader.getChannelCount();
+    uint32_t sampleCount = reader.getSampleCount();
+    std::vector<float> buffer(windowSize * channelCount);
+    std::vector<uint8_t> overview(n, 0);
+
+    for (int bin = 0; bin < n; bin++)
+    {
+      uint32_t start = (uint64_t)bin * sampleCount / n;
+      uint32_t end = (uint64_t)(bin + 1) * sampleCount / n;
+      uint32_t count = MIN(end - start, windowSize);
+      if (count == 0)
+      {
+        continue;
+      }
+
+      if (reader.seekSamples(start) != start ||
+          reader.readSamples(buffer.data(), count) != count)
+      {
+        reader.close();
+        return;
+      }
+
+      float peak = 0.0f;
+      for (uint32_t i = 0; i < count * channelCount; i++)
+      {
+        peak = MAX(peak, fabsf(buffer[i]));
+      }
+      overview[bin] = (uint8_t)(MIN(peak, 1.0f) * 255.0f + 0.5f);
+    }
+
+    reader.close();
+    entry.overview.swap(overview);
+  }
+
+  // Forget a directory and everything below it.  Call with the mutex held.
+  static void eraseTree(FileIndexLocals &L, const std::string &path)
+  {
+    L.directories.erase(path);
+    std::string prefix = path + '/';
+    auto i = L.directories.lower_bound(prefix);
+    while (i != L.directories.end() && startsWith(i->first, prefix))
+    {
+      i = L.directories.erase(i);
+    }
+    L.dirty = true;
+  }
+
+  // Replace the listing of a directory with one that was just read, keeping
+  // the probed details of files that did not change.  Call with the mutex
+  // held.
+  static std::vector<FileIndexEntry> &store(FileIndexLocals &L,
+                                            const std::string &path,
+                                            std::vector<FileIndexEntry> &fresh)
+  {
+    IndexedDirectory &dir = L.directories[path];
+    std::vector<FileIndexEntry> &old = dir.entries;
+    bool changed = old.size() != fresh.size();
+
+    // Both lists are sorted by name.
+    auto j = old.begin();
+    for (FileIndexEntry &entry : fresh)
+    {
+      while (j != old.end() && j->name < entry.name)
+      {
+        if (j->isDirectory())
+        {
+          eraseTree(L, joinPath(path, j->name));
+        }
+        changed = true;
+        j++;
+      }
+
+      if (j != old.end() && j->name == entry.name)
+      {
+        if (sameFile(*j, entry))
+        {
+          entry.probed = j->probed;
+          entry.channelCount = j->channelCount;
+          entry.sampleRate = j->sampleRate;
+          entry.sampleCount = j->sampleCount;
+          entry.cueCount = j->cueCount;
+          entry.overview = j->overview;
+        }
+        else
+        {
+          if (j->isDirectory() && !entry.isDirectory())
+          {
+            eraseTree(L, joinPath(path, j->name));
+          }
+          changed = true;
+        }
+        j++;
+      }
+      else
+      {
+        changed = true;
+      }
+    }
+
+    for (; j != old.end(); j++)
+    {
+      if (j->isDirectory())
+      {
+        eraseTree(L, joinPath(path, j->name));
+      }
+      changed = true;
+    }
+
+    // eraseTree() never touches this directory, so dir is still valid.
+    dir.entries.swap(fresh);
+    dir.generation = L.generation;
+    if (changed)
+    {
+      L.dirty = true;
+    }
+    return dir.entries;
+  }
+
+  // Probe a file outside of the lock and keep the result if the file is still
+  // the one that was listed.
+  static void probeAndStore(FileIndexLocals &L, const std::string &path,
+                            const FileIndexEntry &listed,
+                            FileIndexEntry *result = 0)
+  {
+    FileIndexEntry entry = listed;
+    probe(joinPath(path, entry.name), entry);
+
+    {
+      Lock lock(L.mutex);
+      auto d = L.directories.find(path);
+      if (d != L.directories.end())
+      {
+        auto i = findEntry(d->second.entries, entry.name);
+        if (i != d->second.entries.end() && sameFile(*i, entry))
+        {
+          *i = entry;
+          L.dirty = true;
+        }
+      }
+    }
+
+    if (result)
+    {
+      *result = entry;
+    }
+  }
+
+  // The listed entry for a file, or 0.  Call with the mutex held.
+  static FileIndexEntry *findListed(FileIndexLocals &L, const std::string &path)
+  {
+    size_t slash = path.find_last_of('/');
+    if (slash == std::string::npos)
+    {
+      return 0;
+    }
+
+    auto d = L.directories.find(path.substr(0, slash));
+    if (d == L.directories.end())
+    {
+      return 0;
+    }
+
+    auto i = findEntry(d->second.entries, path.substr(slash + 1));
+    if (i == d->second.entries.end())
+    {
+      return 0;
+    }
+    return &(*i);
+  }
+
+  static void sketchAndStore(FileIndexLocals &L, const std::string &path)
+  {
+    FileIndexEntry entry;
+    if (!FileIndex::getInfo(path, entry) || entry.channelCount <= 0 ||
+        !entry.overview.empty())
+    {
+      return;
+    }
+
+    sketch(path, entry);
+    if (entry.overview.empty())
+    {
+      logWarn("FileIndex: failed to read an overview of %s", path.c_str());
+      return;
+    }
+
+    Lock lock(L.mutex);
+    FileIndexEntry *listed = findListed(L, path);
+    if (listed && sameFile(*listed, entry))
+    {
+      listed->overview.swap(entry.overview);
+      L.dirty = true;
+    }
+  }
+
+  // Overviews are waited on by the UI, so they go ahead of the scan.
+  static void serveOverviews(FileIndexLocals &L)
+  {
+    std::string path;
+    while (true)
+    {
+      {
+        Lock lock(L.mutex);
+        if (L.overviews.empty())
+        {
+          return;
+        }
+        path = L.overviews.front();
+        L.overviews.pop_front();
+      }
+      sketchAndStore(L, path);
+    }
+  }
+
+  static void startJob(FileIndexLocals &L)
+  {
+    // The last run may still be on its way out of the queue.
+    L.job.wait();
+    L.queue.push(&L.job);
+  }
+
+  void ScanJob::work()
+  {
+    FileIndexLocals &L = *local;
+    std::string path;
+    std::vector<FileIndexEntry> fresh;
+    std::vector<FileIndexEntry> unprobed;
+    bool scanned = false;
+    bool recursive = true;
+
+    while (!mCancelRequested)
+    {
+      serveOverviews(L);
+
+      {
+        Lock lock(L.mutex);
+        if (!L.refreshes.empty())
+        {
+          path = L.refreshes.front();
+          L.refreshes.pop_front();
+          recursive = false;
+        }
+        else if (!L.pending.empty())
+        {
+          path = L.pending.front();
+          L.pending.pop_front();
+          recursive = true;
+        }
+        else
+        {
+          if (L.overviews.empty())
+          {
+            L.running = false;
+            break;
+          }
+          continue;
+        }
+      }
+
+      scanned = true;
+      fresh.clear();
+      if (!readDirectory(path, fresh))
+      {
+        Lock lock(L.mutex);
+        eraseTree(L, path);
+        continue;
+      }
+
+      unprobed.clear();
+      {
+        Lock lock(L.mutex);
+        for (FileIndexEntry &entry : store(L, path, fresh))
+        {
+          if (entry.isDirectory())
+          {
+            std::string child = joinPath(path, entry.name);
+            auto d = L.directories.find(child);
+            if (recursive || d == L.directories.end() ||
+                d->second.generation != L.generation)
+            {
+              L.pending.push_back(child);
+            }
+          }
+          else if (!entry.probed && entry.isSoundFile())
+          {
+            unprobed.push_back(entry);
+          }
+        }
+      }
+
+      for (FileIndexEntry &entry : unprobed)
+      {
+        if (mCancelRequested)
+        {
+          break;
+        }
+        serveOverviews(L);
+        probeAndStore(L, path, entry);
+      }
+    }
+
+    // Overviews alone are saved with the next scan or on close().
+    if (scanned && !mCancelRequested)
+    {
+      FileIndex::save();
+    }
+  }
+
+  bool FileIndex::list(const std::string &path,
+                       std::vector<FileIndexEntry> &entries, bool validate)
+  {
+    FileIndexLocals &L = locals();
+
+    if (!validate)
+    {
+      Lock lock(L.mutex);
+      auto d = L.directories.find(path);
+      if (d != L.directories.end() && d->second.generation == L.generation)
+      {
+        entries = d->second.entries;
+        return true;
+      }
+    }
+
+    std::vector<FileIndexEntry> fresh;
+    if (!readDirectory(path, fresh))
+    {
+      Lock lock(L.mutex);
+      eraseTree(L, path);
+      entries.clear();
+      return false;
+    }
+
+    Lock lock(L.mutex);
+    entries = store(L, path, fresh);
+    return true;
+  }
+
+  bool FileIndex::getInfo(const std::string &path, FileIndexEntry &entry)
+  {
+    FileIndexLocals &L = locals();
+    size_t slash = path.find_last_of('/');
+    if (slash == std::string::npos)
+    {
+      return false;
+    }
+    std::string parent = path.substr(0, slash);
+    std::string name = path.substr(slash + 1);
+
+    for (int attempt = 0; attempt < 2; attempt++)
+    {
+      if (attempt > 0)
+      {
+        // Not listed yet, so read the whole directory once.
+        std::vector<FileIndexEntry> entries;
+        if (!list(parent, entries, true))
+        {
+          return false;
+        }
+      }
+
+      FileIndexEntry listed;
+      {
+        Lock lock(L.mutex);
+        auto d = L.directories.find(parent);
+        if (d == L.directories.end())
+        {
+          continue;
+        }
+        auto i = findEntry(d->second.entries, name);
+        if (i == d->second.entries.end())
+        {
+          continue;
+        }
+        if (i->probed || !i->isSoundFile())
+        {
+          entry = *i;
+          return true;
+        }
+        listed = *i;
+      }
+
+      probeAndStore(L, parent, listed, &entry);
+      return true;
+    }
+
+    return false;
+  }
+
+  bool FileIndex::getOverview(const std::string &path,
+                              std::vector<uint8_t> &peaks, bool request)
+  {
+    FileIndexLocals &L = locals();
+    bool start = false;
+
+    {
+      Lock lock(L.mutex);
+      FileIndexEntry *entry = findListed(L, path);
+      if (entry)
+      {
+        if (!entry->overview.empty())
+        {
+          peaks = entry->overview;
+          return true;
+        }
+        if (!entry->isSoundFile() || (entry->probed && entry->channelCount <= 0))
+        {
+          return false;
+        }
+      }
+
+      if (!request)
+      {
+        return false;
+      }
+
+      if (std::find(L.overviews.begin(), L.overviews.end(), path) ==
+          L.overviews.end())
+      {
+        L.overviews.push_back(path);
+      }
+      if (!L.running)
+      {
+        L.running = true;
+        start = true;
+      }
+    }
+
+    if (start)
+    {
+      startJob(L);
+    }
+    return false;
+  }
+
+  int FileIndex::getChannelCount(const std::string &path)
+  {
+    FileIndexEntry entry;
+    if (getInfo(path, entry) && entry.channelCount > 0)
+    {
+      return entry.channelCount;
+    }
+    return -1;
+  }
+
+  float FileIndex::getTotalSeconds(const std::string &path)
+  {
+    FileIndexEntry entry;
+    if (getInfo(path, entry) && entry.channelCount > 0)
+    {
+      return entry.getTotalSeconds();
+    }
+    return -1.0f;
+  }
+
+  int FileIndex::getCueCount(const std::string &path)
+  {
+    FileIndexEntry entry;
+    if (getInfo(path, entry) && entry.channelCount > 0)
+    {
+      return entry.cueCount;
+    }
+    return -1;
+  }
+
+  std::vector<std::string> FileIndex::find(const std::string &prefix,
+                                           const std::string &pattern,
+                                           int limit)
+  {
+    FileIndexLocals &L = locals();
+    std::vector<std::string> result;
+    std::string below = prefix + '/';
+
+    Lock lock(L.mutex);
+    // Directories are sorted by path, so the tree below prefix is contiguous.
+    auto d = L.directories.lower_bound(prefix);
+    for (; d != L.directories.end(); d++)
+    {
+      if (d->first != prefix && !startsWith(d->first, below))
+      {
+        break;
+      }
+      if (d->second.generation != L.generation)
+      {
+        continue;
+      }
+      for (const FileIndexEntry &entry : d->second.entries)
+      {
+        if (!entry.isDirectory() && glob(entry.name.c_str(), pattern.c_str()))
+        {
+          result.push_back(joinPath(d->first, entry.name));
+          if (limit > 0 && (int)result.size() == limit)
+          {
+            std::sort(result.begin(), result.end());
+            return result;
+          }
+        }
+      }
+    }
+
+    std::sort(result.begin(), result.end());
+    return result;
+  }
+
+  void FileIndex::scan(const std::string &path)
+  {
+    FileIndexLocals &L = locals();
+    bool start = false;
+
+    {
+      Lock lock(L.mutex);
+      L.pending.push_back(path);
+      if (!L.running)
+      {
+        L.running = true;
+        start = true;
+      }
+    }
+
+    if (start)
+    {
+      startJob(L);
+    }
+  }
+
+  void FileIndex::cancel()
+  {
+    FileIndexLocals &L = locals();
+
+    {
+      Lock lock(L.mutex);
+      L.pending.clear();
+      L.refreshes.clear();
+      L.overviews.clear();
+    }
+
+    L.queue.cancel(&L.job);
+    L.job.wait();
+
+    Lock lock(L.mutex);
+    L.running = false;
+  }
+
+  bool FileIndex::isScanning()
+  {
+    FileIndexLocals &L = locals();
+    Lock lock(L.mutex);
+    return L.running;
+  }
+
+  void FileIndex::invalidate(const std::string &path)
+  {
+    FileIndexLocals &L = locals();
+    bool start = false;
+
+    {
+      Lock lock(L.mutex);
+      auto d = L.directories.find(path);
+      if (d != L.directories.end())
+      {
+        d->second.generation = 0;
+      }
+
+      // Read it again in the background so that find() sees the change.
+      if (L.filename.empty())
+      {
+        return;
+      }
+      if (std::find(L.refreshes.begin(), L.refreshes.end(), path) ==
+          L.refreshes.end())
+      {
+        L.refreshes.push_back(path);
+      }
+      if (!L.running)
+      {
+        L.running = true;
+        start = true;
+      }
+    }
+
+    if (start)
+    {
+      startJob(L);
+    }
+  }
+
+  void FileIndex::invalidateParent(const std::string &path)
+  {
+    size_t slash = path.find_last_of('/');
+    if (slash != std::string::npos)
+    {
+      invalidate(path.substr(0, slash));
+    }
+  }
+
+  void FileIndex::clear()
+  {
+    FileIndexLocals &L = locals();
+    Lock lock(L.mutex);
+    L.directories.clear();
+    L.dirty = true;
+  }
+
+  int FileIndex::getDirectoryCount()
+  {
+    FileIndexLocals &L = locals();
+    Lock lock(L.mutex);
+    return (int)L.directories.size();
+  }
+
+  int FileIndex::getFileCount()
+  {
+    FileIndexLocals &L = locals();
+    Lock lock(L.mutex);
+    int count = 0;
+    for (auto &d : L.directories)
+    {
+      for (const FileIndexEntry &entry : d.second.entries)
+      {
+        if (!entry.isDirectory())
+        {
+          count++;
+        }
+      }
+    }
+    return count;
+  }
+
+  // File format, after the standard header:
+  //   directory count, then for each directory:
+  //     path, entry count, then for each entry:
+  //       name, attributes, size, modified, probed, channels, rate, samples,
+  //       cues, overview (8-bit length then the bins, since version 2)
+  // Strings are a 32-bit length followed by the characters.  Everything is
+  // little-endian.
+
+  template <typename T>
+  static inline void put(std::string &buffer, T value)
+  {
+    buffer.append((const char *)&value, sizeof(T));
+  }
+
+  static inline void putString(std::string &buffer, const std::string &value)
+  {
+    put<uint32_t>(buffer, value.size());
+    buffer.append(value);
+  }
+
+  template <typename T>
+  static inline bool get(const std::vector<char> &buffer, size_t &position,
+                         T &value)
+  {
+    if (position + sizeof(T) > buffer.size())
+    {
+      return false;
+    }
+    memcpy(&value, buffer.data() + position, sizeof(T));
+    position += sizeof(T);
+    return true;
+  }
+
+  static inline bool getString(const std::vector<char> &buffer,
+                               size_t &position, std::string &value)
+  {
+    uint32_t n;
+    if (!get(buffer, position, n) || n > buffer.size() - position)
+    {
+      return false;
+    }
+    value.assign(buffer.data() + position, n);
+    position += n;
+    return true;
+  }
+
+  bool FileIndex::save()
+  {
+    FileIndexLocals &L = locals();
+    Lock saving(L.saving);
+    std::string buffer;
+    std::string filename;
+
+    {
+      Lock lock(L.mutex);
+      if (L.filename.empty() || !L.dirty)
+      {
+        return false;
+      }
+      filename = L.filename;
+
+      put<uint32_t>(buffer, L.directories.size());
+      for (auto &d : L.directories)
+      {
+        putString(buffer, d.first);
+        put<uint32_t>(buffer, d.second.entries.size());
+        for (const FileIndexEntry &entry : d.second.entries)
+        {
+          putString(buffer, entry.name);
+          put<uint32_t>(buffer, entry.attributes);
+          put<uint64_t>(buffer, entry.size);
+          put<uint32_t>(buffer, entry.modified);
+          put<uint8_t>(buffer, entry.probed);
+          put<int32_t>(buffer, entry.channelCount);
+          put<float>(buffer, entry.sampleRate);
+          put<uint32_t>(buffer, entry.sampleCount);
+          put<int32_t>(buffer, entry.cueCount);
+          put<uint8_t>(buffer, entry.overview.size());
+          buffer.append((const char *)entry.overview.data(),
+                        entry.overview.size());
+        }
+      }
+      L.dirty = false;
+    }
+
+    FileWriter writer;
+    std::string tmpFilename = filename + ".tmp";
+    bool result = writer.open(tmpFilename) &&
+                  writer.writeHeader(description, formatVersion, 0) &&
+                  writer.writeBytes(buffer.data(), buffer.size()) == buffer.size();
+    writer.close();
+
+    if (result)
+    {
+      result = moveFile(tmpFilename.c_str(), filename.c_str(), true);
+    }
+
+    if (!result)
+    {
+      logWarn("FileIndex: failed to save %s", filename.c_str());
+      deleteFile(tmpFilename.c_str());
+      Lock lock(L.mutex);
+      L.dirty = true;
+    }
+
+    return result;
+  }
+
+  static bool load(FileIndexLocals &L, const std::string &filename)
+  {
+    FileReader reader;
+    std::string text;
+    uint32_t major, minor;
+
+    if (!reader.open(filename))
+    {
+      return false;
+    }
+
+    if (!reader.readHeader(text, major, minor) ||
+        strcmp(text.c_str(), description) != 0 || major < 1 ||
+        major > formatVersion)
+    {
+      logWarn("FileIndex: %s has the wrong format.", filename.c_str());
+      return false;
+    }
+
+    std::vector<char> buffer;
+    buffer.resize(reader.getSizeInBytes() - reader.tellBytes());
+    if (reader.readBytes(buffer.data(), buffer.size()) != buffer.size())
+    {
+      logWarn("FileIndex: failed to read %s", filename.c_str());
+      return false;
+    }
+
+    std::map<std::string, IndexedDirectory> directories;
+    size_t position = 0;
+    uint32_t directoryCount;
+    if (!get(buffer, position, directoryCount))
+    {
+      return false;
+    }
+
+    // Smallest stored entry: an empty name, the fixed fields and (from
+    // version 2) an empty overview.
+    const size_t minimumEntrySize =
+        sizeof(uint32_t) + sizeof(uint32_t) + sizeof(uint64_t) +
+        sizeof(uint32_t) + sizeof(uint8_t) + sizeof(int32_t) + sizeof(float) +
+        sizeof(uint32_t) + sizeof(int32_t) + (major >= 2 ? sizeof(uint8_t) : 0);
+
+    std::string path;
+    for (uint32_t i = 0; i < directoryCount; i++)
+    {
+      uint32_t entryCount;
+      if (!getString(buffer, position, path) ||
+          !get(buffer, position, entryCount))
+      {
+        logWarn("FileIndex: %s is truncated.", filename.c_str());
+        return false;
+      }
+
+      // Check the count before allocating for it.
+      if (entryCount > (buffer.size() - position) / minimumEntrySize)
+      {
+        logWarn("FileIndex: %s is corrupt.", filename.c_str());
+        return false;
+      }
+
+      // Untrusted (generation 0) until read again.
+      IndexedDirectory &dir = directories[path];
+      dir.entries.resize(entryCount);
+      for (FileIndexEntry &entry : dir.entries)
+      {
+        uint8_t probed;
+        int32_t channelCount, cueCount;
+        bool ok = getString(buffer, position, entry.name) &&
+                  get(buffer, position, entry.attributes) &&
+                  get(buffer, position, entry.size) &&
+                  get(buffer, position, entry.modified) &&
+                  get(buffer, position, probed) &&
+                  get(buffer, position, channelCount) &&
+                  get(buffer, position, entry.sampleRate) &&
+                  get(buffer, position, entry.sampleCount) &&
+                  get(buffer, position, cueCount);
+        if (ok && major >= 2)
+        {
+          uint8_t n;
+          ok = get(buffer, position, n) && position + n <= buffer.size();
+          if (ok)
+          {
+            entry.overview.assign(buffer.data() + position,
+                                  buffer.data() + position + n);
+            position += n;
+          }
+        }
+        if (!ok)
+        {
+          logWarn("FileIndex: %s is truncated.", filename.c_str());
+          return false;
+        }
+        entry.probed = probed;
+        entry.channelCount = channelCount;
+        entry.cueCount = cueCount;
+      }
+    }
+
+    Lock lock(L.mutex);
+    L.directories.swap(directories);
+    return true;
+  }
+
+  bool FileIndex::open(const std::string &filename)
+  {
+    FileIndexLocals &L = locals();
+    cancel();
+
+    {
+      Lock lock(L.mutex);
+      L.directories.clear();
+      L.generation++;
+      L.filename = filename;
+      L.dirty = false;
+    }
+
+    return load(L, filename);
+  }
+
+  void FileIndex::close()
+  {
+    FileIndexLocals &L = locals();
+    cancel();
+    save();
+
+    Lock lock(L.mutex);
+    L.filename.clear();
+    // Whatever is on the next card has to be read again.
+    L.generation++;
+  }
+
+} /* namespace od */
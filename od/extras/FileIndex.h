@@ -0,0 +1,111 @@
+#pragma once
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+namespace od
+{
+
+  struct FileIndexEntry
+  {
+    std::string name;
+    uint32_t attributes = 0;
+    uint64_t size = 0;
+    uint32_t modified = 0;
+
+    // Sound files only, valid once probed is set.
+    bool probed = false;
+    int channelCount = 0;
+    float sampleRate = 0.0f;
+    uint32_t sampleCount = 0;
+    int cueCount = 0;
+
+    // Coarse peak overview (0-255 per bin), empty until requested.
+    std::vector<uint8_t> overview;
+
+    bool isDirectory() const;
+    bool isSoundFile() const;
+    float getTotalSeconds() const;
+  };
+
+  // Cache of directory listings and sound file headers for the card.
+  //
+  // A background job walks the card after it is mounted, reading each
+  // directory and the header of every new or changed WAV file.  Entries are
+  // matched by name, size and modification time, so unchanged files are never
+  // opened again.  The index is saved to the card when a scan finishes and
+  // loaded again on the next mount, so only the first scan of a library has
+  // to read its headers.
+  //
+  // The peak overview of a sound file is only computed when something asks
+  // for it, from a short window at each bin, and is kept with the header
+  // details.
+  //
+  // Listings read before the current mount (or before invalidate()) are not
+  // trusted until the scan, or a caller asking to validate, reads them again.
+  // Hidden, system and dot files are not indexed.
+  class FileIndex
+  {
+  public:
+    // Load the index from a file (if it exists) and save it there from now
+    // on.  Every listing becomes untrusted.
+    static bool open(const std::string &filename);
+    // Stop scanning and save.  Call before the card is ejected.
+    static void close();
+    static bool save();
+
+    // Walk everything under path in the background.
+    static void scan(const std::string &path);
+    static void cancel();
+    static bool isScanning();
+
+    // Forget what is known about a directory (e.g. after writing to it) and
+    // read it again in the background.
+    static void invalidate(const std::string &path);
+    // Same for the directory holding a file.
+    static void invalidateParent(const std::string &path);
+    static void clear();
+
+    // Full paths of the files below prefix (recursively) whose names match
+    // the pattern, sorted.  Only uses trusted listings.  Zero limit means
+    // no limit.
+    static std::vector<std::string> find(const std::string &prefix,
+                                         const std::string &pattern,
+                                         int limit = 0);
+
+    // Sound file details, reading the header if it is not cached yet.
+    // Returns -1 (or a negative time) when the file cannot be read.
+    static int getChannelCount(const std::string &path);
+    static float getTotalSeconds(const std::string &path);
+    static int getCueCount(const std::string &path);
+
+    static int getDirectoryCount();
+    static int getFileCount();
+
+    // Number of bins in a sound file overview.
+    static const int overviewSize = 64;
+
+#ifndef SWIGLUA
+    // Fill entries (sorted by name) with the contents of a directory.  With
+    // validate set the card is always read, otherwise a trusted listing is
+    // used when there is one.
+    static bool list(const std::string &path,
+                     std::vector<FileIndexEntry> &entries,
+                     bool validate = true);
+
+    // Details of a single file, probing its header if it is a sound file.
+    static bool getInfo(const std::string &path, FileIndexEntry &entry);
+
+    // Peak overview of a sound file.  When it is not cached yet and request
+    // is set, it is computed in the background (ahead of any scan) and this
+    // returns false until it is ready.
+    static bool getOverview(const std::string &path,
+                            std::vector<uint8_t> &peaks, bool request = true);
+#endif
+
+  private:
+    FileIndex();
+  };
+
+} /* namespace od */
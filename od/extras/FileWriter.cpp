@@ -28,7 +28,7 @@ namespace od
     mFileDescriptor = ::open(mFilename.c_str(),
                              O_WRONLY | O_CREAT | O_TRUNC,
                              S_IRUSR | S_IWUSR | S_IRGRP | S_IWGRP | S_IROTH);
-    mIsOpen = mFileDescriptor != 0;
+    mIsOpen = mFileDescriptor >= 0;
 #else
     mIsOpen = f_open(&mFileDescriptor, mFilename.c_str(),
                      FA_READ | FA_WRITE | FA_CREATE_ALWAYS) == FR_OK;
@@ -0,0 +1,191 @@
+#include <od/extras/MemoryTracker.h>
+#include <od/extras/BigHeap.h>
+#include <od/extras/FileWriter.h>
+#include <hal/heap.h>
+#include <hal/timing.h>
+#include <hal/log.h>
+#include <atomic>
+#include <stdio.h>
+
+namespace od
+{
+
+  struct MemoryCounter
+  {
+    std::atomic<int> current;
+    std::atomic<int> peak;
+    std::atomic<uint32_t> count;
+    // Total bytes ever allocated (wraps around).
+    std::atomic<uint32_t> total;
+
+    // Only touched by sample().
+    uint32_t lastTotal;
+    float rate;
+  };
+
+  // Zero-initialized before any static constructor runs.
+  static MemoryCounter counters[MEMORY_CATEGORY_COUNT];
+  static tick_t lastSampleTime = 0;
+
+  static const char *categoryNames[MEMORY_CATEGORY_COUNT] = {
+      "frames",
+      "outlets",
+      "samples",
+      "slices",
+      "delaylines",
+      "grains",
+      "lua",
+      "graphics",
+      "other"};
+
+  static inline bool isValid(int category)
+  {
+    return category >= 0 && category < MEMORY_CATEGORY_COUNT;
+  }
+
+  void MemoryTracker::resize(int category, int oldBytes, int newBytes)
+  {
+    if (!isValid(category) || oldBytes == newBytes)
+    {
+      return;
+    }
+
+    MemoryCounter &c = counters[category];
+    int delta = newBytes - oldBytes;
+    int now = c.current.fetch_add(delta) + delta;
+    if (delta > 0)
+    {
+      c.count++;
+      c.total += delta;
+      int peak = c.peak.load();
+      while (now > peak && !c.peak.compare_exchange_weak(peak, now))
+      {
+      }
+    }
+  }
+
+  int MemoryTracker::getCategoryCount()
+  {
+    return MEMORY_CATEGORY_COUNT;
+  }
+
+  const char *MemoryTracker::getCategoryName(int category)
+  {
+    if (!isValid(category))
+    {
+      return "";
+    }
+    return categoryNames[category];
+  }
+
+  int MemoryTracker::getCurrent(int category)
+  {
+    if (!isValid(category))
+    {
+      return 0;
+    }
+    return counters[category].current;
+  }
+
+  int MemoryTracker::getPeak(int category)
+  {
+    if (!isValid(category))
+    {
+      return 0;
+    }
+    return counters[category].peak;
+  }
+
+  uint32_t MemoryTracker::getAllocationCount(int category)
+  {
+    if (!isValid(category))
+    {
+      return 0;
+    }
+    return counters[category].count;
+  }
+
+  float MemoryTracker::getAllocationRate(int category)
+  {
+    if (!isValid(category))
+    {
+      return 0.0f;
+    }
+    return counters[category].rate;
+  }
+
+  void MemoryTracker::sample()
+  {
+    tick_t now = ticks();
+    float secs = ticks2secs(now - lastSampleTime);
+    for (MemoryCounter &c : counters)
+    {
+      uint32_t total = c.total;
+      if (lastSampleTime > 0 && secs > 0.0f)
+      {
+        c.rate = (total - c.lastTotal) / secs;
+      }
+      c.lastTotal = total;
+    }
+    lastSampleTime = now;
+  }
+
+  void MemoryTracker::resetPeaks()
+  {
+    for (MemoryCounter &c : counters)
+    {
+      c.peak = c.current.load();
+    }
+  }
+
+  void MemoryTracker::print()
+  {
+    logInfo("%-12s %10s %10s %10s %10s", "category", "current", "peak", "count", "bytes/s");
+    for (int i = 0; i < MEMORY_CATEGORY_COUNT; i++)
+    {
+      MemoryCounter &c = counters[i];
+      logInfo("%-12s %10d %10d %10lu %10.0f", categoryNames[i],
+              c.current.load(), c.peak.load(), (unsigned long)c.count.load(), c.rate);
+    }
+    logInfo("BigHeap: %dKB of %dKB free (largest %dKB)",
+            BigHeap::remaining(1024), BigHeap::size(1024), BigHeap::largest(1024));
+    logInfo("Heap: %dKB of %dKB free", Heap_getFreeSize(1024), Heap_getSize(1024));
+  }
+
+  bool MemoryTracker::save(const std::string &filename)
+  {
+    FileWriter writer;
+    if (!writer.open(filename))
+    {
+      logError("MemoryTracker: failed to open %s.", filename.c_str());
+      return false;
+    }
+
+    std::string out = "{\n  \"categories\": {\n";
+    char buffer[160];
+    for (int i = 0; i < MEMORY_CATEGORY_COUNT; i++)
+    {
+      MemoryCounter &c = counters[i];
+      snprintf(buffer, sizeof(buffer),
+               "    \"%s\": {\"current\": %d, \"peak\": %d, \"count\": %lu, \"rate\": %.1f}%s\n",
+               categoryNames[i], c.current.load(), c.peak.load(),
+               (unsigned long)c.count.load(), c.rate,
+               i + 1 < MEMORY_CATEGORY_COUNT ? "," : "");
+      out += buffer;
+    }
+    out += "  },\n";
+    snprintf(buffer, sizeof(buffer),
+             "  \"bigHeap\": {\"size\": %d, \"free\": %d, \"largest\": %d},\n",
+             BigHeap::size(1), BigHeap::remaining(1), BigHeap::largest(1));
+    out += buffer;
+    snprintf(buffer, sizeof(buffer),
+             "  \"heap\": {\"size\": %d, \"free\": %d}\n}\n",
+             Heap_getSize(1), Heap_getFreeSize(1));
+    out += buffer;
+
+    writer.writeBytes(out.data(), out.size());
+    writer.close();
+    return true;
+  }
+
+} // namespace od
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <string>
+#include <stdint.h>
+
+namespace od
+{
+
+  enum MemoryCategory
+  {
+    MEMORY_FRAMES,     // frame buffers not owned by an outlet
+    MEMORY_OUTLETS,    // frame buffers owned by outlets
+    MEMORY_SAMPLES,    // sample data
+    MEMORY_SLICES,     // slice and interval tables
+    MEMORY_DELAYLINES, // delay line buffers
+    MEMORY_GRAINS,     // grain pools
+    MEMORY_LUA,        // Lua heap (requested bytes)
+    MEMORY_GRAPHICS,   // Graphic instances (base size only)
+    MEMORY_OTHER,      // other large buffers (loopers, onset detection)
+    MEMORY_CATEGORY_COUNT
+  };
+
+  // Byte counters per memory category with high-water marks and allocation
+  // rates.  Updating a counter is lock-free, so it is OK from any thread,
+  // including the audio thread.
+  class MemoryTracker
+  {
+  public:
+    static int getCategoryCount();
+    static const char *getCategoryName(int category);
+
+    // In bytes.
+    static int getCurrent(int category);
+    static int getPeak(int category);
+    static uint32_t getAllocationCount(int category);
+    // Bytes per second allocated between the last two calls to sample().
+    static float getAllocationRate(int category);
+
+    // Call periodically (e.g. once per second) to update the allocation rates.
+    static void sample();
+    static void resetPeaks();
+
+    static void print();
+    static bool save(const std::string &filename);
+
+#ifndef SWIGLUA
+    static void resize(int category, int oldBytes, int newBytes);
+
+    static inline void allocated(int category, int bytes)
+    {
+      resize(category, 0, bytes);
+    }
+
+    static inline void freed(int category, int bytes)
+    {
+      resize(category, bytes, 0);
+    }
+#endif
+
+  private:
+    MemoryTracker();
+  };
+
+} // namespace od
@@ -0,0 +1,414 @@
+#include <od/extras/PackageArchive.h>
+#include <od/extras/FileWriter.h>
+#include <od/extras/Utils.h>
+#include <od/ui/JobQueue.h>
+#include <hal/fileops.h>
+#include <hal/log.h>
+#include <algorithm>
+#include <set>
+#include <string.h>
+
+namespace od
+{
+
+  // Writes one extracted file while the next one is being decompressed.
+  class ExtractJob : public Job
+  {
+  public:
+    std::string path;
+    std::string data;
+    bool ok = true;
+
+    virtual const char *getTraceName()
+    {
+      return "Package::extract";
+    }
+
+    virtual void work()
+    {
+      FileWriter writer;
+      ok = writer.open(path) &&
+           writer.writeBytes(data.data(), data.size()) == data.size();
+      ok = writer.close() && ok;
+    }
+  };
+
+  // Mounted archives by package name.
+  struct PackageArchiveLocals
+  {
+    Mutex mutex;
+    std::map<std::string, PackageArchive *> mounted;
+    JobQueue *writer = 0;
+  };
+
+  static PackageArchiveLocals &locals()
+  {
+    static PackageArchiveLocals *local = new PackageArchiveLocals();
+    return *local;
+  }
+
+  PackageArchive::PackageArchive()
+  {
+    memset(&mArchive, 0, sizeof(mArchive));
+  }
+
+  PackageArchive::~PackageArchive()
+  {
+    close();
+  }
+
+  bool PackageArchive::open(const std::string &filename)
+  {
+    Lock lock(mMutex);
+    if (mIsOpen)
+    {
+      mz_zip_reader_end(&mArchive);
+      mIsOpen = false;
+    }
+    mFilename = filename;
+    mCache.clear();
+    mCacheIndex.clear();
+    mCacheBytes = 0;
+    return reopen();
+  }
+
+  bool PackageArchive::reopen()
+  {
+    if (mIsOpen)
+    {
+      return true;
+    }
+
+    if (mFilename.empty())
+    {
+      return false;
+    }
+
+    memset(&mArchive, 0, sizeof(mArchive));
+    if (!mz_zip_reader_init_file(&mArchive, mFilename.c_str(), 0))
+    {
+      logWarn("PackageArchive: failed to open %s", mFilename.c_str());
+      return false;
+    }
+    mIsOpen = true;
+
+    // Rebuilt on every open in case the archive changed while it was closed.
+    // The central directory is already in memory by now.
+    mEntries.clear();
+    mOrder.clear();
+    mz_uint n = mz_zip_reader_get_num_files(&mArchive);
+    std::vector<std::pair<uint64_t, std::string>> byOffset;
+    byOffset.reserve(n);
+    for (mz_uint i = 0; i < n; i++)
+    {
+      mz_zip_archive_file_stat stat;
+      if (!mz_zip_reader_file_stat(&mArchive, i, &stat))
+      {
+        continue;
+      }
+      Entry &entry = mEntries[stat.m_filename];
+      entry.index = i;
+      entry.size = stat.m_uncomp_size;
+      byOffset.emplace_back(stat.m_local_header_ofs, stat.m_filename);
+    }
+
+    std::sort(byOffset.begin(), byOffset.end());
+    mOrder.reserve(byOffset.size());
+    for (auto &x : byOffset)
+    {
+      mOrder.push_back(x.second);
+    }
+
+    return true;
+  }
+
+  void PackageArchive::close()
+  {
+    Lock lock(mMutex);
+    if (mIsOpen)
+    {
+      mz_zip_reader_end(&mArchive);
+      mIsOpen = false;
+    }
+    mCache.clear();
+    mCacheIndex.clear();
+    mCacheBytes = 0;
+  }
+
+  bool PackageArchive::exists(const std::string &name)
+  {
+    Lock lock(mMutex);
+    return mEntries.count(name) > 0;
+  }
+
+  int PackageArchive::getFileCount()
+  {
+    Lock lock(mMutex);
+    return (int)mOrder.size();
+  }
+
+  std::string PackageArchive::getFilename(int index)
+  {
+    Lock lock(mMutex);
+    if (index >= 0 && index < (int)mOrder.size())
+    {
+      return mOrder[index];
+    }
+    return "";
+  }
+
+  int PackageArchive::getSize(const std::string &name)
+  {
+    Lock lock(mMutex);
+    auto i = mEntries.find(name);
+    if (i == mEntries.end())
+    {
+      return -1;
+    }
+    return (int)i->second.size;
+  }
+
+  bool PackageArchive::read(const std::string &name, std::string &contents)
+  {
+    Lock lock(mMutex);
+
+    auto c = mCacheIndex.find(name);
+    if (c != mCacheIndex.end())
+    {
+      // Most recently used files are kept at the front.
+      mCache.splice(mCache.begin(), mCache, c->second);
+      contents = c->second->second;
+      return true;
+    }
+
+    auto i = mEntries.find(name);
+    if (i == mEntries.end() || !reopen())
+    {
+      return false;
+    }
+
+    contents.resize(i->second.size);
+    if (i->second.size > 0 &&
+        !mz_zip_reader_extract_to_mem(&mArchive, i->second.index,
+                                      &contents[0], contents.size(), 0))
+    {
+      logWarn("PackageArchive: failed to read %s from %s", name.c_str(),
+              mFilename.c_str());
+      contents.clear();
+      return false;
+    }
+
+    if ((int)contents.size() <= mCacheLimit / 4)
+    {
+      mCache.emplace_front(name, contents);
+      mCacheIndex[name] = mCache.begin();
+      mCacheBytes += contents.size();
+      trimCache();
+    }
+
+    return true;
+  }
+
+  std::string PackageArchive::readToString(const std::string &name)
+  {
+    std::string contents;
+    read(name, contents);
+    return contents;
+  }
+
+  void PackageArchive::setCacheLimit(int bytes)
+  {
+    Lock lock(mMutex);
+    mCacheLimit = bytes;
+    trimCache();
+  }
+
+  void PackageArchive::trimCache()
+  {
+    while (mCacheBytes > mCacheLimit && !mCache.empty())
+    {
+      CachedFile &oldest = mCache.back();
+      mCacheBytes -= oldest.second.size();
+      mCacheIndex.erase(oldest.first);
+      mCache.pop_back();
+    }
+  }
+
+  // Create the folders in name (a path relative to folder).
+  static bool makeFolders(const std::string &folder, const std::string &name,
+                          std::set<std::string> &made)
+  {
+    size_t slash = name.find('/');
+    while (slash != std::string::npos)
+    {
+      std::string path = folder + '/' + name.substr(0, slash);
+      if (made.insert(path).second && !pathExists(path.c_str()) &&
+          !createDirectory(path.c_str()))
+      {
+        logWarn("PackageArchive: failed to create %s", path.c_str());
+        return false;
+      }
+      slash = name.find('/', slash + 1);
+    }
+    return true;
+  }
+
+  int PackageArchive::extractAll(const std::string &folder,
+                                 const std::string &skip)
+  {
+    PackageArchiveLocals &L = locals();
+    {
+      Lock lock(L.mutex);
+      if (L.writer == 0)
+      {
+        L.writer = new JobQueue("pkgio");
+        L.writer->attach();
+        L.writer->start();
+      }
+    }
+
+    Lock lock(mMutex);
+    if (!reopen())
+    {
+      return -1;
+    }
+
+    // Two jobs, so one file is written while the next one is decompressed.
+    ExtractJob jobs[2];
+    std::set<std::string> made;
+    int count = 0;
+    int k = 0;
+    bool ok = true;
+
+    for (const std::string &name : mOrder)
+    {
+      if (name.back() == '/')
+      {
+        ok = makeFolders(folder, name, made);
+      }
+      else if (skip.empty() || !glob(name.c_str(), skip.c_str()))
+      {
+        ExtractJob &job = jobs[k];
+        job.wait();
+        ok = job.ok && makeFolders(folder, name, made);
+        if (ok)
+        {
+          const Entry &entry = mEntries[name];
+          job.path = folder + '/' + name;
+          job.data.resize(entry.size);
+          ok = entry.size == 0 ||
+               mz_zip_reader_extract_to_mem(&mArchive, entry.index,
+                                            &job.data[0], job.data.size(), 0);
+        }
+        if (ok)
+        {
+          L.writer->push(&job);
+          count++;
+          k = 1 - k;
+        }
+        else
+        {
+          logWarn("PackageArchive: failed to extract %s", name.c_str());
+        }
+      }
+
+      if (!ok)
+      {
+        break;
+      }
+    }
+
+    jobs[0].wait();
+    jobs[1].wait();
+    if (!ok || !jobs[0].ok || !jobs[1].ok)
+    {
+      return -1;
+    }
+    return count;
+  }
+
+  bool PackageArchive::extract(const std::string &name, const std::string &to)
+  {
+    std::string contents;
+    if (!read(name, contents))
+    {
+      return false;
+    }
+
+    FileWriter writer;
+    bool ok = writer.open(to) &&
+              writer.writeBytes(contents.data(), contents.size()) == contents.size();
+    return writer.close() && ok;
+  }
+
+  bool PackageArchive::mount(const std::string &packageName,
+                             const std::string &filename)
+  {
+    PackageArchive *archive = new PackageArchive();
+    archive->attach();
+    if (!archive->open(filename))
+    {
+      archive->release();
+      return false;
+    }
+
+    PackageArchiveLocals &L = locals();
+    Lock lock(L.mutex);
+    auto i = L.mounted.find(packageName);
+    if (i != L.mounted.end())
+    {
+      i->second->release();
+    }
+    L.mounted[packageName] = archive;
+    return true;
+  }
+
+  void PackageArchive::unmount(const std::string &packageName)
+  {
+    PackageArchiveLocals &L = locals();
+    Lock lock(L.mutex);
+    auto i = L.mounted.find(packageName);
+    if (i != L.mounted.end())
+    {
+      i->second->release();
+      L.mounted.erase(i);
+    }
+  }
+
+  bool PackageArchive::isMounted(const std::string &packageName)
+  {
+    PackageArchiveLocals &L = locals();
+    Lock lock(L.mutex);
+    return L.mounted.count(packageName) > 0;
+  }
+
+  bool PackageArchive::hasFile(const std::string &packageName,
+                               const std::string &name)
+  {
+    PackageArchive *archive = find(packageName);
+    return archive && archive->exists(name);
+  }
+
+  void PackageArchive::closeAll()
+  {
+    PackageArchiveLocals &L = locals();
+    Lock lock(L.mutex);
+    for (auto &x : L.mounted)
+    {
+      x.second->close();
+    }
+  }
+
+  PackageArchive *PackageArchive::find(const std::string &packageName)
+  {
+    PackageArchiveLocals &L = locals();
+    Lock lock(L.mutex);
+    auto i = L.mounted.find(packageName);
+    if (i == L.mounted.end())
+    {
+      return 0;
+    }
+    return i->second;
+  }
+
+} /* namespace od */
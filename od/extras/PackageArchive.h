@@ -0,0 +1,101 @@
+#pragma once
+
+#include <od/extras/ReferenceCounted.h>
+#include <hal/concurrency/Mutex.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <list>
+#include <map>
+#include <miniz.h>
+
+namespace od
+{
+
+  // Read-only view of a package archive (*.pkg) that serves files without
+  // extracting them to the card.
+  //
+  // The central directory is read once into a name index, so looking up a
+  // file does not scan the archive.  Decompressed files are kept in a small
+  // LRU cache because modules are often required again when unit libraries
+  // are reloaded.
+  //
+  // Mounted archives are found by package name (see mount()).  They close
+  // their file when the card is ejected and open it again on the next read.
+  class PackageArchive : public ReferenceCounted
+  {
+  public:
+    PackageArchive();
+    virtual ~PackageArchive();
+
+    bool open(const std::string &filename);
+    void close();
+    bool isOpen()
+    {
+      return mIsOpen;
+    }
+
+    bool exists(const std::string &name);
+    int getFileCount();
+    // Files are numbered in the order they are stored in the archive.
+    std::string getFilename(int index);
+    int getSize(const std::string &name);
+
+    std::string readToString(const std::string &name);
+
+    // Extract every file whose name does not match the skip pattern (empty
+    // to extract everything) below folder.  Returns the number of files
+    // extracted or -1 on failure.
+    int extractAll(const std::string &folder, const std::string &skip);
+    bool extract(const std::string &name, const std::string &to);
+
+    void setCacheLimit(int bytes);
+    int getCacheSize()
+    {
+      return mCacheBytes;
+    }
+
+    // Serve files for the package with this name from an archive.
+    static bool mount(const std::string &packageName,
+                      const std::string &filename);
+    static void unmount(const std::string &packageName);
+    static bool isMounted(const std::string &packageName);
+    static bool hasFile(const std::string &packageName,
+                        const std::string &name);
+    // Close the files of all mounted archives (e.g. before an eject).
+    static void closeAll();
+
+#ifndef SWIGLUA
+    bool read(const std::string &name, std::string &contents);
+
+    // The archive mounted for a package, or 0.
+    static PackageArchive *find(const std::string &packageName);
+#endif
+
+  private:
+    struct Entry
+    {
+      mz_uint index;
+      uint64_t size;
+    };
+
+    mz_zip_archive mArchive;
+    bool mIsOpen = false;
+    std::string mFilename;
+    std::map<std::string, Entry> mEntries;
+    // Names in storage order, so that extraction reads the archive
+    // sequentially.
+    std::vector<std::string> mOrder;
+
+    typedef std::pair<std::string, std::string> CachedFile;
+    std::list<CachedFile> mCache;
+    std::map<std::string, std::list<CachedFile>::iterator> mCacheIndex;
+    int mCacheBytes = 0;
+    int mCacheLimit = 256 * 1024;
+    Mutex mMutex;
+
+    bool reopen();
+    void trimCache();
+  };
+
+} /* namespace od */
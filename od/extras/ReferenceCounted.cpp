@@ -1,4 +1,5 @@
 #include "ReferenceCounted.h"
+#include <atomic>
 
 #if TRACK_REFCOUNTED_OBJECTS
 #include <typeinfo>
@@ -10,6 +11,7 @@ static bool printingEnabled = false;
 #endif
 
 static unsigned int nextKey = 0;
+static std::atomic<int> liveCount{0};
 
 #define LOCALCHECKS 0
 #define VERBOSE_ATTACH_RELEASE 0
@@ -27,10 +29,12 @@ namespace od
   ReferenceCounted::ReferenceCounted()
   {
     mInternalKey = nextKey++;
+    liveCount++;
   }
 
   ReferenceCounted::~ReferenceCounted()
   {
+    liveCount--;
 #if TRACK_REFCOUNTED_OBJECTS
     if (mTrackingEnabled)
     {
@@ -243,4 +247,9 @@ namespace od
     return mInternalKey;
   }
 
+  int ReferenceCounted::getLiveCount()
+  {
+    return liveCount;
+  }
+
 } /* namespace od */
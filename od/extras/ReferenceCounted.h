@@ -41,6 +41,9 @@ namespace od
 #endif
     unsigned int handle();
 
+    // Number of ReferenceCounted instances currently alive (for leak checks).
+    static int getLiveCount();
+
   protected:
     int mRefCount = 0;
     ReferenceCounted *mpOwner = 0;
@@ -0,0 +1,110 @@
+#include <od/extras/SimdBenchmark.h>
+#include <hal/simd.h>
+#include <hal/timing.h>
+#include <hal/log.h>
+#include <math.h>
+
+namespace od
+{
+
+  typedef float32x4_t (*SimdFunction)(float32x4_t);
+  typedef double (*GoldenFunction)(double);
+
+  struct SimdTestCase
+  {
+    const char *name;
+    SimdFunction f;
+    GoldenFunction golden;
+    float from;
+    float to;
+    bool relative;
+  };
+
+  static const int numSamples = 4096;
+  static const int numRepeats = 16;
+
+  static void runTestCase(const SimdTestCase &test)
+  {
+    float in[numSamples] __attribute__((aligned(16)));
+    float out[numSamples] __attribute__((aligned(16)));
+    float step = (test.to - test.from) / (numSamples - 1);
+    for (int i = 0; i < numSamples; i++)
+    {
+      in[i] = test.from + step * i;
+    }
+
+    tick_t start = ticks();
+    for (int r = 0; r < numRepeats; r++)
+    {
+      for (int i = 0; i < numSamples; i += 4)
+      {
+        vst1q_f32(out + i, test.f(vld1q_f32(in + i)));
+      }
+    }
+    tick_t elapsed = ticks() - start;
+
+    double maxError = 0;
+    float worstInput = 0;
+    for (int i = 0; i < numSamples; i++)
+    {
+      double expected = test.golden(in[i]);
+      double error = fabs(out[i] - expected);
+      if (test.relative && expected != 0)
+      {
+        error /= fabs(expected);
+      }
+      if (error > maxError)
+      {
+        maxError = error;
+        worstInput = in[i];
+      }
+    }
+
+    // One call evaluates 4 samples.
+    float ticksPerCall = (float)elapsed / (numRepeats * numSamples / 4);
+    logInfo("%-16s %s error %.3e at x=%.4f, %.1f ticks/call",
+            test.name, test.relative ? "rel" : "abs",
+            maxError, worstInput, ticksPerCall);
+  }
+
+  static double golden_exp2(double x)
+  {
+    return pow(2.0, x);
+  }
+
+  static double golden_log2(double x)
+  {
+    return log(x) / log(2.0);
+  }
+
+  static double golden_softclip(double x)
+  {
+    x = x < -1.5 ? -1.5 : (x > 1.5 ? 1.5 : x);
+    return x - (4.0 / 27.0) * x * x * x;
+  }
+
+  void SimdBenchmark::run()
+  {
+    static const SimdTestCase tests[] = {
+        {"simd_exp", simd_exp, exp, -10.0f, 10.0f, true},
+        {"simd_log", simd_log, log, 1e-3f, 1e3f, false},
+        {"simd_sin", simd_sin, sin, -10.0f, 10.0f, false},
+        {"simd_exp2", simd_exp2, golden_exp2, -10.0f, 10.0f, true},
+        {"simd_exp2_fast", simd_exp2_fast, golden_exp2, -10.0f, 10.0f, true},
+        {"simd_log2", simd_log2, golden_log2, 1e-3f, 1e3f, false},
+        {"simd_log2_fast", simd_log2_fast, golden_log2, 1e-3f, 1e3f, false},
+        {"simd_tanh", simd_tanh, tanh, -10.0f, 10.0f, false},
+        {"simd_tanh_fast", simd_tanh_fast, tanh, -10.0f, 10.0f, false},
+        {"simd_atan", simd_atan, atan, -100.0f, 100.0f, false},
+        {"simd_atan_fast", simd_atan_fast, atan, -100.0f, 100.0f, false},
+        {"simd_softclip", simd_softclip, golden_softclip, -3.0f, 3.0f, false},
+    };
+
+    logInfo("SimdBenchmark: %d samples x %d repeats", numSamples, numRepeats);
+    for (const SimdTestCase &test : tests)
+    {
+      runTestCase(test);
+    }
+  }
+
+} // namespace od
@@ -0,0 +1,16 @@
+#pragma once
+
+namespace od
+{
+
+  // Checks the accuracy and cost of the simd_* transcendentals against libm.
+  class SimdBenchmark
+  {
+  public:
+    static void run();
+
+  private:
+    SimdBenchmark();
+  };
+
+} // namespace od
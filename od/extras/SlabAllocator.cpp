@@ -0,0 +1,329 @@
+#include <od/extras/SlabAllocator.h>
+#include <hal/heap.h>
+#include <hal/log.h>
+#include <string.h>
+
+namespace od
+{
+
+  // Objects start after the page header, keeping Lua's 8-byte alignment.
+  static const int headerSize = 48;
+
+  SlabAllocator::SlabAllocator()
+  {
+    static_assert((pageSize & (pageSize - 1)) == 0, "pageSize must be a power of two.");
+    static_assert(headerSize >= (int)sizeof(Page) && headerSize % 16 == 0, "headerSize is too small.");
+
+    // 8-byte steps up to 64, then 4 classes per doubling.
+    int i = 0;
+    for (int size = 8; size <= 64; size += 8)
+    {
+      mClasses[i++].size = size;
+    }
+    for (int base = 64; base < maximumSize; base *= 2)
+    {
+      for (int k = 1; k <= 4; k++)
+      {
+        mClasses[i++].size = base + k * base / 4;
+      }
+    }
+
+    int k = 0;
+    for (int j = 0; j <= maximumSize / 8; j++)
+    {
+      while ((int)mClasses[k].size < j * 8)
+      {
+        k++;
+      }
+      mClassLookup[j] = k;
+    }
+
+    for (SizeClass &c : mClasses)
+    {
+      c.objectsPerPage = (pageSize - headerSize) / c.size;
+    }
+  }
+
+  SlabAllocator::~SlabAllocator()
+  {
+    for (SizeClass &c : mClasses)
+    {
+      while (c.partial)
+      {
+        Page *page = c.partial;
+        c.partial = page->next;
+        Heap_free(page);
+      }
+      if (c.spare)
+      {
+        Heap_free(c.spare);
+        c.spare = 0;
+      }
+    }
+    // Full pages are not linked anywhere, so they leak if objects are still
+    // alive.  Lua frees everything in lua_close() so this never happens.
+  }
+
+  SlabAllocator::Page *SlabAllocator::newPage(int i)
+  {
+    SizeClass &c = mClasses[i];
+    if (c.spare)
+    {
+      Page *page = c.spare;
+      c.spare = 0;
+      return page;
+    }
+
+    Page *page = (Page *)Heap_memalign(pageSize, pageSize);
+    if (page == 0)
+    {
+      return 0;
+    }
+    page->prev = 0;
+    page->next = 0;
+    page->freeList = 0;
+    page->unused = (uint8_t *)page + headerSize;
+    page->end = page->unused + c.objectsPerPage * c.size;
+    page->inUse = 0;
+    page->capacity = c.objectsPerPage;
+    page->sizeClass = i;
+    c.pageCount++;
+    return page;
+  }
+
+  void SlabAllocator::releasePage(Page *page)
+  {
+    SizeClass &c = mClasses[page->sizeClass];
+    if (c.spare == 0)
+    {
+      // Reset so that the next user carves objects in address order again.
+      page->prev = 0;
+      page->next = 0;
+      page->freeList = 0;
+      page->unused = (uint8_t *)page + headerSize;
+      c.spare = page;
+      return;
+    }
+    c.pageCount--;
+    Heap_free(page);
+  }
+
+  void SlabAllocator::unlink(SizeClass &c, Page *page)
+  {
+    if (page->prev)
+    {
+      page->prev->next = page->next;
+    }
+    else
+    {
+      c.partial = page->next;
+    }
+    if (page->next)
+    {
+      page->next->prev = page->prev;
+    }
+    page->prev = 0;
+    page->next = 0;
+  }
+
+  void SlabAllocator::pushFront(SizeClass &c, Page *page)
+  {
+    page->prev = 0;
+    page->next = c.partial;
+    if (c.partial)
+    {
+      c.partial->prev = page;
+    }
+    c.partial = page;
+  }
+
+  void *SlabAllocator::allocate(size_t size)
+  {
+    if (size > maximumSize)
+    {
+      void *ptr = Heap_malloc(size);
+      if (ptr)
+      {
+        mLargeInUse++;
+        mLargeAllocationCount++;
+      }
+      return ptr;
+    }
+
+    int i = classOf(size);
+    SizeClass &c = mClasses[i];
+    Page *page = c.partial;
+    if (page == 0)
+    {
+      page = newPage(i);
+      if (page == 0)
+      {
+        return 0;
+      }
+      pushFront(c, page);
+    }
+
+    void *ptr;
+    if (page->freeList)
+    {
+      ptr = page->freeList;
+      page->freeList = page->freeList->next;
+    }
+    else
+    {
+      ptr = page->unused;
+      page->unused += c.size;
+    }
+
+    if (++page->inUse == page->capacity)
+    {
+      // Full pages are not tracked until an object is freed.
+      unlink(c, page);
+    }
+
+    c.allocationCount++;
+    if (++c.inUse > c.peakInUse)
+    {
+      c.peakInUse = c.inUse;
+    }
+    return ptr;
+  }
+
+  void SlabAllocator::free(void *ptr, size_t size)
+  {
+    if (ptr == 0)
+    {
+      return;
+    }
+
+    if (size > maximumSize)
+    {
+      mLargeInUse--;
+      Heap_free(ptr);
+      return;
+    }
+
+    Page *page = pageOf(ptr);
+    SizeClass &c = mClasses[page->sizeClass];
+    bool wasFull = page->inUse == page->capacity;
+
+    FreeObject *object = (FreeObject *)ptr;
+    object->next = page->freeList;
+    page->freeList = object;
+    page->inUse--;
+    c.inUse--;
+
+    if (page->inUse == 0)
+    {
+      if (!wasFull)
+      {
+        unlink(c, page);
+      }
+      releasePage(page);
+    }
+    else if (wasFull)
+    {
+      pushFront(c, page);
+    }
+  }
+
+  void *SlabAllocator::reallocate(void *ptr, size_t osize, size_t nsize)
+  {
+    if (ptr == 0)
+    {
+      return allocate(nsize);
+    }
+
+    if (nsize == 0)
+    {
+      free(ptr, osize);
+      return 0;
+    }
+
+    bool small = osize <= maximumSize;
+    if (small && nsize <= maximumSize && classOf(osize) == classOf(nsize))
+    {
+      return ptr;
+    }
+
+    if (!small && nsize > maximumSize)
+    {
+      return Heap_realloc(ptr, nsize);
+    }
+
+    void *ptr2 = allocate(nsize);
+    if (ptr2)
+    {
+      memcpy(ptr2, ptr, osize < nsize ? osize : nsize);
+      free(ptr, osize);
+    }
+    return ptr2;
+  }
+
+  int SlabAllocator::getClassSize(int i)
+  {
+    return i >= 0 && i < classCount ? mClasses[i].size : 0;
+  }
+
+  int SlabAllocator::getPageCount(int i)
+  {
+    return i >= 0 && i < classCount ? mClasses[i].pageCount : 0;
+  }
+
+  int SlabAllocator::getObjectsPerPage(int i)
+  {
+    return i >= 0 && i < classCount ? mClasses[i].objectsPerPage : 0;
+  }
+
+  int SlabAllocator::getInUse(int i)
+  {
+    return i >= 0 && i < classCount ? mClasses[i].inUse : 0;
+  }
+
+  int SlabAllocator::getPeakInUse(int i)
+  {
+    return i >= 0 && i < classCount ? mClasses[i].peakInUse : 0;
+  }
+
+  uint32_t SlabAllocator::getAllocationCount(int i)
+  {
+    return i >= 0 && i < classCount ? mClasses[i].allocationCount : 0;
+  }
+
+  int SlabAllocator::getLargeInUse()
+  {
+    return mLargeInUse;
+  }
+
+  uint32_t SlabAllocator::getLargeAllocationCount()
+  {
+    return mLargeAllocationCount;
+  }
+
+  int SlabAllocator::getReservedBytes()
+  {
+    int pages = 0;
+    for (SizeClass &c : mClasses)
+    {
+      pages += c.pageCount;
+    }
+    return pages * pageSize;
+  }
+
+  void SlabAllocator::print()
+  {
+    logInfo("bytes\tcur\tmax\tpages\tcnt");
+    for (SizeClass &c : mClasses)
+    {
+      if (c.allocationCount > 0)
+      {
+        logInfo("%d:\t%d\t%d\t%d\t%lu", c.size, c.inUse, c.peakInUse,
+                c.pageCount, (unsigned long)c.allocationCount);
+      }
+    }
+    logInfo("large:\t%d\t-\t-\t%lu", mLargeInUse,
+            (unsigned long)mLargeAllocationCount);
+    logInfo("Reserved: %dKB", getReservedBytes() / 1024);
+  }
+
+} // namespace od
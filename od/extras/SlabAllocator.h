@@ -0,0 +1,107 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace od
+{
+
+  // Small-object allocator for the Lua heap.
+  //
+  // Requests up to maximumSize bytes are rounded up to one of a fixed set of
+  // size classes.  Each class carves objects out of its own pages, which are
+  // taken from the system heap on demand and given back once they are empty
+  // again.  Larger requests go straight to the system heap.
+  //
+  // Like Lua's allocator interface, the caller must pass the size of a block
+  // when freeing or resizing it.  That is what makes lookups O(1): the class
+  // comes from the size and the page from the address.
+  class SlabAllocator
+  {
+  public:
+    SlabAllocator();
+    ~SlabAllocator();
+
+    void *allocate(size_t size);
+    void free(void *ptr, size_t size);
+    void *reallocate(void *ptr, size_t osize, size_t nsize);
+
+    // Page size must be a power of two.  Pages are aligned to their size.
+    static const int pageSize = 16 * 1024;
+    static const int maximumSize = 2048;
+    static const int classCount = 28;
+
+    int getClassSize(int i);
+    int getPageCount(int i);
+    int getObjectsPerPage(int i);
+    int getInUse(int i);
+    int getPeakInUse(int i);
+    uint32_t getAllocationCount(int i);
+
+    // Blocks larger than maximumSize.
+    int getLargeInUse();
+    uint32_t getLargeAllocationCount();
+
+    // Bytes taken from the system heap for pages.
+    int getReservedBytes();
+    void print();
+
+  private:
+    struct FreeObject
+    {
+      FreeObject *next;
+    };
+
+    struct Page
+    {
+      Page *prev;
+      Page *next;
+      // Recycled objects.
+      FreeObject *freeList;
+      // Objects that have never been handed out are carved from here.
+      uint8_t *unused;
+      uint8_t *end;
+      uint16_t inUse;
+      uint16_t capacity;
+      uint8_t sizeClass;
+    };
+
+    struct SizeClass
+    {
+      uint32_t size = 0;
+      uint32_t objectsPerPage = 0;
+      // Pages that still have free objects, most recently used first.
+      Page *partial = 0;
+      // At most one empty page is kept per class to avoid thrashing the
+      // system heap when the number of objects hovers around a page boundary.
+      Page *spare = 0;
+      int pageCount = 0;
+      int inUse = 0;
+      int peakInUse = 0;
+      uint32_t allocationCount = 0;
+    };
+
+    SizeClass mClasses[classCount];
+    // Size class for each multiple of 8 bytes up to maximumSize.
+    uint8_t mClassLookup[maximumSize / 8 + 1];
+
+    int mLargeInUse = 0;
+    uint32_t mLargeAllocationCount = 0;
+
+    static inline Page *pageOf(void *ptr)
+    {
+      return (Page *)((uintptr_t)ptr & ~(uintptr_t)(pageSize - 1));
+    }
+
+    inline int classOf(size_t size)
+    {
+      return mClassLookup[(size + 7) >> 3];
+    }
+
+    Page *newPage(int i);
+    void releasePage(Page *page);
+    void unlink(SizeClass &c, Page *page);
+    void pushFront(SizeClass &c, Page *page);
+  };
+
+} // namespace od
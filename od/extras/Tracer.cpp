@@ -0,0 +1,189 @@
+#include <od/extras/Tracer.h>
+#include <od/extras/FileWriter.h>
+#include <hal/log.h>
+#include <hal/ops.h>
+#include <stdio.h>
+#include <string.h>
+
+namespace od
+{
+
+  Tracer &Tracer::singleton()
+  {
+    static Tracer t;
+    return t;
+  }
+
+  Tracer::Tracer()
+  {
+    const char *names[] = {"Audio", "UI"};
+    const int capacities[] = {64 * 1024, 8 * 1024};
+    for (int i = 0; i < 2; i++)
+    {
+      Track &track = mTracks[i];
+      strncpy(track.name, names[i], nameLength);
+      track.capacity = capacities[i];
+    }
+    mTrackCount = 2;
+  }
+
+  void Tracer::allocate(Track &track)
+  {
+    // Never freed, so writers never see the storage move.
+    if (track.events.size() == 0)
+    {
+      track.events.resize(track.capacity);
+    }
+    track.count = 0;
+  }
+
+  int Tracer::addTrack(const char *name, int capacity)
+  {
+    Tracer &t = singleton();
+    if (t.mTrackCount == maximumTracks)
+    {
+      logWarn("Tracer: no room for track '%s'.", name);
+      return -1;
+    }
+
+    Track &track = t.mTracks[t.mTrackCount];
+    strncpy(track.name, name, nameLength);
+    track.capacity = capacity;
+    if (t.mRecording)
+    {
+      t.allocate(track);
+    }
+    // Publish the track only after it is ready.
+    return t.mTrackCount++;
+  }
+
+  void Tracer::start()
+  {
+    Tracer &t = singleton();
+    if (t.mRecording)
+    {
+      return;
+    }
+    for (int i = 0; i < t.mTrackCount; i++)
+    {
+      t.allocate(t.mTracks[i]);
+    }
+    t.mStart = ticks();
+    t.mRecording = true;
+    logInfo("Tracer: recording %d tracks.", t.mTrackCount);
+  }
+
+  void Tracer::stop()
+  {
+    singleton().mRecording = false;
+  }
+
+  bool Tracer::recording()
+  {
+    return singleton().mRecording;
+  }
+
+  void Tracer::record(int track, const char *name, char phase)
+  {
+    Tracer &t = singleton();
+    if (track < 0 || track >= t.mTrackCount)
+    {
+      return;
+    }
+    Track &tr = t.mTracks[track];
+    if (tr.events.size() == 0)
+    {
+      return;
+    }
+    uint32_t count = tr.count;
+    Event &e = tr.events[count % tr.capacity];
+    e.time = ticks();
+    int n = MIN((int)strlen(name), nameLength - 1);
+    memcpy(e.name, name, n);
+    e.name[n] = 0;
+    e.phase = phase;
+    tr.count = count + 1;
+  }
+
+  static void writeEscaped(std::string &out, const char *text, int n)
+  {
+    for (int i = 0; i < n && text[i]; i++)
+    {
+      char c = text[i];
+      if (c == '"' || c == '\\')
+      {
+        out += '\\';
+        out += c;
+      }
+      else if ((unsigned char)c >= 0x20)
+      {
+        out += c;
+      }
+    }
+  }
+
+  bool Tracer::save(const std::string &filename)
+  {
+    Tracer &t = singleton();
+    stop();
+
+    FileWriter writer;
+    if (!writer.open(filename))
+    {
+      logError("Tracer: failed to open %s.", filename.c_str());
+      return false;
+    }
+
+    std::string out;
+    char buffer[64];
+    int total = 0;
+    out = "{\"traceEvents\":[\n";
+    for (int i = 0; i < t.mTrackCount; i++)
+    {
+      Track &track = t.mTracks[i];
+      out += "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":";
+      snprintf(buffer, sizeof(buffer), "%d", i);
+      out += buffer;
+      out += ",\"args\":{\"name\":\"";
+      writeEscaped(out, track.name, nameLength);
+      out += "\"}}";
+
+      if (track.events.size() == 0)
+      {
+        continue;
+      }
+
+      // Oldest first, taking ring wrap-around into account.
+      uint32_t count = track.count;
+      uint32_t n = count < (uint32_t)track.capacity ? count : track.capacity;
+      for (uint32_t j = count - n; j < count; j++)
+      {
+        Event &e = track.events[j % track.capacity];
+        out += ",\n{\"name\":\"";
+        writeEscaped(out, e.name, nameLength);
+        snprintf(buffer, sizeof(buffer), "\",\"ph\":\"%c\",\"ts\":%.3f,\"pid\":1,\"tid\":%d}",
+                 e.phase, ticks2secsD(e.time - t.mStart) * 1e6, i);
+        out += buffer;
+
+        // Keep memory use bounded while writing large traces.
+        if (out.size() > 32 * 1024)
+        {
+          writer.writeBytes(out.data(), out.size());
+          out.clear();
+        }
+      }
+      total += n;
+      if (i + 1 < t.mTrackCount)
+      {
+        out += ",\n";
+      }
+    }
+    out += "\n]}\n";
+    writer.writeBytes(out.data(), out.size());
+    writer.close();
+
+    logInfo("Tracer: wrote %d events to %s.", total, filename.c_str());
+    return true;
+  }
+
+} // namespace od
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <hal/timing.h>
+#include <string>
+#include <vector>
+
+namespace od
+{
+
+  // Records timestamped begin/end events into one ring buffer per track and
+  // writes them out in the Chrome trace format (chrome://tracing, Perfetto).
+  // Each track must only be written by one thread at a time, which keeps
+  // recording lock-free.
+  class Tracer
+  {
+  public:
+    static void start();
+    static void stop();
+    static bool recording();
+    static bool save(const std::string &filename);
+
+#ifndef SWIGLUA
+    static const int maximumTracks = 16;
+    static const int nameLength = 23;
+
+    // Returns the new track id or -1 if there is no room.
+    static int addTrack(const char *name, int capacity = 8192);
+
+    static inline void begin(int track, const char *name)
+    {
+      if (singleton().mRecording)
+      {
+        record(track, name, 'B');
+      }
+    }
+
+    static inline void end(int track, const char *name)
+    {
+      if (singleton().mRecording)
+      {
+        record(track, name, 'E');
+      }
+    }
+#endif
+
+  private:
+    Tracer();
+    static Tracer &singleton();
+    static void record(int track, const char *name, char phase);
+
+    struct Event
+    {
+      tick_t time;
+      char name[nameLength];
+      char phase;
+    };
+
+    struct Track
+    {
+      char name[nameLength + 1];
+      int capacity = 0;
+      std::vector<Event> events;
+      // Only written by the thread that owns the track.
+      volatile uint32_t count = 0;
+    };
+
+    Track mTracks[maximumTracks];
+    volatile int mTrackCount = 0;
+    volatile bool mRecording = false;
+    tick_t mStart = 0;
+
+    void allocate(Track &track);
+  };
+
+#ifndef SWIGLUA
+  // Predefined tracks.
+  enum TraceTrack
+  {
+    TRACE_AUDIO = 0,
+    TRACE_UI = 1
+  };
+
+  class TraceScope
+  {
+  public:
+    inline TraceScope(int track, const char *name) : mTrack(track), mName(name)
+    {
+      Tracer::begin(mTrack, mName);
+    }
+
+    inline ~TraceScope()
+    {
+      Tracer::end(mTrack, mName);
+    }
+
+  private:
+    int mTrack;
+    const char *mName;
+  };
+#endif
+
+} // namespace od
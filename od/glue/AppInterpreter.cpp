@@ -1,6 +1,9 @@
 #include "AppInterpreter.h"
+#include <od/UIThread.h>
 #include <hal/dir.h>
 #include <hal/fileops.h>
+#include <hal/constants.h>
+#include <hal/timing.h>
 #include <set>
 #include <vector>
 #include <string>
@@ -180,25 +183,16 @@ namespace od
   {
     Interpreter::init();
 
-    lua_gc(L, LUA_GCGEN, 0, 0);
-
-#ifndef BUILDOPT_LUA_USE_REALLOC
-    // Approx 7472kB
-    const int multiplier = 1;
-    mAllocator.add(16, 15000 * multiplier);
-    mAllocator.add(32, 50000 * multiplier);
-    mAllocator.add(64, 30000 * multiplier);
-    mAllocator.add(128, 8000 * multiplier);
-    mAllocator.add(256, 4000 * multiplier);
-    mAllocator.add(512, 1500 * multiplier);
-    mAllocator.add(1024, 750 * multiplier);
-    mAllocator.add(2048, 150 * multiplier);
-#endif
+    // Incremental mode so that collection can be sliced into the idle time
+    // between display frames (see collectIdle).  The automatic collector
+    // stays on as a backstop.
+    lua_gc(L, LUA_GCINC, 0, 0, 0);
 
     openStandardlibs(L);
     luaopen_dir(L);
     // Defined by SWIG using app.cpp.swig
     luaopen_app(L);
+    openCollector();
 
 #ifdef BUILDOPT_TESTING
     execute("app.TESTING = true");
@@ -209,6 +203,75 @@ namespace od
     execute("app.BUILD_PROFILE = '%s'", BUILD_PROFILE);
   }
 
+  bool AppInterpreter::collectIdle()
+  {
+    static const tick_t framePeriod = GRAPHICS_REFRESH_PERIOD / ticks2secsD(1);
+    // Leave some headroom so the event loop is waiting again before the
+    // next frame is due.
+    static const tick_t usablePeriod = 3 * framePeriod / 4;
+    // Cap each slice so that input events are not held up for long.
+    static const tick_t maximumSlice = 0.004 / ticks2secsD(1);
+
+    tick_t elapsed = ticks() - UIThread::getFrameStart();
+    tick_t budget = usablePeriod - elapsed;
+    if (budget > maximumSlice)
+    {
+      budget = maximumSlice;
+    }
+    return Interpreter::collectIdle(budget);
+  }
+
+  int AppInterpreter::collectIdleCallback(lua_State *L)
+  {
+    AppInterpreter *self = (AppInterpreter *)lua_touserdata(L, lua_upvalueindex(1));
+    lua_pushboolean(L, self->collectIdle());
+    return 1;
+  }
+
+  int AppInterpreter::getCollectorStatsCallback(lua_State *L)
+  {
+    AppInterpreter *self = (AppInterpreter *)lua_touserdata(L, lua_upvalueindex(1));
+    double ms = 1000.0 * ticks2secsD(1);
+    lua_createtable(L, 0, 6);
+    lua_pushinteger(L, self->mIdleSliceCount);
+    lua_setfield(L, -2, "slices");
+    lua_pushinteger(L, self->mIdleCycleCount);
+    lua_setfield(L, -2, "cycles");
+    lua_pushinteger(L, self->mIdleOverBudgetCount);
+    lua_setfield(L, -2, "overBudget");
+    lua_pushnumber(L, self->mIdleSliceCount > 0 ? ms * self->mIdlePauseTotal / self->mIdleSliceCount : 0);
+    lua_setfield(L, -2, "averagePause");
+    lua_pushnumber(L, ms * self->mIdlePauseMax);
+    lua_setfield(L, -2, "maximumPause");
+    lua_pushnumber(L, ms * self->mIdlePauseLast);
+    lua_setfield(L, -2, "lastPause");
+    return 1;
+  }
+
+  int AppInterpreter::resetCollectorStatsCallback(lua_State *L)
+  {
+    AppInterpreter *self = (AppInterpreter *)lua_touserdata(L, lua_upvalueindex(1));
+    self->resetCollectorStats();
+    return 0;
+  }
+
+  void AppInterpreter::openCollector()
+  {
+    // app.collectIdle(), app.getCollectorStats() and app.resetCollectorStats()
+    // Pause times are in milliseconds.
+    lua_getglobal(L, "app");
+    lua_pushlightuserdata(L, this);
+    lua_pushcclosure(L, collectIdleCallback, 1);
+    lua_setfield(L, -2, "collectIdle");
+    lua_pushlightuserdata(L, this);
+    lua_pushcclosure(L, getCollectorStatsCallback, 1);
+    lua_setfield(L, -2, "getCollectorStats");
+    lua_pushlightuserdata(L, this);
+    lua_pushcclosure(L, resetCollectorStatsCallback, 1);
+    lua_setfield(L, -2, "resetCollectorStats");
+    lua_pop(L, 1);
+  }
+
 } /* namespace od */
 
 /*
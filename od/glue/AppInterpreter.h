@@ -12,6 +12,15 @@ namespace od
     virtual ~AppInterpreter();
 
     void init();
+
+    // Spends what is left of the current display frame on garbage collection.
+    bool collectIdle();
+
+  private:
+    static int collectIdleCallback(lua_State *L);
+    static int getCollectorStatsCallback(lua_State *L);
+    static int resetCollectorStatsCallback(lua_State *L);
+    void openCollector();
   };
 
 } /* namespace od */
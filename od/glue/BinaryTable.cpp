@@ -0,0 +1,605 @@
+#include <od/glue/BinaryTable.h>
+#include <hal/log.h>
+#include <memory>
+#include <string.h>
+
+extern "C"
+{
+#include "lauxlib.h"
+}
+
+namespace od
+{
+
+  using namespace binarytable;
+
+  static inline uint64_t zigzag(int64_t v)
+  {
+    return ((uint64_t)v << 1) ^ (uint64_t)(v >> 63);
+  }
+
+  static inline int64_t unzigzag(uint64_t v)
+  {
+    return (int64_t)(v >> 1) ^ -(int64_t)(v & 1);
+  }
+
+  BinaryTableWriter::BinaryTableWriter(lua_State *L) : L(L)
+  {
+  }
+
+  bool BinaryTableWriter::fail(const char *message)
+  {
+    if (mError.empty())
+    {
+      mError = message;
+    }
+    return false;
+  }
+
+  bool BinaryTableWriter::flush()
+  {
+    if (mCount > 0 && mWriter.writeBytes(mBuffer, mCount) != (uint32_t)mCount)
+    {
+      return fail("write failed");
+    }
+    mCount = 0;
+    return true;
+  }
+
+  bool BinaryTableWriter::putByte(uint8_t byte)
+  {
+    if (mCount == bufferSize && !flush())
+    {
+      return false;
+    }
+    mBuffer[mCount++] = byte;
+    return true;
+  }
+
+  bool BinaryTableWriter::putBytes(const void *data, size_t n)
+  {
+    const uint8_t *p = (const uint8_t *)data;
+    while (n > 0)
+    {
+      if (mCount == bufferSize && !flush())
+      {
+        return false;
+      }
+      size_t k = bufferSize - mCount;
+      if (k > n)
+      {
+        k = n;
+      }
+      memcpy(mBuffer + mCount, p, k);
+      mCount += k;
+      p += k;
+      n -= k;
+    }
+    return true;
+  }
+
+  bool BinaryTableWriter::putVarint(uint64_t value)
+  {
+    while (value >= 0x80)
+    {
+      if (!putByte((uint8_t)(value | 0x80)))
+      {
+        return false;
+      }
+      value >>= 7;
+    }
+    return putByte((uint8_t)value);
+  }
+
+  bool BinaryTableWriter::write(const std::string &filename, int index, int hooks)
+  {
+    int top = lua_gettop(L);
+    index = lua_absindex(L, index);
+    mHooks = hooks ? lua_absindex(L, hooks) : 0;
+    mError.clear();
+    mCount = 0;
+    mStringCount = 0;
+    mTableCount = 0;
+
+    if (!lua_checkstack(L, 4))
+    {
+      return fail("out of stack space");
+    }
+    lua_newtable(L);
+    mStrings = lua_gettop(L);
+    lua_newtable(L);
+    mTables = lua_gettop(L);
+
+    if (!mWriter.open(filename))
+    {
+      lua_settop(L, top);
+      return fail("could not open file for writing");
+    }
+
+    uint8_t header[headerSize] = {0};
+    memcpy(header, magic, sizeof(magic));
+    header[4] = version;
+
+    lua_pushvalue(L, index);
+    bool ok = putBytes(header, headerSize) && putValue(0) && flush();
+    ok = mWriter.close() && ok;
+    lua_settop(L, top);
+    return ok;
+  }
+
+  // Writes and pops the value on top of the stack.
+  bool BinaryTableWriter::putValue(int depth)
+  {
+    if (mHooks)
+    {
+      lua_getfield(L, mHooks, luaL_typename(L, -1));
+      if (lua_isfunction(L, -1))
+      {
+        lua_insert(L, -2);
+        if (lua_pcall(L, 1, 1, 0) != LUA_OK)
+        {
+          return fail(lua_tostring(L, -1));
+        }
+      }
+      else
+      {
+        lua_pop(L, 1);
+      }
+    }
+
+    bool ok;
+    switch (lua_type(L, -1))
+    {
+    case LUA_TBOOLEAN:
+      ok = putByte(lua_toboolean(L, -1) ? TAG_TRUE : TAG_FALSE);
+      break;
+
+    case LUA_TNUMBER:
+      if (lua_isinteger(L, -1))
+      {
+        ok = putByte(TAG_INTEGER) && putVarint(zigzag(lua_tointeger(L, -1)));
+      }
+      else
+      {
+        lua_Number x = lua_tonumber(L, -1);
+        float f = (float)x;
+        if (sizeof(lua_Number) == sizeof(float) || f == x)
+        {
+          ok = putByte(TAG_FLOAT32) && putBytes(&f, sizeof(f));
+        }
+        else
+        {
+          double d = x;
+          ok = putByte(TAG_FLOAT64) && putBytes(&d, sizeof(d));
+        }
+      }
+      break;
+
+    case LUA_TSTRING:
+      lua_pushvalue(L, -1);
+      lua_rawget(L, mStrings);
+      if (lua_isinteger(L, -1))
+      {
+        ok = putByte(TAG_STRING_REF) && putVarint(lua_tointeger(L, -1));
+        lua_pop(L, 1);
+      }
+      else
+      {
+        lua_pop(L, 1);
+        size_t n;
+        const char *s = lua_tolstring(L, -1, &n);
+        ok = putByte(TAG_STRING) && putVarint(n) && putBytes(s, n);
+        lua_pushvalue(L, -1);
+        lua_pushinteger(L, mStringCount++);
+        lua_rawset(L, mStrings);
+      }
+      break;
+
+    case LUA_TTABLE:
+      ok = putTable(lua_gettop(L), depth);
+      break;
+
+    default:
+      // nil, and everything that cannot be restored.
+      ok = putByte(TAG_NIL);
+      break;
+    }
+
+    lua_pop(L, 1);
+    return ok;
+  }
+
+  bool BinaryTableWriter::putTable(int index, int depth)
+  {
+    if (depth > maximumDepth)
+    {
+      return fail("tables nested too deeply");
+    }
+    if (!lua_checkstack(L, 8))
+    {
+      return fail("out of stack space");
+    }
+
+    // Already written?
+    lua_pushvalue(L, index);
+    lua_rawget(L, mTables);
+    if (lua_isinteger(L, -1))
+    {
+      bool ok = putByte(TAG_TABLE_REF) && putVarint(lua_tointeger(L, -1));
+      lua_pop(L, 1);
+      return ok;
+    }
+    lua_pop(L, 1);
+    lua_pushvalue(L, index);
+    lua_pushinteger(L, mTableCount++);
+    lua_rawset(L, mTables);
+
+    // Sizes are hints for the reader, so that it can preallocate.
+    lua_Integer n = lua_rawlen(L, index);
+    lua_Integer count = 0;
+    lua_pushnil(L);
+    while (lua_next(L, index))
+    {
+      count++;
+      lua_pop(L, 1);
+    }
+
+    if (!putByte(TAG_TABLE) || !putVarint(n) || !putVarint(count > n ? count - n : 0))
+    {
+      return false;
+    }
+
+    for (lua_Integer i = 1; i <= n; i++)
+    {
+      lua_rawgeti(L, index, i);
+      if (!putValue(depth + 1))
+      {
+        return false;
+      }
+    }
+
+    lua_pushnil(L);
+    while (lua_next(L, index))
+    {
+      if (lua_isinteger(L, -2))
+      {
+        lua_Integer k = lua_tointeger(L, -2);
+        if (k >= 1 && k <= n)
+        {
+          // Already written as part of the array.
+          lua_pop(L, 1);
+          continue;
+        }
+      }
+      // Write a copy of the key, then the value, leaving the key for lua_next.
+      lua_pushvalue(L, -2);
+      if (!putValue(depth + 1) || !putValue(depth + 1))
+      {
+        return false;
+      }
+    }
+
+    return putByte(TAG_END);
+  }
+
+  BinaryTableReader::BinaryTableReader(lua_State *L) : L(L)
+  {
+  }
+
+  bool BinaryTableReader::fail(const char *message)
+  {
+    if (mError.empty())
+    {
+      mError = message;
+    }
+    return false;
+  }
+
+  bool BinaryTableReader::fill()
+  {
+    mPosition = 0;
+    mCount = mReader.readBytes(mBuffer, bufferSize);
+    return mCount > 0;
+  }
+
+  bool BinaryTableReader::getByte(uint8_t &byte)
+  {
+    if (mPosition == mCount && !fill())
+    {
+      return fail("unexpected end of file");
+    }
+    byte = mBuffer[mPosition++];
+    return true;
+  }
+
+  bool BinaryTableReader::getBytes(void *data, size_t n)
+  {
+    uint8_t *p = (uint8_t *)data;
+    while (n > 0)
+    {
+      if (mPosition == mCount && !fill())
+      {
+        return fail("unexpected end of file");
+      }
+      size_t k = mCount - mPosition;
+      if (k > n)
+      {
+        k = n;
+      }
+      memcpy(p, mBuffer + mPosition, k);
+      mPosition += k;
+      p += k;
+      n -= k;
+    }
+    return true;
+  }
+
+  bool BinaryTableReader::getVarint(uint64_t &value)
+  {
+    value = 0;
+    for (int shift = 0; shift < 64; shift += 7)
+    {
+      uint8_t byte;
+      if (!getByte(byte))
+      {
+        return false;
+      }
+      value |= (uint64_t)(byte & 0x7F) << shift;
+      if ((byte & 0x80) == 0)
+      {
+        return true;
+      }
+    }
+    return fail("bad varint");
+  }
+
+  bool BinaryTableReader::read(const std::string &filename)
+  {
+    int top = lua_gettop(L);
+    mError.clear();
+    mPosition = 0;
+    mCount = 0;
+    mStringCount = 0;
+    mTableCount = 0;
+
+    if (!mReader.open(filename))
+    {
+      return fail("could not open file");
+    }
+    mFileSize = mReader.getSizeInBytes();
+
+    uint8_t header[headerSize];
+    if (!getBytes(header, headerSize) || memcmp(header, magic, sizeof(magic)) != 0)
+    {
+      mReader.close();
+      mError = "not a binary table";
+      return false;
+    }
+    if (header[4] > version)
+    {
+      mReader.close();
+      return fail("unsupported version");
+    }
+
+    if (!lua_checkstack(L, 4))
+    {
+      mReader.close();
+      return fail("out of stack space");
+    }
+    lua_newtable(L);
+    mStrings = lua_gettop(L);
+    lua_newtable(L);
+    mTables = lua_gettop(L);
+
+    bool ok = getValue(0);
+    mReader.close();
+    if (!ok)
+    {
+      lua_settop(L, top);
+      return false;
+    }
+
+    // Drop the reference maps.
+    lua_copy(L, -1, top + 1);
+    lua_settop(L, top + 1);
+    return true;
+  }
+
+  bool BinaryTableReader::getValue(int depth)
+  {
+    uint8_t tag;
+    return getByte(tag) && decode(tag, depth);
+  }
+
+  bool BinaryTableReader::decode(uint8_t tag, int depth)
+  {
+    uint64_t v;
+    switch (tag)
+    {
+    case TAG_NIL:
+      lua_pushnil(L);
+      return true;
+
+    case TAG_FALSE:
+    case TAG_TRUE:
+      lua_pushboolean(L, tag == TAG_TRUE);
+      return true;
+
+    case TAG_INTEGER:
+      if (!getVarint(v))
+      {
+        return false;
+      }
+      lua_pushinteger(L, (lua_Integer)unzigzag(v));
+      return true;
+
+    case TAG_FLOAT32:
+    {
+      float f;
+      if (!getBytes(&f, sizeof(f)))
+      {
+        return false;
+      }
+      lua_pushnumber(L, f);
+      return true;
+    }
+
+    case TAG_FLOAT64:
+    {
+      double d;
+      if (!getBytes(&d, sizeof(d)))
+      {
+        return false;
+      }
+      lua_pushnumber(L, (lua_Number)d);
+      return true;
+    }
+
+    case TAG_STRING:
+      if (!getVarint(v))
+      {
+        return false;
+      }
+      if (v > mFileSize)
+      {
+        return fail("bad string length");
+      }
+      if (v <= mCount - mPosition)
+      {
+        // Straight from the buffer.
+        lua_pushlstring(L, (const char *)mBuffer + mPosition, v);
+        mPosition += v;
+      }
+      else
+      {
+        mScratch.resize(v);
+        if (!getBytes(&mScratch[0], v))
+        {
+          return false;
+        }
+        lua_pushlstring(L, mScratch.data(), v);
+      }
+      lua_pushvalue(L, -1);
+      lua_rawseti(L, mStrings, ++mStringCount);
+      return true;
+
+    case TAG_STRING_REF:
+    case TAG_TABLE_REF:
+      if (!getVarint(v))
+      {
+        return false;
+      }
+      if (tag == TAG_STRING_REF ? v >= (uint64_t)mStringCount : v >= (uint64_t)mTableCount)
+      {
+        return fail("bad reference");
+      }
+      lua_rawgeti(L, tag == TAG_STRING_REF ? mStrings : mTables, v + 1);
+      return true;
+
+    case TAG_TABLE:
+      return getTable(depth);
+
+    default:
+      return fail("bad tag");
+    }
+  }
+
+  bool BinaryTableReader::getTable(int depth)
+  {
+    if (depth > maximumDepth)
+    {
+      return fail("tables nested too deeply");
+    }
+    if (!lua_checkstack(L, 8))
+    {
+      return fail("out of stack space");
+    }
+
+    uint64_t n, nrec;
+    if (!getVarint(n) || !getVarint(nrec))
+    {
+      return false;
+    }
+    // Every entry takes at least one byte.
+    if (n > mFileSize || nrec > mFileSize)
+    {
+      return fail("bad table size");
+    }
+
+    lua_createtable(L, n, nrec);
+    lua_pushvalue(L, -1);
+    lua_rawseti(L, mTables, ++mTableCount);
+
+    for (uint64_t i = 1; i <= n; i++)
+    {
+      if (!getValue(depth + 1))
+      {
+        return false;
+      }
+      lua_rawseti(L, -2, i);
+    }
+
+    while (true)
+    {
+      uint8_t tag;
+      if (!getByte(tag))
+      {
+        return false;
+      }
+      if (tag == TAG_END)
+      {
+        return true;
+      }
+      if (!decode(tag, depth + 1) || !getValue(depth + 1))
+      {
+        return false;
+      }
+      bool validKey = !lua_isnil(L, -2);
+      if (validKey && lua_type(L, -2) == LUA_TNUMBER && !lua_isinteger(L, -2))
+      {
+        lua_Number k = lua_tonumber(L, -2);
+        validKey = k == k;
+      }
+      if (validKey)
+      {
+        lua_rawset(L, -3);
+      }
+      else
+      {
+        lua_pop(L, 2);
+      }
+    }
+  }
+
+  int luaWriteBinaryTable(lua_State *L)
+  {
+    const char *filename = luaL_checkstring(L, 1);
+    luaL_checkany(L, 2);
+    int hooks = lua_istable(L, 3) ? 3 : 0;
+
+    std::unique_ptr<BinaryTableWriter> writer(new BinaryTableWriter(L));
+    if (writer->write(filename, 2, hooks))
+    {
+      lua_pushboolean(L, true);
+      return 1;
+    }
+    lua_pushboolean(L, false);
+    lua_pushstring(L, writer->getError().c_str());
+    return 2;
+  }
+
+  int luaReadBinaryTable(lua_State *L)
+  {
+    const char *filename = luaL_checkstring(L, 1);
+
+    std::unique_ptr<BinaryTableReader> reader(new BinaryTableReader(L));
+    if (reader->read(filename))
+    {
+      return 1;
+    }
+    lua_pushnil(L);
+    lua_pushstring(L, reader->getError().c_str());
+    return 2;
+  }
+
+} // namespace od
@@ -0,0 +1,130 @@
+#pragma once
+
+#include <od/extras/FileReader.h>
+#include <od/extras/FileWriter.h>
+#include <stdint.h>
+#include <string>
+
+extern "C"
+{
+#include "lua.h"
+}
+
+namespace od
+{
+
+  // Compact binary serialization of Lua values, used for presets and the
+  // other tables that Persist writes to disk.
+  //
+  // A file is the 8-byte header "ODBT" followed by a format version byte and
+  // 3 reserved bytes, then one tagged value.  Integers are zigzag varints,
+  // floats are little-endian IEEE.  A table is written as its array part
+  // (values only) followed by key/value pairs and an end tag.  Each string is
+  // written once and then referred to by index, and so is each table, which
+  // preserves shared references and cycles.
+  //
+  // Functions, userdata and threads are written as nil, as are keys that
+  // cannot be restored (nil or NaN after a hook).
+  namespace binarytable
+  {
+    enum Tag : uint8_t
+    {
+      TAG_NIL,
+      TAG_FALSE,
+      TAG_TRUE,
+      TAG_INTEGER,
+      TAG_FLOAT32,
+      TAG_FLOAT64,
+      TAG_STRING,
+      TAG_STRING_REF,
+      TAG_TABLE,
+      TAG_TABLE_REF,
+      TAG_END
+    };
+
+    static const char magic[4] = {'O', 'D', 'B', 'T'};
+    static const uint8_t version = 1;
+    static const int headerSize = 8;
+    static const int maximumDepth = 200;
+    static const int bufferSize = 4096;
+  } // namespace binarytable
+
+  class BinaryTableWriter
+  {
+  public:
+    BinaryTableWriter(lua_State *L);
+
+    // Writes the value at the given stack index.  Hooks (optional, 0 for
+    // none) is the stack index of a table of functions keyed by type name;
+    // each item of that type is replaced by what the hook returns.
+    bool write(const std::string &filename, int index, int hooks = 0);
+    const std::string &getError()
+    {
+      return mError;
+    }
+
+  private:
+    lua_State *L;
+    FileWriter mWriter;
+    uint8_t mBuffer[binarytable::bufferSize];
+    int mCount = 0;
+    // Stack indices of the string and table reference maps.
+    int mStrings = 0;
+    int mTables = 0;
+    int mHooks = 0;
+    int mStringCount = 0;
+    int mTableCount = 0;
+    std::string mError;
+
+    bool flush();
+    bool putByte(uint8_t byte);
+    bool putBytes(const void *data, size_t n);
+    bool putVarint(uint64_t value);
+    bool putValue(int depth);
+    bool putTable(int index, int depth);
+    bool fail(const char *message);
+  };
+
+  class BinaryTableReader
+  {
+  public:
+    BinaryTableReader(lua_State *L);
+
+    // Pushes the value read from the file.  On failure nothing is pushed.
+    bool read(const std::string &filename);
+    const std::string &getError()
+    {
+      return mError;
+    }
+
+  private:
+    lua_State *L;
+    FileReader mReader;
+    uint8_t mBuffer[binarytable::bufferSize];
+    uint32_t mPosition = 0;
+    uint32_t mCount = 0;
+    uint32_t mFileSize = 0;
+    int mStrings = 0;
+    int mTables = 0;
+    int mStringCount = 0;
+    int mTableCount = 0;
+    std::string mScratch;
+    std::string mError;
+
+    bool fill();
+    bool getByte(uint8_t &byte);
+    bool getBytes(void *data, size_t n);
+    bool getVarint(uint64_t &value);
+    bool getValue(int depth);
+    bool decode(uint8_t tag, int depth);
+    bool getTable(int depth);
+    bool fail(const char *message);
+  };
+
+  // Lua bindings (registered with %native in app.cpp.swig):
+  //   app.writeBinaryTable(filename, value[, hooks]) -> true | false, message
+  //   app.readBinaryTable(filename) -> value | nil, message
+  int luaWriteBinaryTable(lua_State *L);
+  int luaReadBinaryTable(lua_State *L);
+
+} // namespace od
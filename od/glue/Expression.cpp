@@ -106,6 +106,10 @@ namespace od
     switch (mOperation)
     {
     case Operation::function:
+      if (mProgram.valid())
+      {
+        return mProgram.value(mParameters);
+      }
       return interpreter().value(*this);
     case Operation::add:
       return mParameters[0]->value() + mParameters[1]->value();
@@ -129,6 +133,10 @@ namespace od
     switch (mOperation)
     {
     case Operation::function:
+      if (mProgram.valid())
+      {
+        return mProgram.target(mParameters);
+      }
       return interpreter().target(*this);
     case Operation::add:
       return mParameters[0]->target() + mParameters[1]->target();
@@ -147,6 +155,11 @@ namespace od
     }
   }
 
+  void Expression::benchmark()
+  {
+    interpreter().benchmark();
+  }
+
   int Expression::roundValue()
   {
     return fastRound(value());
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <od/objects/Followable.h>
+#include <od/glue/ExpressionProgram.h>
 #include <string>
 #include <vector>
 
@@ -29,11 +30,16 @@ namespace od
     void addParameter(Parameter *param);
     bool compile();
 
+    // Measure evaluations per second of native and Lua expressions.
+    static void benchmark();
+
   private:
     friend class ExpressionInterpreter;
     std::vector<Parameter *> mParameters;
     std::string mFunction;
     int mFunctionKey = 0;
+    // Used instead of the Lua function when the expression compiles natively.
+    ExpressionProgram mProgram;
     float mCachedValue = 0.0f;
     float mCachedTarget = 0.0f;
     enum Operation
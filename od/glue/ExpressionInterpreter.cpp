@@ -1,6 +1,7 @@
 #include <od/glue/ExpressionInterpreter.h>
 #include <od/objects/Parameter.h>
 #include <hal/log.h>
+#include <hal/timing.h>
 
 extern "C"
 {
@@ -40,18 +41,6 @@ namespace od
 
       lua_gc(L, LUA_GCGEN, 0, 0);
 
-#ifndef BUILDOPT_LUA_USE_REALLOC
-      const int multiplier = 2;
-      mAllocator.add(16, 1500 * multiplier);
-      mAllocator.add(32, 3500 * multiplier);
-      mAllocator.add(64, 2500 * multiplier);
-      mAllocator.add(128, 600 * multiplier);
-      mAllocator.add(256, 200 * multiplier);
-      mAllocator.add(512, 150 * multiplier);
-      mAllocator.add(1024, 75 * multiplier);
-      mAllocator.add(2048, 15 * multiplier);
-#endif
-
       openStandardlibs(L);
 
       // A table to hold functions.  Pre-allocate 64 entries.
@@ -68,6 +57,21 @@ namespace od
   }
 
   bool ExpressionInterpreter::compile(Expression &e)
+  {
+    if (e.mProgram.compile(e.mFunction))
+    {
+      if (e.mFunctionKey != 0)
+      {
+        remove(e);
+      }
+      return true;
+    }
+
+    logDebug(1, "Expression: falling back to Lua for [%s]", e.mFunction.c_str());
+    return compileLua(e);
+  }
+
+  bool ExpressionInterpreter::compileLua(Expression &e)
   {
     std::string tmp("return ");
     tmp += e.mFunction;
@@ -122,9 +126,14 @@ namespace od
 
   void ExpressionInterpreter::remove(Expression &e)
   {
+    if (e.mFunctionKey == 0)
+    {
+      return;
+    }
     disable();
     lua_pushnil(L);
     lua_rawseti(L, mFunctionTable, e.mFunctionKey);
+    e.mFunctionKey = 0;
     enable();
   }
 
@@ -183,109 +192,71 @@ namespace od
     mEnabled = true;
   }
 
-  /*
-ExpressionInterpreter::test(0):
-Expression: [function(x) return math.sin(x) + 1 end]
-Expression: sum = 1847927.0000
-Expression: 1617 ticks per call 1.6169 us per call
-Native: sum = 1847927.0000
-Native: 484 ticks per call 0.4847 us per call
-
-ExpressionInterpreter::test(1):
-Expression: [function(x) return x*x end]
-Expression: sum = 1000000.0000
-Expression: 648 ticks per call 0.6485 us per call
-Native: sum = 1000000.0000
-Native: 41 ticks per call 0.0413 us per call
-
-ExpressionInterpreter::test(2):
-Expression: [*]
-Expression: sum = 1000000.0000
-Expression: 61 ticks per call 0.0610 us per call
-Native: sum = 1000000.0000
-Native: 41 ticks per call 0.0413 us per call
- */
-
-#ifdef BUILDOPT_TEST
-
-  void ExpressionInterpreter::test(int type)
+  static float evaluationsPerSecond(Expression &e, int count, float &sum)
   {
-    logInfo("ExpressionInterpreter::test(%d): ", type);
-
-    int i;
-    tick_t start;
-    tick_t elapsed;
-    int tickspercall;
-    float microsecspercall;
-    Expression E;
-    Parameter X("test");
-
-    E.attach();
-    X.attach();
-    X.hardSet(1.0f);
-    E.addParameter(&X);
-    E.addParameter(&X);
-
-    switch (type)
+    tick_t start = ticks();
+    sum = 0.0f;
+    for (int i = 0; i < count; i++)
     {
-    case 0:
-      E.setFunction("function(x) return math.sin(x) + 1 end");
-      break;
-    case 1:
-      E.setFunction("function(x) return x*x end");
-      break;
-    case 2:
-      E.setFunction("*");
-      break;
+      sum += e.value();
     }
+    tick_t elapsed = ticks() - start;
+    float secs = ticks2secs(elapsed);
+    return secs > 0.0f ? count / secs : 0.0f;
+  }
 
-    logInfo("Expression: [%s] ", E.getFunction());
+  void ExpressionInterpreter::benchmark()
+  {
+    static const char *functions[] = {
+        "function(x) return x*x end",
+        "function(x) return math.sin(x) + 1 end",
+        "function(x) return math.max(x, 0.0) end",
+        "function(x, y) return x > y and x - y or 0 end",
+        "function(x, y) return math.floor(x * 4) / 4 + y ^ 2 end",
+        "function(x) local y = x * 2 return y end",
+    };
+    const int count = 100000;
+
+    Parameter X("x"), Y("y");
+    X.attach();
+    Y.attach();
+    X.hardSet(0.7f);
+    Y.hardSet(0.2f);
 
-    if (!E.compile())
+    for (const char *function : functions)
     {
-      logError("Failed to compile expression. ");
-      return;
-    }
+      Expression E;
+      E.attach();
+      E.addParameter(&X);
+      E.addParameter(&Y);
+      E.setFunction(function);
+      logInfo("Expression: [%s]", function);
+
+      if (!E.compile())
+      {
+        logError("Failed to compile expression.");
+        continue;
+      }
 
-    start = ticks();
-    float sum = 0.0f;
-    for (i = 0; i < 1000000; i++)
-    {
-      sum += E.value();
-    }
-    elapsed = ticks() - start;
-    logInfo("Expression: sum = %f ", sum);
-    tickspercall = elapsed / 1000000;
-    microsecspercall = ticks2secs(elapsed);
-    logInfo("Expression: %d ticks per call %f us per call",
-            tickspercall, microsecspercall);
-
-    start = ticks();
-    sum = 0.0f;
-    switch (type)
-    {
-    case 0:
-      for (i = 0; i < 1000000; i++)
+      float sum;
+      if (E.mProgram.valid())
       {
-        sum += sinf(X.value()) + 1;
+        float rate = evaluationsPerSecond(E, count, sum);
+        logInfo("  Native: sum = %f, %d evaluations/sec", sum, (int)rate);
+        E.mProgram.clear();
+        if (!compileLua(E))
+        {
+          continue;
+        }
       }
-      break;
-    case 1:
-    case 2:
-      for (i = 0; i < 1000000; i++)
+      else
       {
-        sum += X.value() * X.value();
+        logInfo("  Native: unsupported");
       }
-      break;
-    }
 
-    elapsed = ticks() - start;
-    logInfo("Native: sum = %f ", sum);
-    tickspercall = elapsed / 1000000;
-    microsecspercall = ticks2secs(elapsed);
-    logInfo("Native: %d ticks per call %f us per call", tickspercall,
-            microsecspercall);
+      float rate = evaluationsPerSecond(E, count, sum);
+      logInfo("  Lua: sum = %f, %d evaluations/sec", sum, (int)rate);
+    }
   }
-#endif
 
 } /* namespace od */
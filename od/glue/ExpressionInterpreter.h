@@ -14,6 +14,7 @@ namespace od
     virtual ~ExpressionInterpreter();
 
     // Not OK to call in the audio thread.
+    // Compiles to a native ExpressionProgram when possible, otherwise to Lua.
     bool compile(Expression &e);
     void remove(Expression &e);
 
@@ -21,9 +22,7 @@ namespace od
     float value(Expression &e);
     float target(Expression &e);
 
-#ifdef BUILDOPT_TESTING
-    void test(int type);
-#endif
+    void benchmark();
 
   private:
     Mutex mMutex;
@@ -32,6 +31,7 @@ namespace od
 
     void enable();
     void disable();
+    bool compileLua(Expression &e);
   };
 
 } /* namespace od */
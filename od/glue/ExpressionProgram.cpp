@@ -0,0 +1,743 @@
+#include <od/glue/ExpressionProgram.h>
+#include <od/objects/Parameter.h>
+#include <hal/log.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+
+namespace od
+{
+
+  struct MathEntry
+  {
+    const char *name;
+    ExpressionProgram::OpCode op;
+    // Allowed argument counts (maxArgs < 0 means variadic).
+    int minArgs;
+    int maxArgs;
+  };
+
+  static const MathEntry mathFunctions[] = {
+      {"abs", ExpressionProgram::opAbs, 1, 1},
+      {"ceil", ExpressionProgram::opCeil, 1, 1},
+      {"floor", ExpressionProgram::opFloor, 1, 1},
+      {"sqrt", ExpressionProgram::opSqrt, 1, 1},
+      {"exp", ExpressionProgram::opExp, 1, 1},
+      {"log", ExpressionProgram::opLog, 1, 2},
+      {"sin", ExpressionProgram::opSin, 1, 1},
+      {"cos", ExpressionProgram::opCos, 1, 1},
+      {"tan", ExpressionProgram::opTan, 1, 1},
+      {"asin", ExpressionProgram::opAsin, 1, 1},
+      {"acos", ExpressionProgram::opAcos, 1, 1},
+      {"atan", ExpressionProgram::opAtan, 1, 2},
+      {"fmod", ExpressionProgram::opFmod, 2, 2},
+      {"min", ExpressionProgram::opMin, 1, -1},
+      {"max", ExpressionProgram::opMax, 1, -1},
+  };
+
+  // Recursive descent parser modelled on Lua's own lparser.c (subexpr with
+  // the same operator priorities) that emits ExpressionProgram bytecode.
+  // Any construct outside the supported subset fails the compile so that
+  // the caller can fall back to the Lua interpreter.
+  class ExpressionCompiler
+  {
+  public:
+    ExpressionCompiler(const std::string &text, ExpressionProgram &program) : mText(text.c_str()), mCode(program.mCode)
+    {
+    }
+
+    bool run()
+    {
+      mCode.clear();
+      next();
+      if (!acceptName("function") || !acceptSymbol("("))
+      {
+        return false;
+      }
+      if (!acceptSymbol(")"))
+      {
+        do
+        {
+          if (mToken != tokenName || isKeyword())
+          {
+            return false;
+          }
+          mArguments.push_back(mTokenText);
+          next();
+        } while (acceptSymbol(","));
+        if (!acceptSymbol(")"))
+        {
+          return false;
+        }
+      }
+      if (!acceptName("return") || !expression(0))
+      {
+        return false;
+      }
+      acceptSymbol(";");
+      if (!acceptName("end") || mToken != tokenEnd || mFailed)
+      {
+        return false;
+      }
+      return true;
+    }
+
+  private:
+    enum Token
+    {
+      tokenEnd,
+      tokenNumber,
+      tokenName,
+      tokenSymbol,
+      tokenInvalid
+    };
+
+    const char *mText;
+    std::vector<ExpressionProgram::Instruction> &mCode;
+    std::vector<std::string> mArguments;
+    Token mToken = tokenInvalid;
+    std::string mTokenText;
+    float mTokenNumber = 0.0f;
+    int mDepth = 0;
+    bool mFailed = false;
+
+    void next()
+    {
+      while (isspace(*mText))
+      {
+        mText++;
+      }
+
+      const char *start = mText;
+      if (*mText == 0)
+      {
+        mToken = tokenEnd;
+      }
+      else if (isdigit(*mText) || (*mText == '.' && isdigit(mText[1])))
+      {
+        char *end;
+        mTokenNumber = strtof(mText, &end);
+        mText = end;
+        mToken = isalnum(*mText) || *mText == '_' || *mText == '.' ? tokenInvalid : tokenNumber;
+      }
+      else if (isalpha(*mText) || *mText == '_')
+      {
+        while (isalnum(*mText) || *mText == '_')
+        {
+          mText++;
+        }
+        mToken = tokenName;
+      }
+      else
+      {
+        static const char *symbols[] = {
+            "//", "==", "~=", "<=", ">=", "+", "-", "*", "/", "%", "^",
+            "<", ">", "(", ")", ",", ".", ";"};
+        mToken = tokenInvalid;
+        for (const char *s : symbols)
+        {
+          size_t n = strlen(s);
+          if (strncmp(mText, s, n) == 0)
+          {
+            mText += n;
+            mToken = tokenSymbol;
+            break;
+          }
+        }
+        // Reject comments, concatenation, varargs and the like.
+        if (mToken == tokenSymbol && (strncmp(start, "--", 2) == 0 || strncmp(start, "..", 2) == 0))
+        {
+          mToken = tokenInvalid;
+        }
+      }
+      mTokenText.assign(start, mText - start);
+    }
+
+    bool isKeyword()
+    {
+      static const char *keywords[] = {
+          "and", "break", "do", "else", "elseif", "end", "false", "for",
+          "function", "goto", "if", "in", "local", "nil", "not", "or",
+          "repeat", "return", "then", "true", "until", "while"};
+      for (const char *k : keywords)
+      {
+        if (mTokenText == k)
+        {
+          return true;
+        }
+      }
+      return false;
+    }
+
+    bool isSymbol(const char *s)
+    {
+      return mToken == tokenSymbol && mTokenText == s;
+    }
+
+    bool isName(const char *s)
+    {
+      return mToken == tokenName && mTokenText == s;
+    }
+
+    bool acceptSymbol(const char *s)
+    {
+      if (isSymbol(s))
+      {
+        next();
+        return true;
+      }
+      return false;
+    }
+
+    bool acceptName(const char *s)
+    {
+      if (isName(s))
+      {
+        next();
+        return true;
+      }
+      return false;
+    }
+
+    int emit(ExpressionProgram::OpCode op, int index = 0, float constant = 0.0f)
+    {
+      ExpressionProgram::Instruction instruction;
+      instruction.op = op;
+      instruction.index = index;
+      instruction.constant = constant;
+      mCode.push_back(instruction);
+      return mCode.size() - 1;
+    }
+
+    void push()
+    {
+      mDepth++;
+      if (mDepth > ExpressionProgram::MaximumStackDepth)
+      {
+        mFailed = true;
+      }
+    }
+
+    void pop(int n = 1)
+    {
+      mDepth -= n;
+    }
+
+    bool simpleExpression()
+    {
+      if (mToken == tokenNumber)
+      {
+        emit(ExpressionProgram::opPushConstant, 0, mTokenNumber);
+        push();
+        next();
+        return true;
+      }
+      else if (acceptName("true"))
+      {
+        emit(ExpressionProgram::opPushTrue);
+        push();
+        return true;
+      }
+      else if (acceptName("false"))
+      {
+        emit(ExpressionProgram::opPushFalse);
+        push();
+        return true;
+      }
+      else if (acceptName("nil"))
+      {
+        emit(ExpressionProgram::opPushNil);
+        push();
+        return true;
+      }
+      else if (acceptSymbol("("))
+      {
+        return expression(0) && acceptSymbol(")");
+      }
+      else if (mToken == tokenName && !isKeyword())
+      {
+        // Later arguments shadow earlier ones with the same name.
+        for (int i = (int)mArguments.size() - 1; i >= 0; i--)
+        {
+          if (mArguments[i] == mTokenText)
+          {
+            next();
+            emit(ExpressionProgram::opLoadArgument, i);
+            push();
+            // Arguments are numbers (or nil) and cannot be indexed or called.
+            return !isSymbol(".") && !isSymbol("(");
+          }
+        }
+        if (acceptName("math") && acceptSymbol("."))
+        {
+          return mathMember();
+        }
+      }
+      return false;
+    }
+
+    bool mathMember()
+    {
+      if (mToken != tokenName)
+      {
+        return false;
+      }
+      std::string member = mTokenText;
+      next();
+
+      if (member == "pi")
+      {
+        emit(ExpressionProgram::opPushConstant, 0, (float)M_PI);
+        push();
+        return true;
+      }
+      else if (member == "huge")
+      {
+        emit(ExpressionProgram::opPushConstant, 0, HUGE_VALF);
+        push();
+        return true;
+      }
+
+      for (const MathEntry &entry : mathFunctions)
+      {
+        if (member == entry.name)
+        {
+          if (!acceptSymbol("("))
+          {
+            return false;
+          }
+          int count = 0;
+          if (!acceptSymbol(")"))
+          {
+            do
+            {
+              if (!expression(0))
+              {
+                return false;
+              }
+              count++;
+            } while (acceptSymbol(","));
+            if (!acceptSymbol(")"))
+            {
+              return false;
+            }
+          }
+          if (count < entry.minArgs || (entry.maxArgs > 0 && count > entry.maxArgs))
+          {
+            return false;
+          }
+
+          ExpressionProgram::OpCode op = entry.op;
+          if (op == ExpressionProgram::opLog && count == 2)
+          {
+            op = ExpressionProgram::opLogBase;
+          }
+          else if (op == ExpressionProgram::opAtan && count == 2)
+          {
+            op = ExpressionProgram::opAtan2;
+          }
+          emit(op, count);
+          pop(count);
+          push();
+          return true;
+        }
+      }
+      return false;
+    }
+
+    // Lua operator priorities {left, right} from lparser.c.
+    bool binaryOperator(ExpressionProgram::OpCode &op, int &left, int &right)
+    {
+      struct Entry
+      {
+        const char *text;
+        ExpressionProgram::OpCode op;
+        int left;
+        int right;
+      };
+      static const Entry table[] = {
+          {"+", ExpressionProgram::opAdd, 10, 10},
+          {"-", ExpressionProgram::opSubtract, 10, 10},
+          {"*", ExpressionProgram::opMultiply, 11, 11},
+          {"%", ExpressionProgram::opModulo, 11, 11},
+          {"^", ExpressionProgram::opPower, 14, 13},
+          {"/", ExpressionProgram::opDivide, 11, 11},
+          {"//", ExpressionProgram::opFloorDivide, 11, 11},
+          {"==", ExpressionProgram::opEqual, 3, 3},
+          {"<", ExpressionProgram::opLess, 3, 3},
+          {"<=", ExpressionProgram::opLessEqual, 3, 3},
+          {"~=", ExpressionProgram::opNotEqual, 3, 3},
+          {">", ExpressionProgram::opGreater, 3, 3},
+          {">=", ExpressionProgram::opGreaterEqual, 3, 3},
+          {"and", ExpressionProgram::opJumpIfFalse, 2, 2},
+          {"or", ExpressionProgram::opJumpIfTrue, 1, 1},
+      };
+
+      if (mToken != tokenSymbol && mToken != tokenName)
+      {
+        return false;
+      }
+      for (const Entry &entry : table)
+      {
+        if (mTokenText == entry.text)
+        {
+          op = entry.op;
+          left = entry.left;
+          right = entry.right;
+          return true;
+        }
+      }
+      return false;
+    }
+
+    bool expression(int limit)
+    {
+      static const int unaryPriority = 12;
+
+      if (acceptSymbol("-"))
+      {
+        if (!expression(unaryPriority))
+        {
+          return false;
+        }
+        emit(ExpressionProgram::opNegate);
+      }
+      else if (acceptName("not"))
+      {
+        if (!expression(unaryPriority))
+        {
+          return false;
+        }
+        emit(ExpressionProgram::opNot);
+      }
+      else if (!simpleExpression())
+      {
+        return false;
+      }
+
+      ExpressionProgram::OpCode op;
+      int left, right;
+      while (binaryOperator(op, left, right) && left > limit)
+      {
+        next();
+        if (op == ExpressionProgram::opJumpIfFalse || op == ExpressionProgram::opJumpIfTrue)
+        {
+          // Short circuit: keep the left operand if it decides the result,
+          // otherwise pop it and evaluate the right operand.
+          int jump = emit(op);
+          pop();
+          if (!expression(right))
+          {
+            return false;
+          }
+          mCode[jump].index = mCode.size();
+        }
+        else
+        {
+          if (!expression(right))
+          {
+            return false;
+          }
+          emit(op);
+          pop();
+        }
+      }
+      return !mFailed;
+    }
+  };
+
+  bool ExpressionProgram::compile(const std::string &function)
+  {
+    ExpressionCompiler compiler(function, *this);
+    if (compiler.run())
+    {
+      return true;
+    }
+    clear();
+    return false;
+  }
+
+  void ExpressionProgram::clear()
+  {
+    mCode.clear();
+  }
+
+  float ExpressionProgram::value(const std::vector<Parameter *> &parameters)
+  {
+    return evaluate<false>(parameters);
+  }
+
+  float ExpressionProgram::target(const std::vector<Parameter *> &parameters)
+  {
+    return evaluate<true>(parameters);
+  }
+
+  namespace
+  {
+    enum ValueType : uint8_t
+    {
+      typeNil,
+      typeFalse,
+      typeTrue,
+      typeNumber
+    };
+
+    struct Value
+    {
+      float x;
+      ValueType type;
+    };
+
+    static inline bool isTruthy(const Value &v)
+    {
+      return v.type >= typeTrue;
+    }
+
+    static inline Value number(float x)
+    {
+      Value v;
+      v.x = x;
+      v.type = typeNumber;
+      return v;
+    }
+
+    static inline Value boolean(bool b)
+    {
+      Value v;
+      v.x = 0.0f;
+      v.type = b ? typeTrue : typeFalse;
+      return v;
+    }
+  } // namespace
+
+  template <bool useTarget>
+  float ExpressionProgram::evaluate(const std::vector<Parameter *> &parameters)
+  {
+    Value stack[MaximumStackDepth];
+    int top = -1;
+    int n = mCode.size();
+
+    for (int pc = 0; pc < n; pc++)
+    {
+      const Instruction &instruction = mCode[pc];
+      switch (instruction.op)
+      {
+      case opPushConstant:
+        stack[++top] = number(instruction.constant);
+        continue;
+      case opPushNil:
+        stack[++top].type = typeNil;
+        continue;
+      case opPushFalse:
+        stack[++top] = boolean(false);
+        continue;
+      case opPushTrue:
+        stack[++top] = boolean(true);
+        continue;
+      case opLoadArgument:
+        if (instruction.index < (int)parameters.size())
+        {
+          Parameter *param = parameters[instruction.index];
+          stack[++top] = number(useTarget ? param->target() : param->value());
+        }
+        else
+        {
+          stack[++top].type = typeNil;
+        }
+        continue;
+      case opNot:
+        stack[top] = boolean(!isTruthy(stack[top]));
+        continue;
+      case opJumpIfFalse:
+        if (isTruthy(stack[top]))
+        {
+          top--;
+        }
+        else
+        {
+          pc = instruction.index - 1;
+        }
+        continue;
+      case opJumpIfTrue:
+        if (isTruthy(stack[top]))
+        {
+          pc = instruction.index - 1;
+        }
+        else
+        {
+          top--;
+        }
+        continue;
+      case opEqual:
+      case opNotEqual:
+      {
+        Value &a = stack[top - 1];
+        Value &b = stack[top];
+        bool equal = a.type == b.type && (a.type != typeNumber || a.x == b.x);
+        top--;
+        stack[top] = boolean(instruction.op == opEqual ? equal : !equal);
+        continue;
+      }
+      default:
+        break;
+      }
+
+      // The remaining operations only accept numbers; anything else is a
+      // runtime error in Lua which the interpreter converts to 0.
+      int count = instruction.index;
+      if (instruction.op < opAbs)
+      {
+        count = instruction.op == opNegate ? 1 : 2;
+      }
+      float x[MaximumStackDepth];
+      top -= count - 1;
+      for (int i = 0; i < count; i++)
+      {
+        if (stack[top + i].type != typeNumber)
+        {
+          return 0.0f;
+        }
+        x[i] = stack[top + i].x;
+      }
+
+      switch (instruction.op)
+      {
+      case opNegate:
+        stack[top] = number(-x[0]);
+        break;
+      case opAdd:
+        stack[top] = number(x[0] + x[1]);
+        break;
+      case opSubtract:
+        stack[top] = number(x[0] - x[1]);
+        break;
+      case opMultiply:
+        stack[top] = number(x[0] * x[1]);
+        break;
+      case opDivide:
+        stack[top] = number(x[0] / x[1]);
+        break;
+      case opFloorDivide:
+        stack[top] = number(floorf(x[0] / x[1]));
+        break;
+      case opModulo:
+      {
+        float m = fmodf(x[0], x[1]);
+        if ((m > 0) ? x[1] < 0 : (m < 0 && x[1] > 0))
+        {
+          m += x[1];
+        }
+        stack[top] = number(m);
+        break;
+      }
+      case opPower:
+        stack[top] = number(x[1] == 2.0f ? x[0] * x[0] : powf(x[0], x[1]));
+        break;
+      case opLess:
+        stack[top] = boolean(x[0] < x[1]);
+        break;
+      case opLessEqual:
+        stack[top] = boolean(x[0] <= x[1]);
+        break;
+      case opGreater:
+        stack[top] = boolean(x[0] > x[1]);
+        break;
+      case opGreaterEqual:
+        stack[top] = boolean(x[0] >= x[1]);
+        break;
+      case opAbs:
+        stack[top] = number(fabsf(x[0]));
+        break;
+      case opCeil:
+        stack[top] = number(ceilf(x[0]));
+        break;
+      case opFloor:
+        stack[top] = number(floorf(x[0]));
+        break;
+      case opSqrt:
+        stack[top] = number(sqrtf(x[0]));
+        break;
+      case opExp:
+        stack[top] = number(expf(x[0]));
+        break;
+      case opLog:
+        stack[top] = number(logf(x[0]));
+        break;
+      case opLogBase:
+        if (x[1] == 2.0f)
+        {
+          stack[top] = number(log2f(x[0]));
+        }
+        else if (x[1] == 10.0f)
+        {
+          stack[top] = number(log10f(x[0]));
+        }
+        else
+        {
+          stack[top] = number(logf(x[0]) / logf(x[1]));
+        }
+        break;
+      case opSin:
+        stack[top] = number(sinf(x[0]));
+        break;
+      case opCos:
+        stack[top] = number(cosf(x[0]));
+        break;
+      case opTan:
+        stack[top] = number(tanf(x[0]));
+        break;
+      case opAsin:
+        stack[top] = number(asinf(x[0]));
+        break;
+      case opAcos:
+        stack[top] = number(acosf(x[0]));
+        break;
+      case opAtan:
+        stack[top] = number(atanf(x[0]));
+        break;
+      case opAtan2:
+        stack[top] = number(atan2f(x[0], x[1]));
+        break;
+      case opFmod:
+        stack[top] = number(fmodf(x[0], x[1]));
+        break;
+      case opMin:
+      {
+        float m = x[0];
+        for (int i = 1; i < count; i++)
+        {
+          if (x[i] < m)
+          {
+            m = x[i];
+          }
+        }
+        stack[top] = number(m);
+        break;
+      }
+      case opMax:
+      {
+        float m = x[0];
+        for (int i = 1; i < count; i++)
+        {
+          if (x[i] > m)
+          {
+            m = x[i];
+          }
+        }
+        stack[top] = number(m);
+        break;
+      }
+      default:
+        return 0.0f;
+      }
+    }
+
+    if (top >= 0 && stack[top].type == typeNumber)
+    {
+      return stack[top].x;
+    }
+    return 0.0f;
+  }
+
+} /* namespace od */
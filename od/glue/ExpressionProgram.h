@@ -0,0 +1,97 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+namespace od
+{
+
+  class Parameter;
+
+  // Native evaluator for the common subset of Lua expression functions:
+  //
+  //   function(a, b, ...) return <expr> end
+  //
+  // where <expr> uses numbers, the arguments, true/false/nil, arithmetic
+  // (+ - * / // % ^), comparisons, and/or/not, math.pi, math.huge and the
+  // math.* functions listed in ExpressionProgram.cpp.  Evaluation follows
+  // Lua semantics (a runtime error evaluates to 0) without touching the Lua
+  // VM, so it is safe and cheap to call from the audio thread.
+  class ExpressionProgram
+  {
+  public:
+    // Not OK to call in the audio thread.
+    bool compile(const std::string &function);
+    void clear();
+
+    // OK to call in the audio thread.
+    bool valid()
+    {
+      return mCode.size() > 0;
+    }
+    float value(const std::vector<Parameter *> &parameters);
+    float target(const std::vector<Parameter *> &parameters);
+
+    enum OpCode : uint8_t
+    {
+      opPushConstant,
+      opPushNil,
+      opPushFalse,
+      opPushTrue,
+      opLoadArgument,
+      opNegate,
+      opNot,
+      opAdd,
+      opSubtract,
+      opMultiply,
+      opDivide,
+      opFloorDivide,
+      opModulo,
+      opPower,
+      opEqual,
+      opNotEqual,
+      opLess,
+      opLessEqual,
+      opGreater,
+      opGreaterEqual,
+      opJumpIfFalse,
+      opJumpIfTrue,
+      opAbs,
+      opCeil,
+      opFloor,
+      opSqrt,
+      opExp,
+      opLog,
+      opLogBase,
+      opSin,
+      opCos,
+      opTan,
+      opAsin,
+      opAcos,
+      opAtan,
+      opAtan2,
+      opFmod,
+      opMin,
+      opMax,
+    };
+
+    struct Instruction
+    {
+      OpCode op;
+      // Argument index, jump target or argument count depending on op.
+      int16_t index;
+      float constant;
+    };
+
+    static const int MaximumStackDepth = 16;
+
+  private:
+    friend class ExpressionCompiler;
+    std::vector<Instruction> mCode;
+
+    template <bool useTarget>
+    float evaluate(const std::vector<Parameter *> &parameters);
+  };
+
+} /* namespace od */
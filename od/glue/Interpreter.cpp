@@ -1,4 +1,5 @@
 #include <od/glue/Interpreter.h>
+#include <od/extras/MemoryTracker.h>
 //#define BUILDOPT_VERBOSE
 //#define BUILDOPT_DEBUG_LEVEL 10
 #include <hal/log.h>
@@ -114,11 +115,18 @@ namespace od
     if (nsize > 0 && ptr2 == NULL)
     {
       logWarn("Interpreter::realloc: out of memory (osize=%d, nsize=%d)", osize, nsize);
+      return ptr2;
     }
-    return ptr2;
 #else
-    return realloc(ptr, nsize);
+    void *ptr2 = realloc(ptr, nsize);
+    if (nsize > 0 && ptr2 == NULL)
+    {
+      return ptr2;
+    }
 #endif
+    // When ptr is NULL, osize holds the type of the new object instead of a size.
+    MemoryTracker::resize(MEMORY_LUA, ptr ? osize : 0, nsize);
+    return ptr2;
   }
 
   void Interpreter::writeStringCallback(const char *buffer, size_t sz)
@@ -151,6 +159,85 @@ namespace od
     logInfo("Allocation recording disabled.");
     logInfo("Misses = %d", mMisses);
 #endif
+#ifndef BUILDOPT_LUA_USE_REALLOC
+    mAllocator.print();
+#endif
+  }
+
+  bool Interpreter::collectIdle(tick_t budget)
+  {
+    if (budget <= 0)
+    {
+      return false;
+    }
+
+    if (!mIdleCycleActive)
+    {
+      int kb = lua_gc(L, LUA_GCCOUNT, 0);
+      if (kb * 100 < mIdleBaseKB * mIdleCollectThreshold)
+      {
+        return false;
+      }
+      mIdleCycleActive = true;
+    }
+
+    tick_t start = ticks();
+    tick_t deadline = start + budget;
+    do
+    {
+      int res = lua_gc(L, LUA_GCSTEP, 0);
+      if (res == 1)
+      {
+        // Cycle finished.
+        mIdleCycleActive = false;
+        mIdleBaseKB = lua_gc(L, LUA_GCCOUNT, 0);
+        mIdleCycleCount++;
+        break;
+      }
+      else if (res < 0)
+      {
+        // Called from a finalizer.
+        break;
+      }
+    } while (ticks() < deadline);
+
+    tick_t pause = ticks() - start;
+    mIdleSliceCount++;
+    mIdlePauseLast = pause;
+    mIdlePauseTotal += pause;
+    if (pause > mIdlePauseMax)
+    {
+      mIdlePauseMax = pause;
+    }
+    if (pause > budget)
+    {
+      mIdleOverBudgetCount++;
+    }
+    return true;
+  }
+
+  void Interpreter::printCollectorStats()
+  {
+    double ms = 1000.0 * ticks2secsD(1);
+    logInfo("Idle GC: %lu slices, %lu cycles, %lu over budget",
+            (unsigned long)mIdleSliceCount, (unsigned long)mIdleCycleCount,
+            (unsigned long)mIdleOverBudgetCount);
+    if (mIdleSliceCount > 0)
+    {
+      logInfo("Idle GC pause: avg %0.3f ms, max %0.3f ms, last %0.3f ms",
+              ms * mIdlePauseTotal / mIdleSliceCount, ms * mIdlePauseMax,
+              ms * mIdlePauseLast);
+    }
+  }
+
+  void Interpreter::resetCollectorStats()
+  {
+    mIdleSliceCount = 0;
+    mIdleCycleCount = 0;
+    mIdleOverBudgetCount = 0;
+    mIdlePauseTotal = 0;
+    mIdlePauseMax = 0;
+    mIdlePauseLast = 0;
   }
 
   void Interpreter::dumpStack(const char * label)
@@ -186,26 +273,6 @@ namespace od
 
 #ifndef BUILDOPT_LUA_USE_REALLOC
 
-  void *Interpreter::getBuffer(size_t size)
-  {
-    void *ptr = mAllocator.get(size);
-    if (ptr)
-    {
-      return ptr;
-    }
-    mMisses++;
-    return Heap_malloc(size);
-  }
-
-  void Interpreter::releaseBuffer(void *ptr)
-  {
-    if (!mAllocator.release((uint8_t *)ptr))
-    {
-      // Belongs to Heap_malloc.
-      Heap_free(ptr);
-    }
-  }
-
   void *Interpreter::allocate(size_t size)
   {
 #if INTERPRETER_RECORD_ALLOCATIONS
@@ -219,89 +286,52 @@ namespace od
     }
     void *result;
     volatile tick_t start = ticks();
-    result = getBuffer(size);
+    result = mAllocator.allocate(size);
     mTotalElapsed += ticks() - start;
     mTotalCount++;
-    return result;
 #else
-    return getBuffer(size);
+    void *result = mAllocator.allocate(size);
 #endif
+    if (result == NULL)
+    {
+      mMisses++;
+    }
+    return result;
   }
 
   void Interpreter::deallocate(void *ptr, size_t size)
   {
-#if RECORD_ALLOCATIONS
+#if INTERPRETER_RECORD_ALLOCATIONS
     Record &rec = mRecords[nextPowerOfTwo(size)];
     rec.current--;
     volatile tick_t start = ticks();
-    releaseBuffer(ptr);
+    mAllocator.free(ptr, size);
     mTotalElapsed += ticks() - start;
 #else
-    releaseBuffer(ptr);
+    mAllocator.free(ptr, size);
 #endif
   }
 
   void *Interpreter::reallocate(void *ptr, size_t osize, size_t nsize)
   {
+    if (ptr == NULL)
+    {
+      // osize holds the type of the new object, not a size.
+      return nsize > 0 ? allocate(nsize) : NULL;
+    }
+
     if (nsize == 0)
     {
-      if (ptr && osize > 0)
-      {
-        //debug_printf("Lua: freeing %d bytes.",osize);
-        deallocate(ptr, osize);
-      }
+      deallocate(ptr, osize);
       return NULL;
     }
-    else
+
+    void *ptr2 = mAllocator.reallocate(ptr, osize, nsize);
+    if (ptr2 == NULL)
     {
-      if (ptr)
-      {
-        size_t asize = mAllocator.getActualSize((uint8_t *)ptr);
-        if (asize == 0)
-        {
-          // Belongs to Heap_malloc.
-          return Heap_realloc(ptr, nsize);
-        }
-        if (osize > nsize)
-        {
-          // shrinking
-          return mAllocator.shrink((uint8_t *)ptr, nsize);
-        }
-        else if (osize < nsize)
-        {
-          // growing
-          if (nsize <= asize)
-          {
-            // do nothing
-            return ptr;
-          }
-          else
-          {
-            uint8_t *ptr2 = (uint8_t *)allocate(nsize);
-            if (ptr2)
-            {
-              memcpy(ptr2, ptr, osize);
-              deallocate(ptr, osize);
-              return ptr2;
-            }
-            else
-            {
-              // out of memory
-              return NULL;
-            }
-          }
-        }
-        else
-        {
-          // nothing to do
-          return ptr;
-        }
-      }
-      else
-      {
-        return allocate(nsize);
-      }
+      mMisses++;
     }
+    return ptr2;
   }
 
 #endif
@@ -1,7 +1,7 @@
 #pragma once
 
 #ifndef BUILDOPT_LUA_USE_REALLOC
-#include <od/extras/MultiBufferPool.h>
+#include <od/extras/SlabAllocator.h>
 #endif
 
 #define INTERPRETER_RECORD_ALLOCATIONS 0
@@ -9,6 +9,7 @@
 #include <map>
 #endif
 
+#include <hal/timing.h>
 #include <memory>
 #include <string>
 #include <cstdio>
@@ -30,6 +31,14 @@ namespace od
     void init(void);
     
     void printMemoryStats();
+    void printCollectorStats();
+    void resetCollectorStats();
+
+    // Runs incremental garbage collection steps for at most budget ticks.
+    // A new cycle is only started once the heap has grown by
+    // mIdleCollectThreshold percent since the last one finished.
+    // Returns true if any work was done.
+    bool collectIdle(tick_t budget);
     void measureSpeed();
     void dumpStack(const char * label);
 
@@ -52,7 +61,7 @@ namespace od
     lua_State *L;
 
 #ifndef BUILDOPT_LUA_USE_REALLOC
-    MultiBufferPool<uint8_t> mAllocator;
+    SlabAllocator mAllocator;
     void *allocate(size_t size);
     void deallocate(void *ptr, size_t size);
     void *reallocate(void *ptr, size_t osize, size_t nsize);
@@ -76,14 +85,21 @@ namespace od
     int mTotalCount = 0;
     tick_t mTotalElapsed = 0;
 #endif
+    // Allocations that failed for lack of memory.
     int mMisses = 0;
 
-  private:
-#ifndef BUILDOPT_LUA_USE_REALLOC
-    void *getBuffer(size_t size);
-    void releaseBuffer(void *ptr);
-#endif
+    // Idle-time garbage collection.
+    int mIdleCollectThreshold = 150;
+    bool mIdleCycleActive = false;
+    int mIdleBaseKB = 0;
+    uint32_t mIdleSliceCount = 0;
+    uint32_t mIdleCycleCount = 0;
+    uint32_t mIdleOverBudgetCount = 0;
+    tick_t mIdlePauseTotal = 0;
+    tick_t mIdlePauseMax = 0;
+    tick_t mIdlePauseLast = 0;
 
+  private:
     bool genericCall(const char *func, const char *sig, ...);
   };
 
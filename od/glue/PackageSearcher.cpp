@@ -0,0 +1,68 @@
+#include <od/glue/PackageSearcher.h>
+#include <od/extras/PackageArchive.h>
+#include <algorithm>
+#include <string>
+#include <string.h>
+
+extern "C"
+{
+#include "lauxlib.h"
+}
+
+namespace od
+{
+
+  int luaPackageSearcher(lua_State *L)
+  {
+    const char *modname = luaL_checkstring(L, 1);
+    const char *dot = strchr(modname, '.');
+    std::string packageName = dot ? std::string(modname, dot - modname) : modname;
+
+    PackageArchive *archive = PackageArchive::find(packageName);
+    if (archive == 0)
+    {
+      lua_pushfstring(L, "no package archive mounted for '%s'",
+                      packageName.c_str());
+      return 1;
+    }
+
+    std::string path = dot ? dot + 1 : "";
+    std::replace(path.begin(), path.end(), '.', '/');
+    std::string candidates[2];
+    if (path.empty())
+    {
+      candidates[0] = "init.lua";
+    }
+    else
+    {
+      candidates[0] = path + ".lua";
+      candidates[1] = path + "/init.lua";
+    }
+
+    std::string chunk;
+    for (const std::string &name : candidates)
+    {
+      if (name.empty() || !archive->read(name, chunk))
+      {
+        continue;
+      }
+
+      // Same form as the paths shown by FS.makePathPretty().
+      std::string chunkname = "@pkg:" + packageName + "/" + name;
+      if (luaL_loadbuffer(L, chunk.data(), chunk.size(), chunkname.c_str()) !=
+          LUA_OK)
+      {
+        return luaL_error(L, "error loading module '%s' from '%s':\n\t%s",
+                          modname, chunkname.c_str() + 1,
+                          lua_tostring(L, -1));
+      }
+      lua_pushstring(L, chunkname.c_str() + 1);
+      return 2;
+    }
+
+    lua_pushfstring(L, "no file '%s' in the '%s' package archive",
+                    candidates[0].c_str(), packageName.c_str());
+    return 1;
+  }
+
+} // namespace od
@@ -0,0 +1,18 @@
+#pragma once
+
+extern "C"
+{
+#include "lua.h"
+}
+
+namespace od
+{
+
+  // A searcher for package.searchers that loads "name.a.b" from the archive
+  // mounted for package "name" (see PackageArchive::mount), trying a/b.lua
+  // and then a/b/init.lua.  A plain "name" loads init.lua.
+  //
+  // Registered with %native in app.cpp.swig as app.packageSearcher.
+  int luaPackageSearcher(lua_State *L);
+
+} // namespace od
@@ -6,6 +6,7 @@
  */
 
 #include <od/graphics/Graphic.h>
+#include <od/extras/MemoryTracker.h>
 #include <hal/constants.h>
 #include <algorithm>
 
@@ -42,11 +43,13 @@ namespace od
                                                                                                                                       &NullGraphic)
     {
         updateWorldCoordinates();
+        MemoryTracker::allocated(MEMORY_GRAPHICS, sizeof(Graphic));
     }
 
     Graphic::~Graphic()
     {
         clear();
+        MemoryTracker::freed(MEMORY_GRAPHICS, sizeof(Graphic));
     }
 
     void Graphic::clear()
@@ -2,7 +2,6 @@
 #include <od/extras/Utils.h>
 #include <hal/card.h>
 #include <hal/fileops.h>
-#include <hal/dir.h>
 //#define BUILDOPT_VERBOSE
 //#define BUILDOPT_DEBUG_LEVEL 10
 #include <hal/log.h>
@@ -227,52 +226,36 @@ namespace od
 
   bool FileBrowser::buildFileList(const std::string &path)
   {
-    std::string pname, fname;
+    std::string pname;
     CheckState checkState;
-    char *tmp;
-    uint32_t attributes;
-    dir_t dir;
 
     mListBox.clear();
 
-    dir = Dir_open(path.c_str());
-    if (dir == 0)
+    // Always read the directory being shown, the index keeps the details.
+    if (!FileIndex::list(path, mEntries))
       return false;
 
-    while (Dir_read(dir, &tmp, &attributes))
+    for (const FileIndexEntry &entry : mEntries)
     {
-      if (attributes & (FILEOPS_HID | FILEOPS_SYS))
+      if (entry.isDirectory())
       {
-        // ignore hidden and system files
-        continue;
-      }
-      else if (tmp[0] == '.')
-      {
-        // ignore dot files
-        continue;
-      }
-      fname = tmp;
-      if (attributes & FILEOPS_DIR)
-      {
-        std::ostringstream ss;
-        ss << '[' << fname << ']';
-        pname = ss.str();
-        checkState = getDirectoryCheckState(path, fname);
-        mListBox.addItem(pname, fname, checkState);
+        pname.clear();
+        pname.push_back('[');
+        pname.append(entry.name);
+        pname.push_back(']');
+        checkState = getDirectoryCheckState(path, entry.name);
+        mListBox.addItem(pname, entry.name, checkState);
       }
       else if (!mShowOnlyFolders)
       {
-        if (glob(fname.c_str(), mPatterns))
+        if (glob(entry.name, mPatterns))
         {
-          pname = fname;
-          checkState = getFileCheckState(path, fname);
-          mListBox.addItem(pname, fname, checkState);
+          checkState = getFileCheckState(path, entry.name);
+          mListBox.addItem(entry.name, entry.name, checkState);
         }
       }
     }
 
-    Dir_close(dir);
-
     mListBox.sortAscending();
     return true;
   }
@@ -351,6 +334,7 @@ namespace od
     else if (isSoundFile())
     {
       bool playing = mpFileSource && mpFileSource->playing() && !mpFileSource->isEOF();
+      int overviewBottom = mWorldBottom + 25;
       if (playing || mStickyPlay)
       {
         fb.fill(WHITE, b6 - 12, mWorldBottom + 2, b6 - 4,
@@ -364,6 +348,7 @@ namespace od
         updatePlayPosition();
         fb.text(WHITE, x + (w - mPlayPositionWidth) / 2, mWorldBottom + 27,
                 mPlayPosition.c_str(), ALIGN_BOTTOM);
+        overviewBottom += 10;
       }
       else
       {
@@ -378,6 +363,18 @@ namespace od
         int w = BUTTON6_CENTER + 5 - (BUTTON5_CENTER - 5);
         fb.text(WHITE, x + (w - mSoundFileInfoWidth) / 2, mWorldBottom + 16,
                 mSoundFileInfo.c_str(), ALIGN_BOTTOM);
+
+        if (!mHaveOverview && mSampleCount > 0)
+        {
+          // Computed in the background after the selection changed.
+          mHaveOverview =
+              FileIndex::getOverview(getSelectedFullPath(), mOverview, false);
+        }
+        if (mHaveOverview)
+        {
+          drawOverview(fb, b5 - 5, overviewBottom, b6 + 5,
+                       overviewBottom + 12);
+        }
       }
     }
 #if 0
@@ -414,6 +411,45 @@ namespace od
     }
   }
 
+  void FileBrowser::drawOverview(FrameBuffer &fb, int left, int bottom,
+                                 int right, int top)
+  {
+    fb.clear(left, bottom, right, top);
+    fb.drawTab(GRAY7, 3, left, bottom, right, top);
+
+    int x0 = left + 2;
+    int width = right - 2 - x0;
+    int mid = (bottom + top) / 2;
+    int n = (int)mOverview.size();
+    for (int i = 0; i < width; i++)
+    {
+      int h = mOverview[i * n / width] * 4 / 255;
+      fb.vline(GRAY10, x0 + i, mid - h, mid + h);
+    }
+
+    fb.vline(WHITE, x0 + (int)(mPreviewStart * (width - 1)), bottom + 1,
+             top - 1, 2);
+
+    if (mpFileSource && mpFileSource->playing() &&
+        mpFileSource->filename() == getSelectedFullPath() &&
+        mpFileSource->getDurationInSamples() > 0)
+    {
+      float position = (float)mpFileSource->getPositionInSamples() /
+                       mpFileSource->getDurationInSamples();
+      fb.vline(WHITE, x0 + (int)(position * (width - 1)), bottom + 1, top - 1);
+    }
+  }
+
+  void FileBrowser::setPreviewStart(float fraction)
+  {
+    mPreviewStart = MAX(0.0f, MIN(1.0f, fraction));
+  }
+
+  uint32_t FileBrowser::getPreviewStartInSamples()
+  {
+    return (uint32_t)(mPreviewStart * mSampleCount);
+  }
+
   void FileBrowser::updatePlayPosition()
   {
     uint32_t curPosition = mpFileSource->getPositionInSamples();
@@ -433,14 +469,24 @@ namespace od
 
   void FileBrowser::onSelectionChanged()
   {
+    FileIndexEntry entry;
+    mHaveOverview = false;
+    mSampleCount = 0;
+    mPreviewStart = 0.0f;
     if (isSoundFile())
     {
       mHaveSoundFileInfo = true;
-      if (mWavFileReader.open(getSelectedFullPath()))
+      // Cached by the index, so only read once per file.
+      if (FileIndex::getInfo(getSelectedFullPath(), entry) &&
+          entry.channelCount > 0)
       {
+        mSampleCount = entry.sampleCount;
+        mHaveOverview =
+            FileIndex::getOverview(getSelectedFullPath(), mOverview);
+
         char tmp[64];
-        float totalSecs = mWavFileReader.getTotalSeconds();
-        int channelCount = (int)mWavFileReader.getChannelCount();
+        float totalSecs = entry.getTotalSeconds();
+        int channelCount = entry.channelCount;
         if (totalSecs < 0.001f)
         {
           snprintf(tmp, sizeof(tmp), "%dch <1ms", channelCount);
@@ -475,7 +521,6 @@ namespace od
 
         mSoundFileInfo = tmp;
         getTextSize(tmp, &mSoundFileInfoWidth, &mSoundFileInfoHeight, 10);
-        mWavFileReader.close();
       }
       else
       {
@@ -490,12 +535,22 @@ namespace od
     }
   }
 
+  static inline std::string joinPath(const std::string &path,
+                                     const std::string &name)
+  {
+    std::string result;
+    result.reserve(path.size() + name.size() + 1);
+    result.append(path);
+    result.push_back('/');
+    result.append(name);
+    return result;
+  }
+
   CheckState FileBrowser::getFileCheckState(const std::string &path,
                                             const std::string &filename)
   {
-    std::ostringstream oss;
-    oss << path << '/' << filename;
-    if (mCheckedFiles.count(oss.str()) > 0)
+    if (mCheckedFiles.size() > 0 &&
+        mCheckedFiles.count(joinPath(path, filename)) > 0)
     {
       return checkYes;
     }
@@ -506,10 +561,13 @@ namespace od
   CheckState FileBrowser::getDirectoryCheckState(const std::string &path,
                                                  const std::string &filename)
   {
-    std::ostringstream oss;
-    oss << path << '/' << filename;
-    logDebug(1, "%s: %d", oss.str().c_str(), mCheckedPerDirectory[oss.str()]);
-    if (mCheckedPerDirectory[oss.str()] > 0)
+    if (mCheckedPerDirectory.size() == 0)
+    {
+      return checkNo;
+    }
+
+    auto i = mCheckedPerDirectory.find(joinPath(path, filename));
+    if (i != mCheckedPerDirectory.end() && i->second > 0)
     {
       return checkPartial;
     }
@@ -550,99 +608,55 @@ namespace od
 
   int FileBrowser::checkDirectory(const std::string &path)
   {
-    char *tmp;
-    uint32_t attributes;
-    std::string fullpath, fname;
-    dir_t dir;
+    std::vector<FileIndexEntry> entries;
     int checked = 0;
 
-    dir = Dir_open(path.c_str());
-    if (dir == 0)
+    // Read the card, since the user expects to get what is there now.
+    if (!FileIndex::list(path, entries))
       return 0;
 
-    while (Dir_read(dir, &tmp, &attributes))
+    for (const FileIndexEntry &entry : entries)
     {
-      if (attributes & (FILEOPS_HID | FILEOPS_SYS))
-      {
-        // ignore hidden and system files
-        continue;
-      }
-      else if (tmp[0] == '.')
-      {
-        // ignore dot files
-        continue;
-      }
-
-      fname = tmp;
-      if (attributes & FILEOPS_DIR)
+      if (entry.isDirectory())
       {
-        std::ostringstream ss;
-        ss << path << '/' << fname;
-        checked += checkDirectory(ss.str());
+        checked += checkDirectory(joinPath(path, entry.name));
       }
-      else if (glob(fname.c_str(), mPatterns))
+      else if (glob(entry.name, mPatterns))
       {
-        std::ostringstream ss;
-        ss << path << '/' << fname;
-        fullpath = ss.str();
-        if (mCheckedFiles.count(fullpath) == 0)
+        if (mCheckedFiles.emplace(joinPath(path, entry.name)).second)
         {
-          mCheckedFiles.emplace(fullpath);
           checked++;
         }
       }
     }
 
-    Dir_close(dir);
     mCheckedPerDirectory[path] += checked;
     return checked;
   }
 
   int FileBrowser::uncheckDirectory(const std::string &path)
   {
-    char *tmp;
-    uint32_t attributes;
-    std::string fullpath, fname;
-    dir_t dir;
+    std::vector<FileIndexEntry> entries;
     int unchecked = 0;
 
-    dir = Dir_open(path.c_str());
-    if (dir == 0)
+    if (!FileIndex::list(path, entries))
       return 0;
 
-    while (Dir_read(dir, &tmp, &attributes))
+    for (const FileIndexEntry &entry : entries)
     {
-      if (attributes & (FILEOPS_HID | FILEOPS_SYS))
-      {
-        // ignore hidden and system files
-        continue;
-      }
-      else if (tmp[0] == '.')
-      {
-        // ignore dot files
-        continue;
-      }
-
-      fname = tmp;
-      if (attributes & FILEOPS_DIR)
+      if (entry.isDirectory())
       {
-        std::ostringstream ss;
-        ss << path << '/' << fname;
-        unchecked += uncheckDirectory(ss.str());
+        unchecked += uncheckDirectory(joinPath(path, entry.name));
       }
-      else if (glob(fname.c_str(), mPatterns))
+      else if (glob(entry.name, mPatterns))
       {
-        std::ostringstream ss;
-        ss << path << '/' << fname;
-        fullpath = ss.str();
-        if (mCheckedFiles.erase(fullpath) > 0)
+        if (mCheckedFiles.erase(joinPath(path, entry.name)) > 0)
         {
           unchecked++;
         }
       }
     }
 
-    Dir_close(dir);
     mCheckedPerDirectory[path] -= unchecked;
     return unchecked;
   }
@@ -2,7 +2,7 @@
 
 #include <od/graphics/lists/ListBox.h>
 #include <od/graphics/meters/VerticalMeter.h>
-#include <od/audio/WavFileReader.h>
+#include <od/extras/FileIndex.h>
 #include <od/objects/file/FileSource.h>
 #include <set>
 #include <vector>
@@ -128,6 +128,15 @@ namespace od
 
     void setFileSource(FileSource *source, bool sticky = false);
 
+    // Where a preview of the selected sound file starts (0 to 1).  Shown on
+    // its overview and reset when the selection changes.
+    void setPreviewStart(float fraction);
+    float getPreviewStart()
+    {
+      return mPreviewStart;
+    }
+    uint32_t getPreviewStartInSamples();
+
   protected:
     ListBox mListBox;
     std::string mRootPath;
@@ -141,6 +150,7 @@ namespace od
     std::map<std::string, int> mCheckedPerDirectory;
     bool mEjected = true;
     bool mShowOnlyFolders = false;
+    std::vector<FileIndexEntry> mEntries;
 
     bool buildFileList(const std::string &path);
     void updatePath();
@@ -151,7 +161,6 @@ namespace od
     int checkDirectory(const std::string& path);                                 
     int uncheckDirectory(const std::string& path);
 
-    WavFileReader mWavFileReader;
     VerticalMeter mLeftMeter;
     VerticalMeter mRightMeter;
     bool mHaveSoundFileInfo = false;
@@ -164,8 +173,14 @@ namespace od
     int mPlayPositionWidth = 0;
     int mPlayPositionHeight = 0;
     uint32_t mLastPlayPosition = 0;
+    std::vector<uint8_t> mOverview;
+    bool mHaveOverview = false;
+    uint32_t mSampleCount = 0;
+    float mPreviewStart = 0.0f;
     void onSelectionChanged();
     void updatePlayPosition();
+    void drawOverview(FrameBuffer &fb, int left, int bottom, int right,
+                      int top);
   };
 
 } /* namespace od */
@@ -947,13 +947,19 @@ namespace od
           i++;
         }
 
+        // The starts were edited in place, so the search index has to be
+        // rebuilt even when nothing fell off the end.
+        pSlices->lock();
         if (toDelete > 0)
         {
-          pSlices->lock();
           pSlices->removeRangeOfIterators(pSlices->end() - toDelete,
                                           pSlices->end());
-          pSlices->unlock();
         }
+        else
+        {
+          pSlices->sort();
+        }
+        pSlices->unlock();
       }
       else if (shift < 0)
       {
@@ -979,13 +985,17 @@ namespace od
           i++;
         }
 
+        pSlices->lock();
         if (toDelete > 0)
         {
-          pSlices->lock();
           pSlices->removeRangeOfIterators(pSlices->begin(),
                                           pSlices->begin() + toDelete);
-          pSlices->unlock();
         }
+        else
+        {
+          pSlices->sort();
+        }
+        pSlices->unlock();
       }
     }
   }
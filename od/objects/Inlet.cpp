@@ -25,6 +25,17 @@ namespace od
 	Inlet::~Inlet()
 	{
 		disconnect();
+
+		// Channels owned by an object are deleted by it.
+		for (Inlet *channel : mChannels)
+		{
+			channel->mpParent = 0;
+			if (channel->owner() == 0 && channel->refCount() == 0)
+			{
+				delete channel;
+			}
+		}
+		mChannels.clear();
 	}
 
 	float *Inlet::buffer()
@@ -39,6 +50,81 @@ namespace od
 		}
 	}
 
+	float *Inlet::buffer(int channel)
+	{
+		if (mInwardConnection)
+		{
+			return mInwardConnection->buffer(channel);
+		}
+		else if (channel >= 0 && channel < (int)mChannels.size())
+		{
+			return mChannels[channel]->buffer();
+		}
+		else
+		{
+			return ZeroOutput.buffer();
+		}
+	}
+
+	Inlet *Inlet::addChannel(const std::string &name)
+	{
+		Inlet *channel = new Inlet(name);
+		channel->mpParent = this;
+		channel->mChannel = (int)mChannels.size();
+		mChannels.push_back(channel);
+		return channel;
+	}
+
+	Inlet *Inlet::getChannel(int channel)
+	{
+		if (mChannels.size() == 0)
+		{
+			return channel == 0 ? this : 0;
+		}
+		if (channel < 0 || channel >= (int)mChannels.size())
+		{
+			return 0;
+		}
+		return mChannels[channel];
+	}
+
+	void Inlet::connectChannels(Outlet *const *outlets, int count)
+	{
+		int n = getChannelCount();
+		Outlet *whole = 0;
+		if (n > 1 && count >= n && outlets[0] && outlets[0]->mpParent &&
+			outlets[0]->mpParent->getChannelCount() == n)
+		{
+			whole = outlets[0]->mpParent;
+			for (int i = 0; i < n; i++)
+			{
+				if (outlets[i] != whole->mChannels[i])
+				{
+					whole = 0;
+					break;
+				}
+			}
+		}
+
+		if (whole)
+		{
+			if (mInwardConnection != whole)
+			{
+				connect(whole);
+			}
+			return;
+		}
+
+		disconnect();
+		for (int i = 0; i < n && i < count; i++)
+		{
+			if (outlets[i])
+			{
+				getChannel(i)->connect(outlets[i]);
+			}
+		}
+	}
+
 	void Inlet::connect(Outlet *outlet)
 	{
 		disconnect();
@@ -48,6 +134,19 @@ namespace od
 	}
 
 	void Inlet::disconnect()
+	{
+		drop();
+		if (mpParent)
+		{
+			mpParent->drop();
+		}
+		for (Inlet *channel : mChannels)
+		{
+			channel->drop();
+		}
+	}
+
+	void Inlet::drop()
 	{
 		if (mInwardConnection)
 		{
@@ -59,7 +158,31 @@ namespace od
 
 	bool Inlet::isConnected()
 	{
-		return mInwardConnection != 0;
+		if (mInwardConnection)
+		{
+			return true;
+		}
+		for (Inlet *channel : mChannels)
+		{
+			if (channel->mInwardConnection)
+			{
+				return true;
+			}
+		}
+		return false;
+	}
+
+	int Inlet::getEvents(const uint16_t *&offsets)
+	{
+		if (mInwardConnection)
+		{
+			return mInwardConnection->getEvents(offsets);
+		}
+		else
+		{
+			offsets = 0;
+			return 0;
+		}
 	}
 
 	bool Inlet::isConstant()
@@ -68,10 +191,14 @@ namespace od
 		{
 			return mInwardConnection->isConstant();
 		}
-		else
+		for (Inlet *channel : mChannels)
 		{
-			return true;
+			if (!channel->isConstant())
+			{
+				return false;
+			}
 		}
+		return true;
 	}
 
 } /* namespace od */
@@ -25,11 +25,40 @@ namespace od
 
         float *buffer();
         void connect(Outlet *outlet);
+        // Also drops the connection to the whole inlet (for a channel) or
+        // those to the channels (for a multichannel inlet).
         void disconnect();
         bool isConnected();
         bool isConstant();
+        // See Outlet::getEvents().
+        int getEvents(const uint16_t *&offsets);
+
+        // Multichannel inlets either take a multichannel outlet as a whole,
+        // reading its block directly, or have each of their channels (inlets
+        // of their own) connected separately.  Add the channels before the
+        // inlet is added to its object, which then owns them.
+        Inlet *addChannel(const std::string &name);
+        int getChannelCount()
+        {
+            return mChannels.size() > 0 ? (int)mChannels.size() : 1;
+        }
+        // This inlet itself for channel 0 of a mono inlet, 0 when out of range.
+        Inlet *getChannel(int channel);
+        // A mono outlet connected to the whole inlet feeds every channel.
+        float *buffer(int channel);
+        // Connect each channel to the outlet with the same index (count of
+        // them, null for none).  When they are the channels of one
+        // multichannel outlet, in order, the whole inlet is connected instead.
+        void connectChannels(Outlet *const *outlets, int count);
 
         Outlet *mInwardConnection = 0;
+        std::vector<Inlet *> mChannels;
+        // Only set on the channels of a multichannel inlet.
+        Inlet *mpParent = 0;
+        int mChannel = 0;
+
+    private:
+        void drop();
 #endif
     };
 
@@ -1,4 +1,5 @@
 #include <od/objects/Object.h>
+#include <algorithm>
 
 namespace od
 {
@@ -61,6 +62,8 @@ namespace od
     // free heap parameters
     for (Parameter *param : mParameters)
     {
+      // Parameters can outlive this object (e.g. when tied or morphed).
+      param->setOwner(0);
       param->untie();
       if (param->mOnHeap)
       {
@@ -207,12 +210,30 @@ namespace od
 
   void Object::addOutput(Outlet &outlet)
   {
+    // Channels of a multichannel port that were not added on their own (with
+    // addOutputFromHeap) go just before it.  Objects that replace separate
+    // ports add the channels in the old order instead, and the whole port
+    // after everything else, so that every old port keeps its index.
+    for (Outlet *channel : outlet.mChannels)
+    {
+      if (std::find(mOutputs.begin(), mOutputs.end(), channel) == mOutputs.end())
+      {
+        addOutputFromHeap(channel);
+      }
+    }
     mOutputs.push_back(&outlet);
     own(outlet); // and don't let go
   }
 
   void Object::addInput(Inlet &inlet)
   {
+    for (Inlet *channel : inlet.mChannels)
+    {
+      if (std::find(mInputs.begin(), mInputs.end(), channel) == mInputs.end())
+      {
+        addInputFromHeap(channel);
+      }
+    }
     mInputs.push_back(&inlet);
     own(inlet); // and don't let go
   }
@@ -234,14 +255,19 @@ namespace od
   void Object::addParameter(Parameter &parameter)
   {
     mParameters.push_back(&parameter);
+    // updateParameters() must not allocate in the audio thread.
+    mActiveParameters.reserve(mParameters.size());
     own(parameter); // and don't let go
+    parameter.setOwner(this);
   }
 
   void Object::addParameterFromHeap(Parameter *parameter)
   {
     mParameters.push_back(parameter);
+    mActiveParameters.reserve(mParameters.size());
     own(parameter);
     parameter->mOnHeap = true;
+    parameter->setOwner(this);
   }
 
   void Object::addOption(Option &option)
@@ -388,10 +414,35 @@ namespace od
 
   void Object::updateParameters()
   {
-    for (Parameter *param : mParameters)
+    if (mParametersChanged)
+    {
+      // Clear the flag first so that changes made during the scan are
+      // picked up by the next frame.
+      mParametersChanged = false;
+      for (Parameter *param : mParameters)
+      {
+        if (!param->mIsActive && param->needsUpdate())
+        {
+          param->mIsActive = true;
+          mActiveParameters.push_back(param);
+        }
+      }
+    }
+
+    int n = 0;
+    for (Parameter *param : mActiveParameters)
     {
       param->update();
+      if (param->needsUpdate())
+      {
+        mActiveParameters[n++] = param;
+      }
+      else
+      {
+        param->mIsActive = false;
+      }
     }
+    mActiveParameters.resize(n);
   }
 
   void Object::setScheduledFlag(bool value)
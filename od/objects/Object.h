@@ -28,6 +28,8 @@ namespace od
     virtual void process();
     virtual void compile();
 
+    // Only touches parameters that are ramping, tied to a buffer user or
+    // have been set since the last frame.
     void updateParameters();
     void setScheduledFlag(bool value);
 #endif
@@ -75,6 +77,10 @@ namespace od
     std::vector<Outlet *> mOutputs;
     std::vector<Inlet *> mInputs;
     std::vector<Parameter *> mParameters;
+    // Owned by the audio thread.
+    std::vector<Parameter *> mActiveParameters;
+    // Set by any thread when a parameter might need updating.
+    volatile bool mParametersChanged = true;
     std::vector<Option *> mOptions;
     std::vector<StateMachine *> mStateMachines;
 
@@ -107,6 +113,7 @@ namespace od
     friend Task;
     friend Unit;
     friend GraphCompiler;
+    friend Parameter;
   };
 
   bool connect(Object &fromObject, const std::string &outletName,
@@ -2,6 +2,7 @@
 #include <od/objects/Inlet.h>
 #include <od/AudioThread.h>
 #include <od/config.h>
+#include <hal/log.h>
 #include <algorithm>
 #include <string.h>
 
@@ -53,9 +54,44 @@ namespace od
 
     if (mBuffer)
     {
-      AudioThread::releaseFrame(mBuffer);
+      AudioThread::releaseFrames(mBuffer, mBufferFrames, MEMORY_OUTLETS);
       mBuffer = 0;
     }
+
+    // Channels owned by an object are deleted by it.  The others go with
+    // this outlet, or when the last inlet lets go of them.
+    for (Outlet *channel : mChannels)
+    {
+      channel->mpParent = 0;
+      if (channel->owner() == 0 && channel->refCount() == 0)
+      {
+        delete channel;
+      }
+    }
+    mChannels.clear();
+  }
+
+  Outlet *Outlet::addChannel(const std::string &name)
+  {
+    logAssert(mBuffer == 0 && (int)mChannels.size() < MaxChannels);
+    Outlet *channel = new Outlet(name);
+    channel->mpParent = this;
+    channel->mChannel = (int)mChannels.size();
+    mChannels.push_back(channel);
+    return channel;
+  }
+
+  Outlet *Outlet::getChannel(int channel)
+  {
+    if (mChannels.size() == 0)
+    {
+      return channel == 0 ? this : 0;
+    }
+    if (channel < 0 || channel >= (int)mChannels.size())
+    {
+      return 0;
+    }
+    return mChannels[channel];
   }
 
   float testBuffer[1024];
@@ -66,17 +102,36 @@ namespace od
     {
       return ZeroOutput.buffer();
     }
+    if (mpParent)
+    {
+      return mpParent->buffer(mChannel);
+    }
     if (mBuffer == 0)
     {
-      mBuffer = AudioThread::getFrame();
+      mBufferFrames = getChannelCount();
+      mBuffer = AudioThread::getFrames(mBufferFrames, MEMORY_OUTLETS);
       if (mBuffer)
       {
-        memset(mBuffer, 0, FRAMELENGTH * sizeof(float));
+        memset(mBuffer, 0, mBufferFrames * FRAMELENGTH * sizeof(float));
       }
     }
     return mBuffer;
   }
 
+  float *__restrict__ Outlet::buffer(int channel)
+  {
+    float *frames = buffer();
+    if (channel == 0 || mChannels.size() == 0 || mIsMuted || frames == 0)
+    {
+      return frames;
+    }
+    if (channel > 0 && channel < (int)mChannels.size())
+    {
+      return frames + channel * FRAMELENGTH;
+    }
+    return ZeroOutput.buffer();
+  }
+
   void Outlet::addInlet(Inlet *inlet)
   {
     auto i = std::find(mOutwardConnections.begin(), mOutwardConnections.end(),
@@ -101,6 +156,16 @@ namespace od
   void Outlet::disconnect()
   {
     std::vector<Inlet *> copy = mOutwardConnections;
+    if (mpParent)
+    {
+      copy.insert(copy.end(), mpParent->mOutwardConnections.begin(),
+                  mpParent->mOutwardConnections.end());
+    }
+    for (Outlet *channel : mChannels)
+    {
+      copy.insert(copy.end(), channel->mOutwardConnections.begin(),
+                  channel->mOutwardConnections.end());
+    }
 
     for (Inlet *inlet : copy)
     {
@@ -118,6 +183,32 @@ namespace od
     return mIsConstant;
   }
 
+  void Outlet::beginEvents()
+  {
+    mEventCount = 0;
+    mEventFrame = AudioThread::getFrameCount();
+  }
+
+  void Outlet::clearEvents()
+  {
+    mEventFrame = 0;
+  }
+
+  int Outlet::getEvents(const uint16_t *&offsets)
+  {
+    offsets = mEvents;
+    if (mIsMuted)
+    {
+      return 0;
+    }
+    if (mEventFrame == 0 || mEventFrame != AudioThread::getFrameCount() ||
+        mEventCount > MaxEvents)
+    {
+      return -1;
+    }
+    return mEventCount;
+  }
+
   void Outlet::mute()
   {
     mIsMuted = true;
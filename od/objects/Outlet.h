@@ -19,10 +19,28 @@ namespace od
 
     float *__restrict__ buffer();
 
+    // Multichannel outlets keep all of their channels in one block of frames,
+    // one frame after the other.  Each channel is an outlet of its own as
+    // well, so that it can be connected by name like a mono outlet.  Add the
+    // channels before the outlet is added to its object, which then owns
+    // them.
+    static const int MaxChannels = 2;
+    Outlet *addChannel(const std::string &name);
+    int getChannelCount()
+    {
+      return mChannels.size() > 0 ? (int)mChannels.size() : 1;
+    }
+    // This outlet itself for channel 0 of a mono outlet, 0 when out of range.
+    Outlet *getChannel(int channel);
+    // Mono outlets return the same buffer for every channel, multichannel
+    // outlets return silence for channels they do not have.
+    float *__restrict__ buffer(int channel);
+
     void addInlet(Inlet *inlet);
     void removeInlet(Inlet *inlet);
 
-    // disconnect all inlets
+    // disconnect all inlets (including those connected to the channels, or
+    // for a channel, to the whole outlet)
     void disconnect();
 
     bool isConnected();
@@ -32,10 +50,40 @@ namespace od
 
     static void initializeGlobalOutlets();
 
+    // Event list: the offsets of the samples in this frame's buffer that are
+    // above zero (every other sample is zero or below).  Trigger sources can
+    // publish it after writing the buffer so that trigger inputs downstream
+    // do not have to scan for their triggers.  A list that was not begun in
+    // the current frame, or that ran out of room, is ignored.
+    static const int MaxEvents = 16;
+    void beginEvents();
+    void addEvent(int offset)
+    {
+      if (mEventCount < MaxEvents)
+      {
+        mEvents[mEventCount] = offset;
+      }
+      mEventCount++;
+    }
+    void clearEvents();
+    // Number of events in this frame, or -1 when there is no list.
+    int getEvents(const uint16_t *&offsets);
+
     std::vector<Inlet *> mOutwardConnections;
+    std::vector<Outlet *> mChannels;
+    // Only set on the channels of a multichannel outlet.
+    Outlet *mpParent = 0;
+    int mChannel = 0;
     float *mBuffer = 0;
     bool mIsConstant = false;
     bool mIsMuted = false;
+
+  private:
+    // Number of frames in mBuffer.
+    int mBufferFrames = 0;
+    uint16_t mEvents[MaxEvents];
+    int mEventCount = 0;
+    uint32_t mEventFrame = 0;
 #endif
   };
 
@@ -1,6 +1,12 @@
 #include <od/objects/Parameter.h>
+#include <od/objects/Object.h>
 #include <od/extras/Conversions.h>
 #include <od/extras/Utils.h>
+#include <od/extras/LookupTables.h>
+#include <od/AudioThread.h>
+#include <od/config.h>
+#include <hal/simd.h>
+#include <hal/ops.h>
 
 namespace od
 {
@@ -12,6 +18,11 @@ namespace od
     Parameter::~Parameter()
     {
         untie();
+        if (mBuffer)
+        {
+            AudioThread::releaseFrame(mBuffer);
+            mBuffer = 0;
+        }
     }
 
     void Parameter::tie(Followable &leader)
@@ -19,6 +30,7 @@ namespace od
         untie();
         mpLeader = &leader;
         mpLeader->attach();
+        notifyOwner();
     }
 
     void Parameter::untie()
@@ -27,6 +39,7 @@ namespace od
         {
             mpLeader->release();
             mpLeader = 0;
+            notifyOwner();
         }
     }
 
@@ -72,6 +85,7 @@ namespace od
             mCount = 50;
             mStep = diff * 0.02f;
         }
+        notifyOwner();
     }
 
     void Parameter::hardSet(float x)
@@ -84,6 +98,7 @@ namespace od
         {
             mTarget = mValue = x;
             mCount = 0;
+            notifyOwner();
         }
     }
 
@@ -166,6 +181,7 @@ namespace od
 
     void Parameter::forcedUpdate()
     {
+        mIsBufferStale = true;
         if (mpLeader == NULL)
         {
             if (mCount > 0)
@@ -182,6 +198,7 @@ namespace od
 
     void Parameter::update()
     {
+        mIsBufferStale = true;
         if (mpLeader == NULL)
         {
             if (mHeld)
@@ -235,4 +252,120 @@ namespace od
         mEnableDecibelMorph = true;
     }
 
+    void Parameter::enableLinearSmoothing()
+    {
+        mOnePoleCoefficient = 0.0f;
+    }
+
+    void Parameter::enableOnePoleSmoothing(float secs)
+    {
+        // Per-sample decay factor for a time constant of secs.
+        float samples = MAX(1.0f, secs * globalConfig.sampleRate);
+        mOnePoleCoefficient = expf(-1.0f / samples);
+    }
+
+    float *Parameter::buffer()
+    {
+        if (mBuffer == 0)
+        {
+            mBuffer = AudioThread::getFrame();
+            if (mBuffer == 0)
+            {
+                return 0;
+            }
+            mBufferValue = value();
+            mIsBufferStale = true;
+            notifyOwner();
+        }
+
+        if (mIsBufferStale)
+        {
+            fillBuffer();
+            mIsBufferStale = false;
+        }
+
+        return mBuffer;
+    }
+
+    bool Parameter::isBufferConstant()
+    {
+        return mIsBufferConstant;
+    }
+
+    bool Parameter::needsUpdate()
+    {
+        if (mBuffer)
+        {
+            // Tied buffers follow the leader every frame.
+            if (mpLeader || !mIsBufferConstant || mBufferValue != mValue)
+            {
+                return true;
+            }
+        }
+        if (mpLeader || mHeld)
+        {
+            return false;
+        }
+        return mCount > 0 || mValue != mTarget;
+    }
+
+    void Parameter::setOwner(Object *object)
+    {
+        mpOwner = object;
+        notifyOwner();
+    }
+
+    void Parameter::notifyOwner()
+    {
+        if (mpOwner)
+        {
+            mpOwner->mParametersChanged = true;
+        }
+    }
+
+    void Parameter::fillBuffer()
+    {
+        float x0 = mBufferValue;
+        float x1 = value();
+        float diff = x0 - x1;
+
+        if (fabs(diff) < 1e-10f)
+        {
+            simd_set(mBuffer, FRAMELENGTH, x1);
+            mBufferValue = x1;
+            mIsBufferConstant = true;
+            return;
+        }
+
+        float32x4_t target = vdupq_n_f32(x1);
+        if (mOnePoleCoefficient > 0.0f)
+        {
+            // x[i] = x1 + (x0 - x1) * a^(i+1)
+            float a = mOnePoleCoefficient;
+            float a2 = a * a;
+            float32x4_t power = {a, a2, a2 * a, a2 * a2};
+            float32x4_t step = vdupq_n_f32(a2 * a2);
+            float32x4_t d = vdupq_n_f32(diff);
+            for (int i = 0; i < FRAMELENGTH; i += 4)
+            {
+                vst1q_f32(mBuffer + i, vmlaq_f32(target, d, power));
+                power = vmulq_f32(power, step);
+            }
+        }
+        else
+        {
+            // Same ramp shape as objects that interpolate between frames.
+            const float *ramp = LookupTables::FrameOfLinearRamp.mValues.data();
+            float32x4_t d = vdupq_n_f32(diff);
+            for (int i = 0; i < FRAMELENGTH; i += 4)
+            {
+                float32x4_t w0 = vdupq_n_f32(1.0f) - vld1q_f32(ramp + i);
+                vst1q_f32(mBuffer + i, vmlaq_f32(target, d, w0));
+            }
+        }
+
+        mBufferValue = mBuffer[FRAMELENGTH - 1];
+        mIsBufferConstant = false;
+    }
+
 } /* namespace od */
@@ -9,6 +9,7 @@ namespace od
 {
 
     class ParamSetMorph;
+    class Object;
     class Parameter : public Followable
     {
     public:
@@ -46,18 +47,38 @@ namespace od
 
         void enableDecibelMorph();
 
+        // Shape of the per-sample buffer (see buffer() below).
+        void enableLinearSmoothing();
+        void enableOnePoleSmoothing(float secs);
+
 #ifndef SWIGLUA
         Parameter &operator=(Parameter &param);
         void update();
         void forcedUpdate();
         bool offTarget();
 
+        // Audio-rate access to the parameter.  Returns a frame of samples
+        // that glides from the last sample of the previous frame to value(),
+        // either linearly or with a one-pole lag.  The frame is allocated on
+        // first use and recomputed at most once per update().
+        float *buffer();
+        // True if the last buffer() holds the same value in every sample.
+        bool isBufferConstant();
+
+        // Would update() change anything?
+        bool needsUpdate();
+        void setOwner(Object *object);
+
         std::string mName;
 #endif
 
     protected:
         friend ParamSetMorph;
+        friend Object;
         Followable *mpLeader = 0;
+        Object *mpOwner = 0;
+        // Is this parameter in the owner's active list?  (audio thread only)
+        bool mIsActive = false;
 
         float mTarget;
         float mValue;
@@ -70,7 +91,16 @@ namespace od
         bool mIsSerializationEnabled = false;
         bool mEnableDecibelMorph = false;
 
+        float *mBuffer = 0;
+        float mBufferValue = 0.0f;
+        // Zero selects linear smoothing.
+        float mOnePoleCoefficient = 0.0f;
+        bool mIsBufferStale = true;
+        bool mIsBufferConstant = true;
+
         void rampTo(float x);
+        void fillBuffer();
+        void notifyOwner();
     };
 
 } // namespace od
@@ -13,31 +13,61 @@
 namespace od
 {
 
-    Repeater::Repeater()
+    Repeater::Repeater(int channelCount)
     {
         own(mInlet);
         own(mOutlet);
+        if (channelCount > 1)
+        {
+            for (int i = 0; i < channelCount; i++)
+            {
+                own(mInlet.addChannel(""));
+                own(mOutlet.addChannel(""));
+            }
+        }
     }
 
     Repeater::~Repeater()
     {
+        for (Inlet *channel : mInlet.mChannels)
+        {
+            channel->disconnect();
+            channel->mpParent = 0;
+            disown(channel);
+        }
+        mInlet.mChannels.clear();
+        for (Outlet *channel : mOutlet.mChannels)
+        {
+            channel->disconnect();
+            channel->mpParent = 0;
+            disown(channel);
+        }
+        mOutlet.mChannels.clear();
     }
 
     void Repeater::copyInputToOutput()
     {
-        float *in = mInlet.buffer();
-        float *out = mOutlet.buffer();
-        memcpy(out, in, sizeof(float) * FRAMELENGTH);
+        int n = mOutlet.getChannelCount();
+        for (int i = 0; i < n; i++)
+        {
+            float *in = mInlet.buffer(i);
+            float *out = mOutlet.buffer(i);
+            memcpy(out, in, sizeof(float) * FRAMELENGTH);
+        }
     }
 
     void Repeater::fade(float a, float w0)
     {
-        float *in = mInlet.buffer();
-        float *out = mOutlet.buffer();
         float *ramp = LookupTables::FrameOfLinearRamp.mValues.data();
-        for (int j = 0; j < FRAMELENGTH; j++)
+        int n = mOutlet.getChannelCount();
+        for (int i = 0; i < n; i++)
         {
-            out[j] = in[j] * (a * ramp[j] + w0);
+            float *in = mInlet.buffer(i);
+            float *out = mOutlet.buffer(i);
+            for (int j = 0; j < FRAMELENGTH; j++)
+            {
+                out[j] = in[j] * (a * ramp[j] + w0);
+            }
         }
     }
 
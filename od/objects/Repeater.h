@@ -18,7 +18,7 @@ namespace od
     class Repeater : public ReferenceCounted
     {
     public:
-        Repeater();
+        Repeater(int channelCount = 1);
         virtual ~Repeater();
 
         void copyInputToOutput();
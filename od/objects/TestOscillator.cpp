@@ -31,7 +31,7 @@ namespace od
     float *freq = mFundamental.buffer();
     float *feedback = mFeedback.buffer();
     float *phase = mPhase.buffer();
-    float32x4_t glog2 = vdupq_n_f32(FULLSCALE_IN_VOLTS * logf(2.0f));
+    float32x4_t vpo = vdupq_n_f32(FULLSCALE_IN_VOLTS);
     float32x4_t pi2 = vdupq_n_f32(2.0f * M_PI);
     float32x4_t one = vdupq_n_f32(1.0f);
     float32x4_t zero = vdupq_n_f32(0.0f);
@@ -49,7 +49,7 @@ namespace od
       float32x4_t q = vld1q_f32(octave + i);
       q = vminq_f32(one, q);
       q = vmaxq_f32(negOne, q);
-      q = dP * simd_exp(q * glog2);
+      q = dP * simd_exp2(q * vpo);
 
       // accumulate phase while handling sync
       float tmp[4];
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <od/objects/Inlet.h>
+#include <od/config.h>
+#include <hal/simd.h>
+
+namespace od
+{
+
+  // Visits the samples of an inlet's frame that are above zero, in order.
+  // The event list of the connected outlet is used when it has one,
+  // otherwise the buffer is searched four samples at a time.
+  class TriggerScanner
+  {
+  public:
+    TriggerScanner(Inlet &inlet)
+    {
+      mBuffer = inlet.buffer();
+      mCount = inlet.getEvents(mEvents);
+    }
+
+    // Is any sample above zero?
+    bool any()
+    {
+      if (mCount < 0)
+      {
+        return simd_any_positive(mBuffer, FRAMELENGTH);
+      }
+      return mCount > 0;
+    }
+
+    // Offset of the next sample above zero, or FRAMELENGTH.
+    int next()
+    {
+      if (mCount < 0)
+      {
+        if (mNext >= FRAMELENGTH)
+        {
+          return FRAMELENGTH;
+        }
+        int i = mNext + simd_first_positive(mBuffer + mNext, FRAMELENGTH - mNext);
+        mNext = i + 1;
+        return i;
+      }
+
+      if (mNext < mCount)
+      {
+        return mEvents[mNext++];
+      }
+      return FRAMELENGTH;
+    }
+
+  private:
+    float *mBuffer;
+    const uint16_t *mEvents;
+    int mCount;
+    int mNext = 0;
+  };
+
+} /* namespace od */
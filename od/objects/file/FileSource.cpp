@@ -109,6 +109,25 @@ namespace od
     mHavePendingSeek = true;
   }
 
+  bool FileSource::prefetch(uint32_t position)
+  {
+    if (!mReader.mIsOpen)
+    {
+      return false;
+    }
+
+    mReadJob.wait();
+    if (position >= mReader.getSampleCount())
+    {
+      position = 0;
+    }
+    mRequestedPosition = position;
+    mHavePendingSeek = true;
+    mFifo.popAll();
+    readWork();
+    return !mError;
+  }
+
   float FileSource::getMaxBufferDepthInSeconds()
   {
     return mFifo.capacity() * mSamplePeriod;
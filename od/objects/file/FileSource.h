@@ -71,6 +71,9 @@ namespace od
     }
 
     void setPositionInSamples(uint32_t position);
+    // Seek and read the first chunk now, so that playback from any position
+    // starts on the next frame.  Call after open() and before processing.
+    bool prefetch(uint32_t position);
     uint32_t getPositionInSamples()
     {
       if (mReader.mIsOpen)
@@ -176,6 +179,10 @@ namespace od
       {
         mpSource->readWork();
       }
+      virtual const char *getTraceName()
+      {
+        return "FileSource::read";
+      }
     };
 
     ReadJob mReadJob;
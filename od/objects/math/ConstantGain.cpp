@@ -1,5 +1,4 @@
 #include <od/objects/math/ConstantGain.h>
-#include <od/extras/LookupTables.h>
 #include <od/config.h>
 #include <math.h>
 
@@ -31,7 +30,7 @@ namespace od
 	{
 		float *in = mInput.buffer();
 		float *out = mOutput.buffer();
-		float gain0 = mPreviousGain;
+		float *gain = mGain.buffer();
 		float gain1 = mGain.value();
 
 		if (fabs(gain1) < mClamp)
@@ -41,7 +40,7 @@ namespace od
 				out[i] = 0.0f;
 			}
 		}
-		else if (fabs(gain1 - gain0) < 1e-10f)
+		else if (mGain.isBufferConstant())
 		{
 			// 600 ticks
 			for (int i = 0; i < FRAMELENGTH; i++)
@@ -51,18 +50,12 @@ namespace od
 		}
 		else
 		{
-			// 1300 ticks
-			float *ramp = LookupTables::FrameOfLinearRamp.mValues.data();
-
+			// Per-sample gain, so larger frames do not cause zipper noise.
 			for (int i = 0; i < FRAMELENGTH; i++)
 			{
-				float w1 = ramp[i];
-				float w0 = 1.0f - w1;
-				out[i] = in[i] * (w0 * gain0 + w1 * gain1);
+				out[i] = in[i] * gain[i];
 			}
 		}
-
-		mPreviousGain = gain1;
 	}
 
 } /* namespace od */
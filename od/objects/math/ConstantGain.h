@@ -24,7 +24,6 @@ namespace od
 
   private:
     float mClamp = std::numeric_limits<float>::min();
-    float mPreviousGain = 0.0f;
   };
 
 } /* namespace od */
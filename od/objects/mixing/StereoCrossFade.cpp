@@ -7,13 +7,21 @@ namespace od
 
   StereoCrossFade::StereoCrossFade()
   {
-    addInput(mLeftInputA);
-    addInput(mLeftInputB);
-    addInput(mRightInputA);
-    addInput(mRightInputB);
+    mInputA.addChannel("Left A");
+    mInputA.addChannel("Right A");
+    mInputB.addChannel("Left B");
+    mInputB.addChannel("Right B");
+    mOutput.addChannel("Left Out");
+    mOutput.addChannel("Right Out");
+    // Keep the indices of the separate ports the channels replaced.
+    addInputFromHeap(mInputA.getChannel(0));
+    addInputFromHeap(mInputB.getChannel(0));
+    addInputFromHeap(mInputA.getChannel(1));
+    addInputFromHeap(mInputB.getChannel(1));
     addInput(mFade);
-    addOutput(mLeftOutput);
-    addOutput(mRightOutput);
+    addOutput(mOutput);
+    addInput(mInputA);
+    addInput(mInputB);
   }
 
   StereoCrossFade::~StereoCrossFade()
@@ -22,13 +30,13 @@ namespace od
 
   void StereoCrossFade::process()
   {
-    float *leftA = mLeftInputA.buffer();
-    float *leftB = mLeftInputB.buffer();
-    float *rightA = mRightInputA.buffer();
-    float *rightB = mRightInputB.buffer();
+    float *leftA = mInputA.buffer(0);
+    float *leftB = mInputB.buffer(0);
+    float *rightA = mInputA.buffer(1);
+    float *rightB = mInputB.buffer(1);
     float *fade = mFade.buffer();
-    float *leftOut = mLeftOutput.buffer();
-    float *rightOut = mRightOutput.buffer();
+    float *leftOut = mOutput.buffer(0);
+    float *rightOut = mOutput.buffer(1);
     float *end = fade + globalConfig.frameLength;
 
     float32x4_t zero = vdupq_n_f32(0.0f);
@@ -14,13 +14,13 @@ namespace od
 #ifndef SWIGLUA
     virtual void process();
 
-    Inlet mLeftInputA{"Left A"};
-    Inlet mLeftInputB{"Left B"};
-    Inlet mRightInputA{"Right A"};
-    Inlet mRightInputB{"Right B"};
+    // Channels: "Left A" and "Right A"
+    Inlet mInputA{"A"};
+    // Channels: "Left B" and "Right B"
+    Inlet mInputB{"B"};
     Inlet mFade{"Fade"};
-    Outlet mLeftOutput{"Left Out"};
-    Outlet mRightOutput{"Right Out"};
+    // Channels: "Left Out" and "Right Out"
+    Outlet mOutput{"Out"};
 #endif
   };
 
@@ -6,11 +6,16 @@ namespace od
 
     StereoPanner::StereoPanner()
     {
-        addInput(mLeftInput);
-        addInput(mRightInput);
+        mInput.addChannel("Left In");
+        mInput.addChannel("Right In");
+        mOutput.addChannel("Left Out");
+        mOutput.addChannel("Right Out");
+        // Keep the indices of the separate ports the channels replaced.
+        addInputFromHeap(mInput.getChannel(0));
+        addInputFromHeap(mInput.getChannel(1));
         addInput(mPanInput);
-        addOutput(mLeftOutput);
-        addOutput(mRightOutput);
+        addOutput(mOutput);
+        addInput(mInput);
     }
 
     StereoPanner::~StereoPanner()
@@ -19,10 +24,10 @@ namespace od
 
     void StereoPanner::process()
     {
-        float *leftIn = mLeftInput.buffer();
-        float *rightIn = mRightInput.buffer();
-        float *leftOut = mLeftOutput.buffer();
-        float *rightOut = mRightOutput.buffer();
+        float *leftIn = mInput.buffer(0);
+        float *rightIn = mInput.buffer(1);
+        float *leftOut = mOutput.buffer(0);
+        float *rightOut = mOutput.buffer(1);
         float *pan = mPanInput.buffer();
 
         // -1 to 1 pans left to right
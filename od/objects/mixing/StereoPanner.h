@@ -15,12 +15,12 @@ namespace od
 #ifndef SWIGLUA
     virtual void process();
 
-    Inlet mLeftInput{"Left In"};
-    Inlet mRightInput{"Right In"};
+    // Channels: "Left In" and "Right In"
+    Inlet mInput{"In"};
     Inlet mPanInput{"Pan"}; // 0 is left, 1 is right, 0.5 is center
 
-    Outlet mLeftOutput{"Left Out"};
-    Outlet mRightOutput{"Right Out"};
+    // Channels: "Left Out" and "Right Out"
+    Outlet mOutput{"Out"};
 #endif
   };
 
@@ -8,8 +8,6 @@
 #include <od/objects/timing/Comparator.h>
 #include <hal/simd.h>
 
-#define LOCAL_NEON_ENABLE 1
-
 namespace od
 {
 
@@ -85,6 +83,7 @@ namespace od
 
     if (mInvertOutput)
     {
+      mOutput.clearEvents();
       float *out = mOutput.buffer();
       for (int i = 0; i < FRAMELENGTH; i++)
       {
@@ -93,6 +92,22 @@ namespace od
     }
   }
 
+  // Offset of the next sample (from i) where the input crosses the threshold
+  // that applies while it is high or low, or FRAMELENGTH.
+  static inline int nextEdge(float *in, int i, bool high,
+                             float risingThreshold, float fallingThreshold)
+  {
+    if (high)
+    {
+      return i + simd_first_less(in + i, FRAMELENGTH - i, fallingThreshold);
+    }
+    else
+    {
+      return i + simd_first_greater_or_equal(in + i, FRAMELENGTH - i,
+                                             risingThreshold);
+    }
+  }
+
   void Comparator::processTriggerOnFall()
   {
     float *in = mInput.buffer();
@@ -105,12 +120,15 @@ namespace od
     float risingThreshold = threshold + hys;
     float fallingThreshold = threshold - hys;
 
+    mOutput.beginEvents();
+    simd_set(out, FRAMELENGTH, 0.0f);
+
     if (!mSimulatedLevel)
     {
-      simd_set(out, FRAMELENGTH, 0.0f);
       if (state == 0)
       {
         out[0] = 1.0f;
+        mOutput.addEvent(0);
         state = 1;
         edgeCount++;
         levelCount++;
@@ -118,11 +136,10 @@ namespace od
     }
     else if (mInput.isConstant())
     {
-      simd_set(out, FRAMELENGTH, 0.0f);
-
       if (state == 0 && in[0] < fallingThreshold)
       {
         out[0] = 1.0f;
+        mOutput.addEvent(0);
         state = 1;
         edgeCount++;
         levelCount++;
@@ -134,35 +151,19 @@ namespace od
     }
     else
     {
-      float32x4_t rt = vdupq_n_f32(risingThreshold);
-      float32x4_t ft = vdupq_n_f32(fallingThreshold);
-      uint32_t above[4], below[4];
-
-      for (int i = 0; i < FRAMELENGTH; i += 4)
+      // State 0 is waiting for the input to fall.
+      int i = nextEdge(in, 0, state == 0, risingThreshold, fallingThreshold);
+      while (i < FRAMELENGTH)
       {
-        float32x4_t x = vld1q_f32(in + i);
-        vst1q_u32(above, vcgeq_f32(x, rt));
-        vst1q_u32(below, vcltq_f32(x, ft));
-
-        for (int j = 0; j < 4; j++)
+        if (state == 0)
         {
-          if (state == 0 && below[j])
-          {
-            out[i + j] = 1;
-            state = 1;
-            edgeCount++;
-            levelCount++;
-          }
-          else if (state == 1 && above[j])
-          {
-            state = 0;
-            out[i + j] = 0;
-          }
-          else
-          {
-            out[i + j] = 0;
-          }
+          out[i] = 1.0f;
+          mOutput.addEvent(i);
+          edgeCount++;
+          levelCount++;
         }
+        state = 1 - state;
+        i = nextEdge(in, i + 1, state == 0, risingThreshold, fallingThreshold);
       }
     }
 
@@ -200,12 +201,15 @@ namespace od
     float risingThreshold = threshold + hys;
     float fallingThreshold = threshold - hys;
 
+    mOutput.beginEvents();
+    simd_set(out, FRAMELENGTH, 0.0f);
+
     if (mSimulatedLevel)
     {
-      simd_set(out, FRAMELENGTH, 0.0f);
       if (state == 0)
       {
         out[0] = 1.0f;
+        mOutput.addEvent(0);
         state = 1;
         edgeCount++;
         levelCount++;
@@ -213,11 +217,10 @@ namespace od
     }
     else if (mInput.isConstant())
     {
-      simd_set(out, FRAMELENGTH, 0.0f);
-
       if (state == 0 && in[0] >= risingThreshold)
       {
         out[0] = 1.0f;
+        mOutput.addEvent(0);
         state = 1;
         edgeCount++;
         levelCount++;
@@ -229,62 +232,19 @@ namespace od
     }
     else
     {
-
-#if LOCAL_NEON_ENABLE
-      float32x4_t rt = vdupq_n_f32(risingThreshold);
-      float32x4_t ft = vdupq_n_f32(fallingThreshold);
-      uint32_t above[4], below[4];
-
-      for (int i = 0; i < FRAMELENGTH; i += 4)
-      {
-        float32x4_t x = vld1q_f32(in + i);
-        vst1q_u32(above, vcgeq_f32(x, rt));
-        vst1q_u32(below, vcltq_f32(x, ft));
-
-        for (int j = 0; j < 4; j++)
-        {
-          if (state == 0 && above[j])
-          {
-            out[i + j] = 1;
-            state = 1;
-            edgeCount++;
-            levelCount++;
-          }
-          else if (state == 1 && below[j])
-          {
-            state = 0;
-            out[i + j] = 0;
-          }
-          else
-          {
-            out[i + j] = 0;
-          }
-        }
-      }
-
-#else
-      for (int i = 0; i < FRAMELENGTH; i++)
+      int i = nextEdge(in, 0, state == 1, risingThreshold, fallingThreshold);
+      while (i < FRAMELENGTH)
       {
-        if (state == 0 && in[i] >= risingThreshold)
+        if (state == 0)
         {
           out[i] = 1.0f;
-          state = 1;
+          mOutput.addEvent(i);
           edgeCount++;
           levelCount++;
         }
-        else if (state == 1 && in[i] < fallingThreshold)
-        {
-          state = 0;
-          out[i] = 0.0f;
-        }
-        else
-        {
-          out[i] = 0.0f;
-        }
-        out++;
-        in++;
+        state = 1 - state;
+        i = nextEdge(in, i + 1, state == 1, risingThreshold, fallingThreshold);
       }
-#endif
     }
 
     // apply any simulated edges on the last sample of the frame
@@ -321,133 +281,36 @@ namespace od
     float fallingThreshold = threshold - hys;
     int state = mState.value();
 
-// toggle
-#if LOCAL_NEON_ENABLE
-    float32x4_t rt = vdupq_n_f32(risingThreshold);
-    float32x4_t ft = vdupq_n_f32(fallingThreshold);
-    uint32_t above[4], below[4];
-
-    for (int i = 0; i < FRAMELENGTH; i += 4)
+    // toggle: the input is high in states 1 and 3, the output in 1 and 2
+    float level = (state == 1 || state == 2) ? 1.0f : 0.0f;
+    int j = 0;
+    int i = nextEdge(in, 0, state & 1, risingThreshold, fallingThreshold);
+    while (i < FRAMELENGTH)
     {
-      float32x4_t x = vld1q_f32(in + i);
-      vst1q_u32(above, vcgeq_f32(x, rt));
-      vst1q_u32(below, vcltq_f32(x, ft));
-
-      for (int j = 0; j < 4; j++)
+      for (; j < i; j++)
       {
-        switch (state)
-        {
-        case 0:
-          if (above[j])
-          {
-            state = 1;
-            out[i + j] = 1.0f;
-            edgeCount++;
-            levelCount++;
-          }
-          else
-          {
-            out[i + j] = 0.0f;
-          }
-          break;
-        case 1:
-          if (below[j])
-          {
-            state = 2;
-            out[i + j] = 1.0f;
-            levelCount++;
-          }
-          else
-          {
-            out[i + j] = 1.0f;
-            levelCount++;
-          }
-          break;
-        case 2:
-          if (above[j])
-          {
-            state = 3;
-            out[i + j] = 0.0f;
-          }
-          else
-          {
-            out[i + j] = 1.0f;
-            levelCount++;
-          }
-          break;
-        case 3:
-          if (below[j])
-          {
-            state = 0;
-            out[i + j] = 0.0f;
-          }
-          else
-          {
-            out[i + j] = 0.0f;
-          }
-          break;
-        }
+        out[j] = level;
       }
-    }
-#else
-    for (int i = 0; i < FRAMELENGTH; i++)
-    {
-      switch (state)
+      if (level > 0.0f)
       {
-      case 0:
-        if (in[i] >= risingThreshold)
-        {
-          state = 1;
-          out[i] = 1.0f;
-          edgeCount++;
-          levelCount++;
-        }
-        else
-        {
-          out[i] = 0.0f;
-        }
-        break;
-      case 1:
-        if (in[i] < fallingThreshold)
-        {
-          state = 2;
-          out[i] = 1.0f;
-          levelCount++;
-        }
-        else
-        {
-          out[i] = 1.0f;
-          levelCount++;
-        }
-        break;
-      case 2:
-        if (in[i] >= risingThreshold)
-        {
-          state = 3;
-          out[i] = 0.0f;
-        }
-        else
-        {
-          out[i] = 1.0f;
-          levelCount++;
-        }
-        break;
-      case 3:
-        if (in[i] < fallingThreshold)
-        {
-          state = 0;
-          out[i] = 0.0f;
-        }
-        else
-        {
-          out[i] = 0.0f;
-        }
-        break;
+        levelCount += i - j;
       }
-      out++;
-      in++;
+      state = (state + 1) & 3;
+      if (state == 1)
+      {
+        edgeCount++;
+      }
+      level = (state == 1 || state == 2) ? 1.0f : 0.0f;
+      i = nextEdge(in, i + 1, state & 1, risingThreshold, fallingThreshold);
+    }
+    for (; j < FRAMELENGTH; j++)
+    {
+      out[j] = level;
+    }
+    if (level > 0.0f)
+    {
+      levelCount += FRAMELENGTH - j;
     }
-#endif
 
     // apply any simulated edges on the last sample of the frame
     if (mSimulateRisingEdge)
@@ -509,90 +372,38 @@ namespace od
         state = 1;
         edgeCount++;
       }
-      for (int i = 0; i < FRAMELENGTH; i++)
-      {
-        out[i] = 1;
-      }
+      simd_set(out, FRAMELENGTH, 1.0f);
       levelCount += globalConfig.frameLength;
     }
     else
     {
-#if LOCAL_NEON_ENABLE
-      float32x4_t rt = vdupq_n_f32(risingThreshold);
-      float32x4_t ft = vdupq_n_f32(fallingThreshold);
-      uint32_t above[4], below[4];
-
-      for (int i = 0; i < FRAMELENGTH; i += 4)
+      int j = 0;
+      int i = nextEdge(in, 0, state, risingThreshold, fallingThreshold);
+      while (i < FRAMELENGTH)
       {
-        float32x4_t x = vld1q_f32(in + i);
-        vst1q_u32(above, vcgeq_f32(x, rt));
-        vst1q_u32(below, vcltq_f32(x, ft));
-
-        for (int j = 0; j < 4; j++)
+        for (; j < i; j++)
         {
-          if (state)
-          {
-            if (below[j])
-            {
-              state = 0;
-              out[i + j] = 0;
-            }
-            else
-            {
-              out[i + j] = 1;
-              levelCount++;
-            }
-          }
-          else
-          {
-            if (above[j])
-            {
-              state = 1;
-              out[i + j] = 1;
-              edgeCount++;
-              levelCount++;
-            }
-            else
-            {
-              out[i + j] = 0;
-            }
-          }
+          out[j] = state;
         }
-      }
-#else
-      while (out < end)
-      {
         if (state)
         {
-          if (in[i] < fallingThreshold)
-          {
-            state = 0;
-            out[i] = 0.0f;
-          }
-          else
-          {
-            out[i] = 1.0f;
-            levelCount++;
-          }
+          levelCount += i - j;
         }
-        else
+        state = 1 - state;
+        if (state)
         {
-          if (in[i] >= risingThreshold)
-          {
-            state = 1;
-            out[i] = 1.0f;
-            edgeCount++;
-            levelCount++;
-          }
-          else
-          {
-            out[i] = 0.0f;
-          }
+          edgeCount++;
         }
-        out++;
-        in++;
+        i = nextEdge(in, i + 1, state, risingThreshold, fallingThreshold);
+      }
+      for (; j < FRAMELENGTH; j++)
+      {
+        out[j] = state;
+      }
+      if (state)
+      {
+        levelCount += FRAMELENGTH - j;
       }
-#endif
     }
 
     // apply any simulated edges on the last sample of the frame
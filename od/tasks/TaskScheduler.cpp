@@ -1,5 +1,7 @@
 #include <od/tasks/TaskScheduler.h>
 #include <od/tasks/Task.h>
+#include <od/extras/Tracer.h>
+#include <od/extras/DeadlineMonitor.h>
 #include <algorithm>
 
 namespace od
@@ -25,8 +27,10 @@ namespace od
   void TaskScheduler::process(float *inputs, float *outputs)
   {
     mMutex.enter();
+    DeadlineMonitor::beginFrame();
     for (Task *task : mTasks)
     {
+      Tracer::begin(TRACE_AUDIO, task->mName.c_str());
 #if TASK_TIMING_ENABLED
       task->mExecutionTimer.start();
 #endif
@@ -34,7 +38,10 @@ namespace od
 #if TASK_TIMING_ENABLED
       task->mExecutionTimer.stop();
 #endif
+      Tracer::end(TRACE_AUDIO, task->mName.c_str());
+      DeadlineMonitor::endTask(task->mName.c_str());
     }
+    DeadlineMonitor::endFrame();
     mMutex.leave();
   }
 
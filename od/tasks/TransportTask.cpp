@@ -0,0 +1,109 @@
+#include <od/tasks/TransportTask.h>
+#include <od/config.h>
+#include <hal/simd.h>
+#include <hal/ops.h>
+#include <math.h>
+
+namespace od
+{
+
+  TransportTask::TransportTask() : Task("TransportTask")
+  {
+    own(mPhase);
+    own(mBar);
+    own(mTempo);
+    own(mBeat);
+  }
+
+  TransportTask::~TransportTask()
+  {
+  }
+
+  void TransportTask::start()
+  {
+    mRunning = true;
+  }
+
+  void TransportTask::stop()
+  {
+    mRunning = false;
+  }
+
+  void TransportTask::reset()
+  {
+    mReset = true;
+  }
+
+  void TransportTask::setTempo(float bpm)
+  {
+    mBPM = CLAMP(1.0f, 1000.0f, bpm);
+  }
+
+  void TransportTask::setBeatsPerBar(int n)
+  {
+    mBeatsPerBar = CLAMP(1, 64, n);
+  }
+
+  void TransportTask::process(float *inputs, float *outputs)
+  {
+    float *phase = mPhase.buffer();
+    float *bar = mBar.buffer();
+    float *beat = mBeat.buffer();
+    float bpm = mBPM;
+    int beatsPerBar = mBeatsPerBar;
+
+    if (mReset)
+    {
+      mReset = false;
+      mPosition = 0.0;
+      mNextBeat = 0.0;
+    }
+
+    simd_set(mTempo.buffer(), FRAMELENGTH, bpm);
+    simd_set(beat, FRAMELENGTH, 0.0f);
+    mBeat.beginEvents();
+
+    // Beats per sample.
+    double step = 0.0;
+    if (mRunning)
+    {
+      step = bpm / (60.0 * globalConfig.sampleRate);
+    }
+    mFrameStart = mPosition;
+    mStep = step;
+
+    // The beats are placed from the double precision position, so that they
+    // do not drift.  Within the frame the outputs are accumulated in single
+    // precision and wrapped on the beats.
+    float p = mPosition - floor(mPosition);
+    float b = mPosition - beatsPerBar * floor(mPosition / beatsPerBar);
+    int next = FRAMELENGTH;
+    if (step > 0.0)
+    {
+      next = MAX(0, ceil((mNextBeat - mPosition) / step - 1e-6));
+    }
+
+    for (int i = 0; i < FRAMELENGTH; i++)
+    {
+      if (i == next)
+      {
+        beat[i] = 1.0f;
+        mBeat.addEvent(i);
+        p = MAX(0.0f, p - 1.0f);
+        if (fmod(mNextBeat, beatsPerBar) == 0.0)
+        {
+          b = MAX(0.0f, b - beatsPerBar);
+        }
+        mNextBeat += 1.0;
+        next = ceil((mNextBeat - mPosition) / step - 1e-6);
+      }
+      phase[i] = p;
+      bar[i] = b;
+      p += (float)step;
+      b += (float)step;
+    }
+
+    mPosition += step * FRAMELENGTH;
+  }
+
+} /* namespace od */
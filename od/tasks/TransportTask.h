@@ -0,0 +1,85 @@
+#pragma once
+
+#include <od/tasks/Task.h>
+#include <od/objects/Outlet.h>
+
+namespace od
+{
+
+  // Global tempo and song position shared by all units.
+  //
+  // Runs right after the InputTask and fills these frames for every sample:
+  //   Phase: position within the current beat, 0 to 1
+  //   Bar:   position within the current bar in beats, 0 to beats per bar
+  //   Tempo: beats per minute
+  //   Beat:  1 on the first sample of each beat, otherwise 0 (with an
+  //          event list, see Outlet::beginEvents())
+  //
+  // Clocked objects read these buffers directly (AudioThread::getTransportTask())
+  // instead of each detecting edges on a trigger input.  The outlets are also
+  // offered as external sources.
+  class TransportTask : public Task
+  {
+  public:
+    TransportTask();
+    virtual ~TransportTask();
+
+    void start();
+    void stop();
+    bool isRunning()
+    {
+      return mRunning;
+    }
+    // Go back to the first beat of the first bar (at the next frame).
+    void reset();
+
+    void setTempo(float bpm);
+    float getTempo()
+    {
+      return mBPM;
+    }
+    void setBeatsPerBar(int n);
+    int getBeatsPerBar()
+    {
+      return mBeatsPerBar;
+    }
+
+    // Beats since the last reset.
+    double getPosition()
+    {
+      return mPosition;
+    }
+    // Beats since the last reset at the first sample of the current frame,
+    // and the beats added by each sample within it.
+    double getFramePosition()
+    {
+      return mFrameStart;
+    }
+    double getBeatsPerSample()
+    {
+      return mStep;
+    }
+
+    Outlet mPhase{"Phase"};
+    Outlet mBar{"Bar"};
+    Outlet mTempo{"Tempo"};
+    Outlet mBeat{"Beat"};
+
+#ifndef SWIGLUA
+    virtual void process(float *inputs, float *outputs);
+#endif
+
+  private:
+    // Position at the start of the next frame.
+    double mPosition = 0.0;
+    // The first beat that has not been marked yet.
+    double mNextBeat = 0.0;
+    double mFrameStart = 0.0;
+    double mStep = 0.0;
+    float mBPM = 120.0f;
+    int mBeatsPerBar = 4;
+    bool mRunning = false;
+    bool mReset = false;
+  };
+
+} /* namespace od */
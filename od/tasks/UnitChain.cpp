@@ -1,5 +1,6 @@
 #include <od/tasks/UnitChain.h>
 #include <od/extras/LookupTables.h>
+#include <od/extras/Tracer.h>
 #include <hal/concurrency/Thread.h>
 #include <hal/audio.h>
 //#define BUILDOPT_VERBOSE
@@ -10,10 +11,9 @@
 namespace od
 {
 
-  UnitChain::UnitChain(const std::string &name, int channelCount) : Task(name), mChannelCount(channelCount)
+  UnitChain::UnitChain(const std::string &name, int channelCount) : Task(name), mOutput(channelCount), mChannelCount(channelCount)
   {
-    own(mLeftOutput);
-    own(mRightOutput);
+    own(mOutput);
     mFade.setLength(25);
     mFade.reset(0.0f, 1.0f);
   }
@@ -108,6 +108,12 @@ namespace od
   void UnitChain::connectInternals()
   {
     Unit *lastActiveUnit = 0;
+    std::vector<Outlet *> sources;
+    sources.push_back(mpLeftSource);
+    if (mChannelCount > 1)
+    {
+      sources.push_back(mpRightSource);
+    }
 
     // Sequentially connect units
     for (Unit *unit : mUnits)
@@ -120,23 +126,7 @@ namespace od
       else
       {
         // No last active unit, so connect the sources to this unit.
-        if (mpLeftSource)
-        {
-          std::vector<Inlet *> &inlets = unit->getInputs(0);
-          for (Inlet *inlet : inlets)
-          {
-            inlet->connect(mpLeftSource);
-          }
-        }
-
-        if (mpRightSource && mChannelCount > 1)
-        {
-          std::vector<Inlet *> &inlets = unit->getInputs(1);
-          for (Inlet *inlet : inlets)
-          {
-            inlet->connect(mpRightSource);
-          }
-        }
+        Unit::connect(sources, unit);
       }
       if (!unit->getBypass())
       {
@@ -147,33 +137,17 @@ namespace od
     // Connect the last active unit to the outputs.
     if (lastActiveUnit)
     {
-      Outlet *outlet1 = lastActiveUnit->getOutput(0);
-      if (outlet1)
-      {
-        mLeftOutput.mInlet.connect(outlet1);
-      }
-
-      if (mChannelCount > 1)
+      std::vector<Outlet *> outlets;
+      for (int i = 0; i < mChannelCount; i++)
       {
-        Outlet *outlet2 = lastActiveUnit->getOutput(1);
-        if (outlet2)
-        {
-          mRightOutput.mInlet.connect(outlet2);
-        }
+        outlets.push_back(lastActiveUnit->getOutput(i));
       }
+      mOutput.mInlet.connectChannels(outlets.data(), mChannelCount);
     }
     else
     {
       // no (active) units, so connect sources to outputs
-      if (mpLeftSource)
-      {
-        mLeftOutput.mInlet.connect(mpLeftSource);
-      }
-
-      if (mChannelCount > 1 && mpRightSource)
-      {
-        mRightOutput.mInlet.connect(mpRightSource);
-      }
+      mOutput.mInlet.connectChannels(sources.data(), mChannelCount);
     }
   }
 
@@ -185,8 +159,7 @@ namespace od
       unit->disconnect();
     }
 
-    mLeftOutput.mInlet.disconnect();
-    mRightOutput.mInlet.disconnect();
+    mOutput.mInlet.disconnect();
   }
 
   void UnitChain::process(float *inputs, float *outputs)
@@ -196,9 +169,11 @@ namespace od
     {
       if (unit->mEnabled)
       {
+        Tracer::begin(TRACE_AUDIO, unit->mName.c_str());
         unit->mExecutionTimer.start();
         unit->process();
         unit->mExecutionTimer.stop();
+        Tracer::end(TRACE_AUDIO, unit->mName.c_str());
       }
     }
     if (mMuted)
@@ -211,20 +186,12 @@ namespace od
       float w0 = mFade.mValue;
       float w1 = mFade.step();
       float a = w1 - w0;
-      mLeftOutput.fade(a, w0);
-      if (mChannelCount > 1)
-      {
-        mRightOutput.fade(a, w0);
-      }
+      mOutput.fade(a, w0);
     }
     else
     {
       // normal operation
-      mLeftOutput.copyInputToOutput();
-      if (mChannelCount > 1)
-      {
-        mRightOutput.copyInputToOutput();
-      }
+      mOutput.copyInputToOutput();
     }
 
     mMutex.leave();
@@ -276,43 +243,23 @@ namespace od
   {
     if (i < mChannelCount)
     {
-      if (i == 0)
-      {
-        return &mLeftOutput.mOutlet;
-      }
-      else if (i == 1)
-      {
-        return &mRightOutput.mOutlet;
-      }
+      return mOutput.mOutlet.getChannel(i);
     }
     return 0;
   }
 
   void UnitChain::connectOutput(int i, Inlet *inlet)
   {
-    if (i < mChannelCount)
+    Outlet *outlet = getOutput(i);
+    if (inlet && outlet)
     {
-      if (inlet)
-      {
-        if (i == 0)
-        {
-          inlet->connect(&mLeftOutput.mOutlet);
-        }
-        else if (i == 1 && mChannelCount > 1)
-        {
-          inlet->connect(&mRightOutput.mOutlet);
-        }
-      }
+      inlet->connect(outlet);
     }
   }
 
   void UnitChain::disconnectOutputs()
   {
-    mLeftOutput.mOutlet.disconnect();
-    if (mChannelCount > 1)
-    {
-      mRightOutput.mOutlet.disconnect();
-    }
+    mOutput.mOutlet.disconnect();
   }
 
   void UnitChain::mute()
@@ -325,8 +272,7 @@ namespace od
       {
         Thread::yield();
       }
-      mLeftOutput.mute();
-      mRightOutput.mute();
+      mOutput.mute();
       mMuted = true;
       logDebug(1, "Muted.");
     }
@@ -337,8 +283,7 @@ namespace od
     if (mMuted)
     {
       logDebug(1, "Unmuting...");
-      mLeftOutput.unmute();
-      mRightOutput.unmute();
+      mOutput.unmute();
       mMuted = false;
       mFade.reset(1.0f);
       logDebug(1, "Unmuted.");
@@ -54,8 +54,8 @@ namespace od
 		}
 
 	private:
-		Repeater mLeftOutput;
-		Repeater mRightOutput;
+		// One channel per chain channel, in a single block.
+		Repeater mOutput;
 		Outlet *mpLeftSource = 0;
 		Outlet *mpRightSource = 0;
 		int mChannelCount;
@@ -25,11 +25,18 @@ namespace od
     bool mCancelRequested = false;
     bool mFinished = true;
     bool mPending = false;
+    // Tracer track of the queue running this job.
+    int mTraceTrack = -1;
 
     EventFlags mEvents;
     const uint32_t onFinished = EventFlags::flag00;
 
     virtual void work() = 0;
+    // Name of this job's events in a trace.
+    virtual const char *getTraceName()
+    {
+      return "Job";
+    }
     void notifyFinished();
   };
 } // namespace od
\ No newline at end of file
@@ -1,4 +1,5 @@
 #include <od/ui/JobQueue.h>
+#include <od/extras/Tracer.h>
 #include <hal/log.h>
 //#include <algorithm>
 
@@ -7,10 +8,12 @@ namespace od
 
   JobQueue::JobQueue(const char * name) : Thread(name)
   {
+    mTraceTrack = Tracer::addTrack(name);
   }
 
   JobQueue::JobQueue(const char * name, int priority) : Thread(name, priority)
   {
+    mTraceTrack = Tracer::addTrack(name);
   }
 
   JobQueue::~JobQueue()
@@ -37,7 +40,11 @@ namespace od
           logDebug(1, "starting job");
           if (!mCurrentJob->mCancelRequested)
           {
+            mCurrentJob->mTraceTrack = mTraceTrack;
+            const char *name = mCurrentJob->getTraceName();
+            Tracer::begin(mTraceTrack, name);
             mCurrentJob->work();
+            Tracer::end(mTraceTrack, name);
             mCurrentJob->mFinished = true;
           }
           mCurrentJob->mPending = false;
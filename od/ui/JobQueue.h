@@ -24,6 +24,7 @@ namespace od
     LockFreeQueue<Job *, 128> mQueue;
     Job *mCurrentJob = 0;
     int mStatus = STATUS_NONE;
+    int mTraceTrack = -1;
 
     const uint32_t onPush = EventFlags::flag01;
     virtual void run();
@@ -158,20 +158,7 @@ namespace od
       return;
     }
 
-    int i, n;
-    n = MIN(mOutputs.size(), unit->mInputs.size());
-    for (i = 0; i < n; i++)
-    {
-      Outlet *outlet = mOutputs[i];
-      if (outlet)
-      {
-        std::vector<Inlet *> &inlets = unit->mInputs[i];
-        for (Inlet *inlet : inlets)
-        {
-          inlet->connect(outlet);
-        }
-      }
-    }
+    connect(mOutputs, unit);
   }
 
   void Unit::connect(Unit *u0, Unit *u1)
@@ -181,15 +168,50 @@ namespace od
       return;
     }
 
+    connect(u0->mOutputs, u1);
+  }
+
+  // Are the channels of a multichannel inlet the inputs i, i+1, ...?
+  static bool spansInputs(Inlet *inlet, std::vector<std::vector<Inlet *>> &inputs,
+                          int i)
+  {
+    int n = inlet->getChannelCount();
+    if (i < 0 || i + n > (int)inputs.size())
+    {
+      return false;
+    }
+    for (int j = 0; j < n; j++)
+    {
+      std::vector<Inlet *> &inlets = inputs[i + j];
+      if (std::find(inlets.begin(), inlets.end(), inlet->mChannels[j]) ==
+          inlets.end())
+      {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  void Unit::connect(const std::vector<Outlet *> &outputs, Unit *unit)
+  {
     int i, n;
-    n = MIN(u0->mOutputs.size(), u1->mInputs.size());
+    n = MIN(outputs.size(), unit->mInputs.size());
     for (i = 0; i < n; i++)
     {
-      Outlet *outlet = u0->mOutputs[i];
-      if (outlet)
+      Outlet *outlet = outputs[i];
+      std::vector<Inlet *> &inlets = unit->mInputs[i];
+      for (Inlet *inlet : inlets)
       {
-        std::vector<Inlet *> &inlets = u1->mInputs[i];
-        for (Inlet *inlet : inlets)
+        Inlet *whole = inlet->mpParent;
+        if (whole && spansInputs(whole, unit->mInputs, i - inlet->mChannel))
+        {
+          // All channels are connected together, from the first one.
+          if (inlet->mChannel == 0)
+          {
+            whole->connectChannels(&outputs[i], n - i);
+          }
+        }
+        else if (outlet)
         {
           inlet->connect(outlet);
         }
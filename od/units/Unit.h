@@ -23,6 +23,10 @@ namespace od
     void disconnect();
     void connect(Unit *unit);
     static void connect(Unit *u0, Unit *u1);
+    // Connect outputs[i] to input i of the unit.  Multichannel inlets whose
+    // channels are consecutive inputs are connected with
+    // Inlet::connectChannels(), so they can take a multichannel outlet whole.
+    static void connect(const std::vector<Outlet *> &outputs, Unit *unit);
 
     ExecutionTimer mExecutionTimer;
     bool mEnabled = true;
@@ -10,6 +10,7 @@ local PreampInterface = require "Preamp.Interface"
 local settings = require "Settings.Interface"
 local gains = PreampInterface()
 local load = require "LoadView"
+local deadlines = require "DeadlineView"
 local samples = SamplePoolInterface("Admin", "admin")
 local recorder = require "FileRecorder"
 local firmware = require "Firmware"
@@ -26,6 +27,7 @@ menu:add("Preamp Settings", gains)
 
 menu:header("Maintenance:")
 menu:add("CPU Load", load)
+menu:add("Frame Deadlines", deadlines)
 menu:add("System Settings", settings)
 menu:add("Install Firmware", firmware)
 menu:add("Package Manager", packages)
@@ -6,6 +6,7 @@ local waitForEvent = app.Events_wait
 local pullEvent = app.Events_pull
 local updateDisplay = app.UIThread.updateDisplay
 local getEncoderChange = app.Encoder_getChange
+local collectIdle = app.collectIdle
 
 local Busy = require "Busy"
 local Env = require "Env"
@@ -470,6 +471,14 @@ local function init()
   app.Adc_start();
   app.Modulation_start();
   app.Audio_start()
+
+  if app.SOAK_SECONDS then
+    -- Started from the emulator with --soak, so quit when done.
+    local Soak = require "Tests.Soak"
+    Soak.start(app.SOAK_SECONDS, nil, function()
+      app.Events_push(app.EVENT_QUIT)
+    end)
+  end
 end
 
 local activeDispatcher = defaultDispatcher
@@ -526,6 +535,8 @@ local function loop()
       elapsedTriggers[key] = nil
     end
     stopEventTimer()
+    -- spend the rest of the display frame on garbage collection
+    collectIdle()
   end
 
   Busy.kill()
@@ -398,8 +398,10 @@ function FileChooser:doPreview()
     self:stopUpdateTimer()
   else
     local path = self.browser:getSelectedFullPath()
+    local position = self.browser:getPreviewStartInSamples()
     local player = self:getPlayer()
-    if FS.isType("audio", path) and player:play(path, nil, self.previewLoop) then
+    if FS.isType("audio", path) and
+        player:play(path, position, self.previewLoop) then
       local sticky = Settings.get("samplePreviewStop") == "no"
       self.browser:setFileSource(player:getFileSource(), sticky)
       self:startUpdateTimer()
@@ -544,6 +546,15 @@ function FileChooser:onHide()
 end
 
 function FileChooser:encoder(change, shifted)
+  if self.scrubbing then
+    -- Holding the dial moves where the preview starts.
+    if self.browser:isSoundFile() then
+      self.scrubbing = "active"
+      local start = self.browser:getPreviewStart()
+      self.browser:setPreviewStart(start + change * 0.01)
+    end
+    return true
+  end
   if self.browser:encoder(change, shifted, threshold) then
     if Settings.get("samplePreviewStop") == "yes" then
       self:stopPreview()
@@ -552,6 +563,24 @@ function FileChooser:encoder(change, shifted)
   return true
 end
 
+function FileChooser:dialPressed(shifted)
+  if shifted then
+    return false
+  end
+  self.scrubbing = "waiting"
+  return true
+end
+
+function FileChooser:dialReleased(shifted)
+  local scrubbed = self.scrubbing == "active"
+  self.scrubbing = nil
+  if scrubbed then
+    self:stopPreview()
+    self:doPreview()
+  end
+  return true
+end
+
 function FileChooser:enterReleased()
   self:stopPreview()
   if self.multi then
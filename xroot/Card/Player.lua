@@ -62,9 +62,8 @@ function Player:play(path, position, loop, channel)
     self.fileSource:setLooping(false)
   end
 
-  if position ~= nil then
-    self.fileSource:setPositionInSamples(position)
-  end
+  -- Read the first chunk now so that playback starts right away.
+  self.fileSource:prefetch(position or 0)
 
   self.preemptedChannel = channel
   self.wasMuted = preemptedChain:muteIfNeeded()
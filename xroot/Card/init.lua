@@ -29,6 +29,7 @@ function EjectingState:enter(prevState, ...)
   if prevState == MountedState then
     app.logInfo("Card ejecting.")
     Signal.emit("cardEjecting")
+    app.FileIndex.close()
   end
   State.enter(self, prevState, ...)
   if claimCount == 0 then
@@ -71,6 +72,9 @@ function MountedState:enter(prevState, ...)
   app.logInfo("Card mounted. Total=%dMB Free=%dMB", totalSizeMB, freeSizeMB)
   local FS = require "Card.FileSystem"
   FS.init()
+  -- Cached listings and sound file details for the file browsers.
+  app.FileIndex.open(FS.getRoot("front-meta") .. "/files.idx")
+  app.FileIndex.scan(app.roots.front)
   Signal.emit("cardMounted", totalSizeMB, freeSizeMB)
   State.enter(self, prevState, ...)
 end
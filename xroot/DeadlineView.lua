@@ -0,0 +1,159 @@
+local app = app
+local Window = require "Base.Window"
+local Timer = require "Timer"
+
+local window = Window()
+window:setInstanceName("DeadlineView")
+
+-- Histogram rows, in percent of the frame period.
+local groups = {
+  {
+    name = "   <25%",
+    limit = 0.25
+  },
+  {
+    name = " 25-50%",
+    limit = 0.5
+  },
+  {
+    name = " 50-71%",
+    limit = 0.71
+  },
+  {
+    name = "71-100%",
+    limit = 1.0
+  },
+  {
+    name = "100-141%",
+    limit = 1.42
+  },
+  {
+    name = "  >141%",
+    limit = math.huge
+  }
+}
+
+local lines = {
+  app.GRID6_LINE1,
+  app.GRID6_LINE2,
+  app.GRID6_LINE3,
+  app.GRID6_LINE4,
+  app.GRID6_LINE5,
+  app.GRID6_LINE6
+}
+
+local function addLabel(x, y, size, graphics)
+  local label = app.Label("", size)
+  label:setJustification(app.justifyLeft)
+  label:setPosition(x, y)
+  graphics(window, label)
+  return label
+end
+
+local histogramLabels = {}
+local worstLabels = {}
+for i = 1, 6 do
+  histogramLabels[i] = addLabel(4, lines[i], 10, window.addMainGraphic)
+  worstLabels[i] = addLabel(132, lines[i], 10, window.addMainGraphic)
+end
+
+local label1 = addLabel(4, app.GRID5_LINE1, 10, window.addSubGraphic)
+local label2 = addLabel(4, app.GRID5_LINE2, 10, window.addSubGraphic)
+local label3 = addLabel(4, app.GRID5_LINE3, 10, window.addSubGraphic)
+local label4 = addLabel(4, app.GRID5_LINE4, 10, window.addSubGraphic)
+
+local function updateHistogram()
+  local counts = {}
+  local g = 1
+  for i = 0, app.DeadlineMonitor.getBucketCount() - 1 do
+    local upper = app.DeadlineMonitor.getBucketLimit(i)
+    while upper > groups[g].limit do
+      g = g + 1
+    end
+    counts[g] = (counts[g] or 0) + app.DeadlineMonitor.getBucket(i)
+  end
+  for i, group in ipairs(groups) do
+    histogramLabels[i]:setText(string.format("%s %9d", group.name,
+                                             counts[i] or 0))
+  end
+end
+
+local function updateWorst()
+  if app.DeadlineMonitor.getWorstFrameCount() == 0 then
+    worstLabels[1]:setText("worst: --")
+    for i = 2, 6 do
+      worstLabels[i]:setText("")
+    end
+    return
+  end
+
+  worstLabels[1]:setText(string.format("worst: %5.1f%%",
+                                       100 * app.DeadlineMonitor.getWorstLoad(0)))
+
+  -- Show the most expensive tasks of the worst frame.
+  local tasks = {}
+  for j = 0, app.DeadlineMonitor.getWorstTaskCount(0) - 1 do
+    tasks[#tasks + 1] = {
+      name = app.DeadlineMonitor.getWorstTaskName(0, j),
+      load = app.DeadlineMonitor.getWorstTaskLoad(0, j)
+    }
+  end
+  table.sort(tasks, function(a, b)
+    return a.load > b.load
+  end)
+  for i = 2, 6 do
+    local task = tasks[i - 1]
+    if task then
+      worstLabels[i]:setText(string.format("%-14s %5.1f%%", task.name,
+                                           100 * task.load))
+    else
+      worstLabels[i]:setText("")
+    end
+  end
+end
+
+local function onTimer()
+  label1:setText(string.format("frames:    %9d", app.DeadlineMonitor.getFrameCount()))
+  label2:setText(string.format("overruns:  %9d", app.DeadlineMonitor.getOverrunCount()))
+  label3:setText(string.format("throttled: %9d", app.DeadlineMonitor.getThrottledCount()))
+  label4:setText("sub1: reset")
+  updateHistogram()
+  updateWorst()
+  return true
+end
+
+local timer = nil
+
+function window:subReleased(i, shifted)
+  if i == 1 and not shifted then
+    app.DeadlineMonitor.reset()
+    return true
+  end
+  return false
+end
+
+function window:upReleased()
+  self:hide()
+  return true
+end
+
+function window:homeReleased()
+  self:hide()
+  return true
+end
+
+function window:cancelReleased()
+  self:hide()
+  return true
+end
+
+function window:onShow()
+  timer = Timer.every(1, onTimer)
+  onTimer()
+end
+
+function window:onHide()
+  Timer.cancel(timer)
+end
+
+return window
@@ -260,6 +260,7 @@ end
 
 function FileRecorder:saveSingleTrackTo(i, path)
   app.moveFile(self.paths[i], path, true)
+  app.FileIndex.invalidateParent(path)
   Overlay.flashMainMessage("Saved to %s", path)
   for i, path in ipairs(self.paths) do
     Card.release(path)
@@ -288,6 +289,7 @@ function FileRecorder:saveMultipleTracksTo(base, path)
       app.moveFile(self.paths[i], destPath, false)
     end
   end
+  app.FileIndex.invalidate(path)
   for i, path in ipairs(self.paths) do
     Card.release(path)
   end
@@ -60,6 +60,7 @@ local function onBackgroundTimer()
   ram:addValue(ramUsed)
   cpuLoad = app.Audio_getLoad()
   cpu:addValue(cpuLoad)
+  app.MemoryTracker.sample()
   return true
 end
 
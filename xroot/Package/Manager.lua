@@ -144,6 +144,7 @@ local function unload(package)
     loaded[package.id] = nil
     package:onUnload()
     unrequire(package:getName())
+    package:unmount()
     app.collectgarbage()
     rebootNeeded = true
   end
@@ -196,6 +197,7 @@ local function load(package)
     end
   end
 
+  package:mount()
   package:onLoad()
   loaded[package.id] = package
   return true
@@ -252,7 +254,7 @@ local function install(package)
     end
   end
 
-  local archive = app.ZipArchiveReader()
+  local archive = app.PackageArchive()
   local pathToArchive = package:getArchivePath()
   if not archive:open(pathToArchive) then
     local msg = string.format("Failed to open package archive: %s",
@@ -262,29 +264,36 @@ local function install(package)
     return false, msg
   end
 
-  -- Extract files to system library folder
-  local n = archive:getFileCount()
-  for i = 1, n do
-    local filename = archive:getFilename(i - 1)
-    local path = Path.join(installFolder, filename)
-    Path.createAll(path, true)
-    if Path.isDirectory(path:gsub("/$", "")) then
-      -- app.logInfo("Skipping folder: %s", path)
-    else
-      Busy.status("Installing %s: %s", package.id, Path.getFilename(filename))
-      -- app.logInfo("Extracting %s.", path)
-      if not archive:extract(filename, path) then
-        local msg = string.format("Failed to extract %s from %s.", filename,
-                                  package.id)
-        app.logInfo(msg)
-        archive:close()
-        Path.recursiveDelete(installFolder)
-        Busy.stop()
-        return false, msg
-      end
+  -- Lua modules are served from a copy of the archive in the system library
+  -- folder (see Package:mount), so only extract the other files.  The toc and
+  -- any presets are read by path so they are always extracted.
+  Path.createAll(installFolder)
+  Busy.status("Installing %s", package.id)
+  local ok = archive:extractAll(installFolder, "*.lua") >= 0
+  local filenames = {
+    "toc.lua"
+  }
+  for _, preset in ipairs(package:getPresets() or {}) do
+    filenames[#filenames + 1] = preset.filename
+  end
+  for _, filename in ipairs(filenames) do
+    if ok and archive:exists(filename) then
+      local path = Path.join(installFolder, filename)
+      Path.createAll(path, true)
+      ok = archive:extract(filename, path)
     end
   end
   archive:close()
+  ok = ok and
+           app.copyFile(pathToArchive, package:getInstalledArchivePath(), true)
+
+  if not ok then
+    local msg = string.format("Failed to extract %s.", package.id)
+    app.logInfo(msg)
+    Path.recursiveDelete(installFolder)
+    Busy.stop()
+    return false, msg
+  end
   package.installed = true
 
   local installed = Persist.getRearCardValue("packages", "installed") or {}
@@ -354,6 +363,7 @@ local function installUpdates()
         app.logWarn("Failed to copy %s to %s.", srcPath, dstPath)
       else
         app.logInfo("Copied %s to %s.", srcPath, dstPath)
+        app.FileIndex.invalidateParent(dstPath)
         app.deleteFile(srcPath)
         updated = updated + 1
         if wasInstalled or not wasPresent then
@@ -367,6 +377,16 @@ end
 
 local function cardMounted()
   packageCacheIsStale = true
+  -- Packages without a copy on the rear card are served from the front card.
+  for _, package in pairs(loaded) do
+    if not app.PackageArchive.isMounted(package:getName()) then
+      package:mount()
+    end
+  end
+end
+
+local function cardEjecting()
+  app.PackageArchive.closeAll()
 end
 
 local function cardEjected()
@@ -386,7 +406,11 @@ end
 local function init()
   package.cpath = string.format("%s/?.%s", FS.getRoot("libs"),
                                 FS.getExt("linkable"))
+  -- Modules of installed packages not found in the library folder are
+  -- loaded from their mounted archives.
+  table.insert(package.searchers, 3, app.packageSearcher)
   Signal.register("cardMounted", cardMounted)
+  Signal.register("cardEjecting", cardEjecting)
   Signal.register("cardEjected", cardEjected)
   packageCacheIsStale = true
   local UnitFactory = require "Unit.Factory"
@@ -109,6 +109,29 @@ function Package:getArchivePath()
   return Path.join(FS.getRoot("packages"), self.filename)
 end
 
+-- The copy of the archive kept on the rear card when installing.
+function Package:getInstalledArchivePath()
+  return Path.join(self:getInstallationPath(), self.filename)
+end
+
+-- Serve the Lua modules of this package straight from its archive.
+function Package:mount()
+  local pathToArchive = self:getInstalledArchivePath()
+  if Path.exists(pathToArchive) then
+    return app.PackageArchive.mount(self:getName(), pathToArchive)
+  end
+  -- Fall back to the archive on the front card.
+  pathToArchive = self:getArchivePath()
+  if Card.mounted() and Path.exists(pathToArchive) then
+    return app.PackageArchive.mount(self:getName(), pathToArchive)
+  end
+  return false
+end
+
+function Package:unmount()
+  app.PackageArchive.unmount(self:getName())
+end
+
 function Package:getDependencies()
   local toc = self:getTOC()
   return toc and toc.requires
@@ -180,7 +203,8 @@ function Package:getLibrary()
   end
   local pathToInstallation = self:getInstallationPath()
   local pathToInit = Path.join(pathToInstallation, "init.lua")
-  if Path.exists(pathToInit) then
+  if Path.exists(pathToInit) or
+      app.PackageArchive.hasFile(self:getName(), "init.lua") then
     local instantiate = function()
       local modname = self:getName()
       app.logInfo("Attempting to require %s...", modname)
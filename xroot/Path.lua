@@ -138,6 +138,7 @@ function Path.recursiveCopy(fromPath, toPath, excludes)
       end
     end
   end
+  app.FileIndex.invalidate(toPath)
 end
 
 function Path.recursiveDelete(path)
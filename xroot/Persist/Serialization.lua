@@ -37,11 +37,32 @@ local function legacyReadTable(filename)
   end
 end
 
+-- Returned by app.readBinaryTable for files in one of the text formats.
+local notBinary = "not a binary table"
+
 local function readTable(filename)
+  local t, e = app.readBinaryTable(filename)
+  if t ~= nil then
+    return t
+  elseif e ~= notBinary then
+    if e ~= nil and app.pathExists(filename) then
+      app.logError("Failed to read %s: %s", filename, e)
+    end
+    return nil
+  end
   return roethlin.load(filename) or legacyReadTable(filename)
 end
 
 local function writeTable(filename, t, hooks)
+  local ok, e = app.writeBinaryTable(filename, t, hooks)
+  if not ok then
+    app.logError("Failed to write %s: %s", filename, e)
+  end
+  return ok
+end
+
+-- The text format, for files that are meant to be read by people.
+local function writeTextTable(filename, t, hooks)
   if hooks then
     return roethlin.storeWithHooks(filename, hooks, t)
   else
@@ -63,5 +84,6 @@ end
 return {
   readTable = readTable,
   writeTable = writeTable,
+  writeTextTable = writeTextTable,
   get = get
 }
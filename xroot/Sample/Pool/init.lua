@@ -238,7 +238,9 @@ local function load(path)
   samples[path] = sample
   local success, status = addToLoadQueue(sample)
   if success then
-    if not sample.slices:load(sample:defaultSlicesPath()) then
+    if not sample.slices:load(sample:defaultSlicesPath()) and
+        app.FileIndex.getCueCount(path) ~= 0 then
+      -- Only open the file for its cues when the index says it has some.
       sample.slices:loadWavFileCues(path);
     end
     Signal.emit("memoryUsageChanged")
@@ -662,6 +664,13 @@ local function chooseFileFromCard(history, after, loop)
   Loader(history .. "/Samples", task, loop)
 end
 
+-- Paths of the indexed files under prefix (default is the front card) whose
+-- names match the glob pattern.
+local function find(pattern, prefix, limit)
+  return app.FileIndex.find(prefix or app.roots.front, pattern or "*.WAV",
+                            limit or 0)
+end
+
 local function hasDirtySamples()
   for _, sample in pairs(samples) do
     if sample:isDirty() then
@@ -675,6 +684,7 @@ return {
   samples = samples,
   load = load,
   chooseFileFromCard = chooseFileFromCard,
+  find = find,
   create = create,
   loadMulti = loadMulti,
   save = save,
@@ -36,6 +36,11 @@ local externals = {
     app.getExternalSource("G3"),
     app.getExternalSource("G4")
   },
+  TPx = {
+    app.getExternalSource("BEAT"),
+    app.getExternalSource("BAR"),
+    app.getExternalSource("PHASE")
+  },
   OUTx = {
     app.getExternalSource("OUT1"),
     app.getExternalSource("OUT2"),
@@ -59,6 +64,7 @@ function ExternalChooser:init(ring)
   self:addSourceGroup("Cx", externals["Cx"])
   self:addSourceGroup("Dx", externals["Dx"])
   self:addSourceGroup("Gx", externals["Gx"])
+  self:addSourceGroup("TPx", externals["TPx"])
   self:addSourceGroup("OUTx", externals["OUTx"])
 end
 
@@ -0,0 +1,13 @@
+local Tests = require "Tests"
+
+-- Compare evaluations/sec of natively compiled and Lua tie expressions.
+local function run()
+  app.Expression.benchmark()
+  Tests.printSystemState()
+end
+
+return {
+  description = "Benchmark tie expressions.",
+  batch = true,
+  run = run
+}
@@ -1,4 +1,11 @@
 local function run()
+  local stats = app.getCollectorStats()
+  app.logInfo("Idle GC: %d slices, %d cycles, %d over budget", stats.slices,
+              stats.cycles, stats.overBudget)
+  app.logInfo("Idle GC pause: avg %0.3f ms, max %0.3f ms, last %0.3f ms",
+              stats.averagePause, stats.maximumPause, stats.lastPause)
+  app.resetCollectorStats()
+
   local Busy = require "Busy"
   Busy.start()
   app.collectgarbage()
@@ -0,0 +1,55 @@
+local Tests = require "Tests"
+local Timer = require "Timer"
+local libcore = require "core.libcore"
+
+-- Compare the CPU cost of 16 ladder filter voices run as one LadderFilterBank
+-- and as 16 separate LadderFilter objects.  Each version runs in a unit of its
+-- own on a muted chain, so the profiler reports it under the unit's name.
+local voiceCount = 16
+local profileSeconds = 5
+
+local function addBank(unit)
+  unit:addObject(libcore.LadderFilterBank(voiceCount))
+end
+
+local function addSeparate(unit)
+  for i = 1, voiceCount do
+    unit:addObject(libcore.LadderFilter())
+  end
+end
+
+local function profile(name, build, after)
+  local unit = app.Unit(name, 1)
+  build(unit)
+  unit:compile()
+  local chain = app.UnitChain(name, 1)
+  chain:appendUnit(unit)
+  chain:mute()
+
+  app.logInfo("LadderBankBenchmark: profiling %s", name)
+  app.AudioThread.addTask(chain, 1)
+  app.Profiler.start()
+  Timer.after(profileSeconds, function()
+    app.Profiler.stop()
+    app.Profiler.print()
+    Tests.printSystemState()
+    app.AudioThread.removeTask(chain)
+    app.collectgarbage()
+    if after then
+      after()
+    end
+  end)
+end
+
+local function run()
+  profile("LadderFilterBank", addBank, function()
+    profile("LadderFilter", addSeparate)
+  end)
+end
+
+return {
+  description = "Benchmark a ladder filter bank vs separate ladder filters.",
+  batch = false,
+  run = run,
+  suppressReset = true
+}
@@ -0,0 +1,65 @@
+local Tests = require "Tests"
+
+-- Allocation-heavy Lua workload resembling a preset load: many small tables,
+-- strings and closures, most of which become garbage quickly.
+local rounds = 40
+local unitsPerRound = 300
+
+local function work()
+  local units = {}
+  for round = 1, rounds do
+    for i = 1, unitsPerRound do
+      local u = {
+        name = "unit" .. i .. "_" .. round,
+        params = {},
+        children = {}
+      }
+      for j = 1, 12 do
+        u.params["p" .. j] = {
+          value = j * 0.5,
+          label = string.format("%d:%d", i, j)
+        }
+      end
+      for j = 1, 8 do
+        u.children[j] = function()
+          return u.name .. j
+        end
+      end
+      local arr = {}
+      for j = 1, i % 50 do
+        arr[j] = j
+      end
+      u.arr = arr
+      units[(i % 200) + 1] = u
+    end
+  end
+end
+
+local function measure(mode)
+  local previous = collectgarbage(mode)
+  app.collectgarbage()
+  local start = app.micros()
+  work()
+  local elapsed = app.micros() - start
+  app.collectgarbage()
+  collectgarbage(previous)
+  app.logInfo("LuaAllocation: %d rounds in %0.1f ms (%s)", rounds,
+              elapsed / 1000, mode)
+  return elapsed
+end
+
+-- The app interpreter runs in incremental mode, so compare it with the
+-- generational collector on the same workload.
+local function run()
+  local incremental = measure("incremental")
+  local generational = measure("generational")
+  app.logInfo("LuaAllocation: generational/incremental = %0.2f",
+              generational / incremental)
+  Tests.printSystemState()
+end
+
+return {
+  description = "Benchmark Lua allocation.",
+  batch = true,
+  run = run
+}
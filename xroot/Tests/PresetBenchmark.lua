@@ -0,0 +1,98 @@
+local Tests = require "Tests"
+local Path = require "Path"
+local Serialization = require "Persist.Serialization"
+
+-- Compare save and load times of the binary and text preset formats using a
+-- synthetic preset shaped like a large chain.
+local unitCount = 48
+local paramCount = 20
+local repeats = 5
+
+local function makePreset()
+  local units = {}
+  for i = 1, unitCount do
+    local params = {}
+    for j = 1, paramCount do
+      params["param" .. j] = {
+        value = i * 0.125 + j,
+        target = j,
+        tied = (j % 3 == 0)
+      }
+    end
+    units[i] = {
+      loadInfo = {
+        moduleName = "Unit" .. (i % 12),
+        libraryName = "core",
+        title = "Unit " .. i
+      },
+      objects = params,
+      options = {
+        mode = i % 4,
+        sync = "off"
+      },
+      controls = {
+        gain = {
+          mode = "linear"
+        }
+      }
+    }
+  end
+  return {
+    firmwareVersion = app.FIRMWARE_VERSION,
+    chains = {
+      {
+        units = units,
+        title = "Chain 1"
+      }
+    }
+  }
+end
+
+local function fileSize(filename)
+  local f = io.open(filename, "rb")
+  if f == nil then
+    return 0
+  end
+  local size = f:seek("end")
+  f:close()
+  return size
+end
+
+local function measure(label, filename, write)
+  local data = makePreset()
+  app.collectgarbage()
+
+  local start = app.micros()
+  for _ = 1, repeats do
+    write(filename, data)
+  end
+  local saveTime = (app.micros() - start) / repeats
+  app.collectgarbage()
+
+  local kb = app.luaMemoryUsage()
+  start = app.micros()
+  for _ = 1, repeats do
+    Serialization.readTable(filename)
+  end
+  local loadTime = (app.micros() - start) / repeats
+  local allocated = app.luaMemoryUsage() - kb
+
+  app.logInfo("PresetBenchmark(%s): %d bytes, save %0.1f ms, load %0.1f ms, ~%dKB allocated",
+              label, fileSize(filename), saveTime / 1000, loadTime / 1000, allocated)
+end
+
+local function run()
+  local folder = Path.join(app.roots.front, "tmp")
+  Path.create(folder)
+  measure("text", Path.join(folder, "benchmark-text.lua"),
+          Serialization.writeTextTable)
+  measure("binary", Path.join(folder, "benchmark-binary.lua"),
+          Serialization.writeTable)
+  Tests.printSystemState()
+end
+
+return {
+  description = "Benchmark preset load/save.",
+  batch = true,
+  run = run
+}
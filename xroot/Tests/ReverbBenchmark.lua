@@ -0,0 +1,60 @@
+local Tests = require "Tests"
+local Timer = require "Timer"
+
+-- Compare the CPU cost of Freeverb and FDN Reverb by profiling a stereo
+-- chain that holds several instances of one of them at a time.
+local instanceCount = 4
+local profileSeconds = 5
+
+local function findLoadInfo(moduleName)
+  local UnitFactory = require "Unit.Factory"
+  for _, loadInfo in ipairs(UnitFactory.getUnitsByLibrary("core")) do
+    if loadInfo.moduleName == moduleName then
+      return loadInfo
+    end
+  end
+end
+
+local function profile(chain, moduleName, after)
+  local loadInfo = findLoadInfo(moduleName)
+  if loadInfo == nil then
+    app.logError("ReverbBenchmark: %s not found.", moduleName)
+    return
+  end
+
+  local units = {}
+  for i = 1, instanceCount do
+    units[i] = chain:loadUnit(loadInfo)
+  end
+
+  app.logInfo("ReverbBenchmark: profiling %d x %s", instanceCount, moduleName)
+  app.Profiler.start()
+  Timer.after(profileSeconds, function()
+    app.Profiler.stop()
+    app.Profiler.print()
+    Tests.printSystemState()
+    for _, unit in ipairs(units) do
+      chain:removeUnit(unit)
+    end
+    app.collectgarbage()
+    if after then
+      after()
+    end
+  end)
+end
+
+local function run()
+  local Channels = require "Channels"
+  Channels.link(1)
+  local chain = Channels.getChain(1)
+  profile(chain, "FreeverbUnit", function()
+    profile(chain, "FDNReverbUnit")
+  end)
+end
+
+return {
+  description = "Benchmark Freeverb vs FDN Reverb.",
+  batch = false,
+  run = run,
+  suppressReset = true
+}
@@ -0,0 +1,13 @@
+local Tests = require "Tests"
+
+-- Log the max error (vs libm) and ticks per call of each SIMD transcendental.
+local function run()
+  app.SimdBenchmark.run()
+  Tests.printSystemState()
+end
+
+return {
+  description = "Benchmark SIMD transcendentals.",
+  batch = true,
+  run = run
+}
@@ -0,0 +1,329 @@
+local app = app
+local Timer = require "Timer"
+local Tests = require "Tests"
+
+-- Soak test for the audio engine.  While the audio thread renders, the UI
+-- thread loads and removes units, connects and disconnects probes through
+-- the ConnectionQueue and changes parameters, and the SampleLoader job
+-- thread loads and unloads samples.  Operations are picked by a seeded PRNG
+-- so that a failing run can be replayed with the same seed.
+--
+-- Run it from the test console, or headless from the emulator with:
+--   emu.elf --soak SECS
+local defaultSeconds = 60
+local defaultSeed = 0x2545F491
+local batchPeriod = 0.02
+local opsPerBatch = 4
+local maximumUnits = 8
+local maximumProbes = 8
+local sampleCount = 4
+local sampleSeconds = 2
+
+local state = defaultSeed
+local function random(n)
+  -- xorshift32
+  state = state ~ (state << 13) & 0xFFFFFFFF
+  state = state ~ (state >> 17)
+  state = state ~ (state << 5) & 0xFFFFFFFF
+  return state % n + 1
+end
+
+local function sortedKeys(t)
+  local keys = {}
+  for key in pairs(t) do
+    keys[#keys + 1] = key
+  end
+  table.sort(keys)
+  return keys
+end
+
+local chain
+local unitInfos
+local units = {}
+local probes = {}
+local samplePaths = {}
+local samples = {}
+local stats = {}
+
+local function writeTestSample(path, seconds)
+  local rate = app.globalConfig.sampleRate
+  local n = math.floor(rate * seconds)
+  local f = io.open(path, "wb")
+  if f == nil then
+    return false
+  end
+  f:write("RIFF", string.pack("<I4", 36 + 2 * n), "WAVE")
+  f:write("fmt ", string.pack("<I4I2I2I4I4I2I2", 16, 1, 1, rate, 2 * rate, 2, 16))
+  f:write("data", string.pack("<I4", 2 * n))
+  local block = {}
+  for i = 1, 1024 do
+    block[i] = string.pack("<i2", random(65535) - 32768)
+  end
+  block = table.concat(block)
+  local remaining = n
+  while remaining > 0 do
+    local count = math.min(remaining, 1024)
+    f:write(block:sub(1, 2 * count))
+    remaining = remaining - count
+  end
+  f:close()
+  return true
+end
+
+local function getOutlets()
+  local outlets = {
+    chain:getOutput(1)
+  }
+  for _, unit in ipairs(units) do
+    local objects = unit.objects
+    for _, key in ipairs(sortedKeys(objects)) do
+      local o = objects[key]
+      for i = 0, o:getOutputCount() - 1 do
+        outlets[#outlets + 1] = o:getOutput(i)
+      end
+    end
+  end
+  return outlets
+end
+
+local function loadUnit()
+  if #units == maximumUnits or #unitInfos == 0 then
+    return false
+  end
+  local loadInfo = unitInfos[random(#unitInfos)]
+  local position = random(#units + 1)
+  local unit = chain:loadUnit(loadInfo, position, true)
+  if unit then
+    table.insert(units, position, unit)
+  end
+  return true
+end
+
+local function removeUnit()
+  if #units == 0 then
+    return false
+  end
+  local unit = table.remove(units, random(#units))
+  chain:removeUnit(unit, true)
+  return true
+end
+
+local function toggleProbe()
+  local probe = probes[random(#probes)]
+  if probe.outlet then
+    app.AudioThread.disconnect(probe.object:getInput("In"), probe.object)
+    probe.outlet = nil
+  else
+    local outlets = getOutlets()
+    probe.outlet = outlets[random(#outlets)]
+    app.AudioThread.connect(probe.outlet, probe.object:getInput("In"),
+                            probe.object)
+  end
+  return true
+end
+
+local function changeParameter()
+  if #units == 0 then
+    return false
+  end
+  local objects = units[random(#units)].objects
+  local keys = sortedKeys(objects)
+  if #keys == 0 then
+    return false
+  end
+  local o = objects[keys[random(#keys)]]
+  local n = o:getParameterCount()
+  if n == 0 then
+    return false
+  end
+  local parameter = o:getParameter(random(n) - 1)
+  local value = (random(2001) - 1001) / 1000
+  if random(2) == 1 then
+    parameter:hardSet(value)
+  else
+    parameter:softSet(value)
+  end
+  return true
+end
+
+local function toggleSample()
+  if #samplePaths == 0 then
+    return false
+  end
+  local Pool = require "Sample.Pool"
+  local i = random(#samplePaths)
+  local sample = samples[i]
+  if sample then
+    Pool.cancel(sample)
+    Pool.unload(sample, true)
+    samples[i] = nil
+  else
+    samples[i] = Pool.load(samplePaths[i]) or nil
+  end
+  return true
+end
+
+local operations = {
+  {
+    name = "loadUnit",
+    f = loadUnit
+  },
+  {
+    name = "removeUnit",
+    f = removeUnit
+  },
+  {
+    name = "toggleProbe",
+    f = toggleProbe
+  },
+  {
+    name = "changeParameter",
+    f = changeParameter
+  },
+  {
+    name = "changeParameter",
+    f = changeParameter
+  },
+  {
+    name = "toggleSample",
+    f = toggleSample
+  }
+}
+
+local function runOperation()
+  local op = operations[random(#operations)]
+  local start = app.micros()
+  local done = op.f()
+  local elapsed = app.micros() - start
+  if done then
+    local s = stats[op.name]
+    s.count = s.count + 1
+    s.maxMicros = math.max(s.maxMicros, elapsed)
+  end
+end
+
+local function cleanup()
+  for _, probe in ipairs(probes) do
+    if probe.outlet then
+      app.AudioThread.disconnect(probe.object:getInput("In"), probe.object)
+      probe.outlet = nil
+    end
+  end
+  while #units > 0 do
+    chain:removeUnit(table.remove(units), true)
+  end
+  local Pool = require "Sample.Pool"
+  for i = 1, sampleCount do
+    if samples[i] then
+      Pool.cancel(samples[i])
+      Pool.unload(samples[i], true)
+      samples[i] = nil
+    end
+  end
+  probes = {}
+  app.collectgarbage()
+end
+
+local function report(seconds, seed, liveBefore)
+  local frames = app.DeadlineMonitor.getFrameCount()
+  local framesPerSecond = frames / seconds
+  local realtime = framesPerSecond * app.globalConfig.frameLength /
+                       app.globalConfig.sampleRate
+  app.logInfo("Soak: seed=0x%08x, %d secs", seed, seconds)
+  for _, key in ipairs(sortedKeys(stats)) do
+    local s = stats[key]
+    app.logInfo("Soak: %-16s %6d ops, max %8.3f ms", key, s.count,
+                s.maxMicros / 1000)
+  end
+  app.logInfo("Soak: %d frames (%.1f fps, %.2fx real-time)", frames,
+              framesPerSecond, realtime)
+  app.logInfo("Soak: worst frame %.1f%%, %d overruns, %d throttled",
+              100 * app.DeadlineMonitor.getWorstLoad(0),
+              app.DeadlineMonitor.getOverrunCount(),
+              app.DeadlineMonitor.getThrottledCount())
+
+  -- Give the audio thread a moment to process the disconnections.
+  Timer.after(0.5, function()
+    app.collectgarbage()
+    local liveAfter = app.ReferenceCounted.getLiveCount()
+    if liveAfter > liveBefore then
+      app.logError("Soak: LEAK %d objects (%d before, %d after)",
+                   liveAfter - liveBefore, liveBefore, liveAfter)
+    else
+      app.logInfo("Soak: no leaks (%d objects before, %d after)", liveBefore,
+                  liveAfter)
+    end
+    Tests.printSystemState()
+  end)
+end
+
+local function start(seconds, seed, after)
+  seconds = seconds or defaultSeconds
+  seed = seed or defaultSeed
+  state = seed
+
+  local Channels = require "Channels"
+  local UnitFactory = require "Unit.Factory"
+  chain = Channels.getChain(1)
+  unitInfos = UnitFactory.getUnitsByLibrary("core")
+  units = {}
+  samples = {}
+  samplePaths = {}
+  stats = {}
+  for _, op in ipairs(operations) do
+    stats[op.name] = {
+      count = 0,
+      maxMicros = 0
+    }
+  end
+
+  local Path = require "Path"
+  local folder = Path.join(app.roots.front, "soak")
+  if Path.create(folder) then
+    for i = 1, sampleCount do
+      local path = Path.join(folder, string.format("soak%d.wav", i))
+      if app.pathExists(path) or writeTestSample(path, sampleSeconds) then
+        samplePaths[#samplePaths + 1] = path
+      end
+    end
+  end
+
+  app.collectgarbage()
+  local liveBefore = app.ReferenceCounted.getLiveCount()
+
+  probes = {}
+  for i = 1, maximumProbes do
+    local o = app.Stress()
+    o:hardSet("Load", 0)
+    probes[i] = {
+      object = o
+    }
+  end
+
+  app.logInfo("Soak: running for %d secs (seed=0x%08x)", seconds, seed)
+  app.DeadlineMonitor.reset()
+  local t0 = app.wallclock()
+  Timer.every(batchPeriod, function()
+    for _ = 1, opsPerBatch do
+      runOperation()
+    end
+    if app.wallclock() - t0 >= seconds then
+      cleanup()
+      report(app.wallclock() - t0, seed, liveBefore)
+      if after then
+        Timer.after(1, after)
+      end
+      return false
+    end
+    return true
+  end)
+end
+
+return {
+  description = "Soak the audio engine (60 secs).",
+  batch = false,
+  run = function()
+    start()
+  end,
+  start = start
+}
@@ -0,0 +1,21 @@
+local Timer = require "Timer"
+
+-- Record a few seconds of audio and UI activity and save it in the Chrome
+-- trace format.  Open the file with chrome://tracing or ui.perfetto.dev.
+local traceSeconds = 5
+
+local function run()
+  local filename = app.roots.front .. "/trace.json"
+  app.logInfo("Trace: recording for %d seconds.", traceSeconds)
+  app.Tracer.start()
+  Timer.after(traceSeconds, function()
+    app.Tracer.save(filename)
+  end)
+end
+
+return {
+  description = "Record a trace to the front card.",
+  batch = false,
+  run = run,
+  suppressReset = true
+}
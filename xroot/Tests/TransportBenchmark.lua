@@ -0,0 +1,75 @@
+local Tests = require "Tests"
+local Timer = require "Timer"
+local libcore = require "core.libcore"
+
+-- Compare the CPU cost of keeping 16 clocks in time by patching triggers
+-- (the first clock runs free and each of the others is synced to the one
+-- before it) and by following the transport.
+local instanceCount = 16
+local profileSeconds = 5
+
+local function findLoadInfo(moduleName)
+  local UnitFactory = require "Unit.Factory"
+  for _, loadInfo in ipairs(UnitFactory.getUnitsByLibrary("core")) do
+    if loadInfo.moduleName == moduleName then
+      return loadInfo
+    end
+  end
+end
+
+local function profile(chain, transport, after)
+  local loadInfo = findLoadInfo("Timing.ClockInBPM")
+  if loadInfo == nil then
+    app.logError("TransportBenchmark: Timing.ClockInBPM not found.")
+    return
+  end
+
+  local units = {}
+  for i = 1, instanceCount do
+    local unit = chain:loadUnit(loadInfo)
+    unit.objects.clock:getOption("Transport"):set(transport)
+    units[i] = unit
+  end
+
+  if transport == libcore.CLOCK_TRANSPORT_OFF then
+    -- Patch the clocks directly, so that each Sync input sees the edges of
+    -- the clock before it rather than whatever the chain feeds the unit.
+    app.disconnect(units[1].objects.clock:getInput("Sync"))
+    for i = 2, instanceCount do
+      connect(units[i - 1].objects.clock, "Out", units[i].objects.clock, "Sync")
+    end
+    app.logInfo("TransportBenchmark: profiling %d clocks synced by triggers",
+                instanceCount)
+  else
+    app.logInfo("TransportBenchmark: profiling %d clocks following the transport",
+                instanceCount)
+  end
+  app.Profiler.start()
+  Timer.after(profileSeconds, function()
+    app.Profiler.stop()
+    app.Profiler.print()
+    Tests.printSystemState()
+    for _, unit in ipairs(units) do
+      chain:removeUnit(unit)
+    end
+    app.collectgarbage()
+    if after then
+      after()
+    end
+  end)
+end
+
+local function run()
+  local Channels = require "Channels"
+  local chain = Channels.getChain(1)
+  profile(chain, libcore.CLOCK_TRANSPORT_OFF, function()
+    profile(chain, libcore.CLOCK_TRANSPORT_FOLLOW)
+  end)
+end
+
+return {
+  description = "Benchmark trigger-synced vs transport-synced clocks.",
+  batch = false,
+  run = run,
+  suppressReset = true
+}
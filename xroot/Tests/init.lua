@@ -21,6 +21,15 @@ local function init()
   addTest("LoadAllUnits")
   addTest("LoadCoreUnits")
   addTest("RestartAudio")
+  addTest("ReverbBenchmark")
+  addTest("TransportBenchmark")
+  addTest("LadderBankBenchmark")
+  addTest("SimdBenchmark")
+  addTest("ExpressionBenchmark")
+  addTest("LuaAllocation")
+  addTest("PresetBenchmark")
+  addTest("Trace")
+  addTest("Soak")
 end
 
 local function reset()
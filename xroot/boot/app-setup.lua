@@ -101,6 +101,12 @@ do
   externalSources["OUT3"] = Source("OUT3", outputTask.mMonitor3)
   externalSources["OUT4"] = Source("OUT4", outputTask.mMonitor4)
 
+  local transport = app.AudioThread.getTransportTask()
+  externalSources["BEAT"] = Source("BEAT", transport.mBeat, true)
+  externalSources["BAR"] = Source("BAR", transport.mBar, true)
+  externalSources["PHASE"] = Source("PHASE", transport.mPhase, true)
+  transport:start()
+
   externalDestinations["OUT1"] = outputTask.mOut1
   externalDestinations["OUT2"] = outputTask.mOut2
   externalDestinations["OUT3"] = outputTask.mOut3